@@ -0,0 +1,611 @@
+/**
+ * fullframe-cli - Headless access to a folder's tag database
+ *
+ * For ingest scripts on machines without a display, and as a harness for
+ * timing the core (scanner, TagManager, ThumbnailCreator) without any
+ * rendering. Links no widgets.
+ *
+ * Every command works on <folder>/fullframe.db, the same database the app
+ * opens for that folder (or --db). Bulk edits go through TagManager's
+ * set-based methods, so a 100k-line CSV is a few statements rather than
+ * 100k transactions. Output is plain text, or JSON with --json; --trace
+ * writes a Chrome trace of the run and --memory reports what the core
+ * holds once the command is done.
+ */
+
+#include <QAtomicInt>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+
+#include "eventtrace.h"
+#include "mediascanner.h"
+#include "memoryreport.h"
+#include "tagmanager.h"
+#include "thumbnailcreator.h"
+
+using namespace FullFrame;
+
+namespace {
+
+enum ExitCode {
+    ExitOk = 0,
+    ExitFailed = 1,
+    ExitUsage = 2
+};
+
+QTextStream& out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream& err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+struct Context
+{
+    QString folder;
+    bool json = false;
+    bool recursive = false;
+    int size = 256;
+    QString csvPath;
+    bool any = false;
+    int minRating = 0;
+    QStringList args;   // Positional arguments after the command
+};
+
+// With --json, a command leaves its result here and main() prints it once,
+// so anything added after the command (--memory) stays in one document
+QJsonObject& jsonResult()
+{
+    static QJsonObject result;
+    return result;
+}
+
+void printJson(const QJsonObject& object)
+{
+    out() << QJsonDocument(object).toJson(QJsonDocument::Indented);
+    out().flush();
+}
+
+// Paths are stored the way the app's scanner produces them: absolute, clean
+QString resolvePath(const Context& ctx, const QString& path)
+{
+    return QDir::cleanPath(QDir(ctx.folder).absoluteFilePath(path));
+}
+
+// Splits one CSV line; fields may be "quoted", with "" for a literal quote
+QStringList splitCsvLine(const QString& line)
+{
+    QStringList fields;
+    QString field;
+    bool quoted = false;
+    for (int i = 0; i < line.size(); ++i) {
+        const QChar c = line.at(i);
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line.at(i + 1) == '"') {
+                field += '"';
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields << field.trimmed();
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    fields << field.trimmed();
+    return fields;
+}
+
+// Rows of a CSV file, skipping blank lines and # comments
+bool readCsv(const QString& path, QVector<QStringList>* rows)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        err() << "Cannot read " << path << ": " << file.errorString() << Qt::endl;
+        return false;
+    }
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        const QString line = in.readLine();
+        const QString trimmed = line.trimmed();
+        if (trimmed.isEmpty() || trimmed.startsWith('#')) {
+            continue;
+        }
+        rows->append(splitCsvLine(line));
+    }
+    return true;
+}
+
+// (path, tag name) pairs from either --csv (path,tag[,tag...]) or
+// "<tag> <files...>"
+bool collectTagAssignments(const Context& ctx, QVector<QPair<QString, QString>>* pairs)
+{
+    if (!ctx.csvPath.isEmpty()) {
+        QVector<QStringList> rows;
+        if (!readCsv(ctx.csvPath, &rows)) {
+            return false;
+        }
+        for (const QStringList& row : rows) {
+            const QString path = resolvePath(ctx, row.first());
+            for (int i = 1; i < row.size(); ++i) {
+                if (!row.at(i).isEmpty()) {
+                    pairs->append({ path, row.at(i) });
+                }
+            }
+        }
+        return true;
+    }
+
+    if (ctx.args.size() < 2) {
+        err() << "Expected <tag> <files...> or --csv <file>" << Qt::endl;
+        return false;
+    }
+    const QString tagName = ctx.args.first();
+    for (int i = 1; i < ctx.args.size(); ++i) {
+        pairs->append({ resolvePath(ctx, ctx.args.at(i)), tagName });
+    }
+    return true;
+}
+
+// ============== Commands ==============
+
+int runScan(const Context& ctx)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QFileInfoList files = MediaScanner::scan(ctx.folder, ctx.recursive);
+    const qint64 scanMs = timer.elapsed();
+
+    QStringList paths;
+    paths.reserve(files.size());
+    for (const QFileInfo& info : files) {
+        paths << QDir::cleanPath(info.absoluteFilePath());
+    }
+    const int added = TagManager::instance()->registerImages(paths);
+    if (added < 0) {
+        return ExitFailed;
+    }
+    const qint64 totalMs = timer.elapsed();
+
+    if (ctx.json) {
+        QJsonObject result;
+        result["folder"] = ctx.folder;
+        result["found"] = int(paths.size());
+        result["added"] = added;
+        result["scanMs"] = scanMs;
+        result["dbMs"] = totalMs - scanMs;
+        jsonResult() = result;
+    } else {
+        out() << "Found " << paths.size() << " media files, " << added << " new ("
+              << scanMs << " ms scan, " << (totalMs - scanMs) << " ms database)" << Qt::endl;
+    }
+    return ExitOk;
+}
+
+int runTag(const Context& ctx, bool add)
+{
+    QVector<QPair<QString, QString>> pairs;
+    if (!collectTagAssignments(ctx, &pairs)) {
+        return ExitUsage;
+    }
+
+    TagManager* tags = TagManager::instance();
+    QHash<QString, qint64> tagIds;
+    QStringList unknownTags;
+    QVector<QPair<QString, qint64>> assignments;
+    assignments.reserve(pairs.size());
+    for (const auto& pair : pairs) {
+        auto it = tagIds.find(pair.second);
+        if (it == tagIds.end()) {
+            qint64 id = tags->tagByName(pair.second).id;
+            if (id < 0 && add) {
+                id = tags->createTag(pair.second);
+            }
+            if (id < 0) {
+                unknownTags << pair.second;
+            }
+            it = tagIds.insert(pair.second, id);
+        }
+        if (it.value() >= 0) {
+            assignments.append({ pair.first, it.value() });
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const int changed = add ? tags->addImageTags(assignments) : tags->removeImageTags(assignments);
+    if (changed < 0) {
+        return ExitFailed;
+    }
+
+    if (ctx.json) {
+        QJsonObject result;
+        result["requested"] = int(pairs.size());
+        result[add ? "added" : "removed"] = changed;
+        result["unknownTags"] = QJsonArray::fromStringList(unknownTags);
+        result["dbMs"] = timer.elapsed();
+        jsonResult() = result;
+    } else {
+        out() << (add ? "Tagged " : "Untagged ") << changed << " of " << pairs.size()
+              << " (" << timer.elapsed() << " ms)" << Qt::endl;
+        for (const QString& name : unknownTags) {
+            err() << "Unknown tag: " << name << Qt::endl;
+        }
+    }
+    return ExitOk;
+}
+
+int runQuery(const Context& ctx)
+{
+    TagManager* tags = TagManager::instance();
+
+    QSet<qint64> tagIds;
+    for (const QString& name : ctx.args) {
+        const Tag tag = tags->tagByName(name);
+        if (!tag.isValid()) {
+            err() << "Unknown tag: " << name << Qt::endl;
+            return ExitFailed;
+        }
+        tagIds.insert(tag.id);
+    }
+    if (tagIds.isEmpty() && ctx.minRating <= 0) {
+        err() << "Expected one or more tags and/or --min-rating" << Qt::endl;
+        return ExitUsage;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const QHash<QString, int> ratings = tags->allRatings();
+    QStringList paths;
+    if (tagIds.isEmpty()) {
+        paths = ratings.keys();
+    } else {
+        paths = ctx.any ? tags->imagesWithAnyTag(tagIds) : tags->imagesWithAllTags(tagIds);
+    }
+    if (ctx.minRating > 0) {
+        paths.erase(std::remove_if(paths.begin(), paths.end(), [&](const QString& path) {
+                        return ratings.value(path) < ctx.minRating;
+                    }),
+                    paths.end());
+    }
+    std::sort(paths.begin(), paths.end());
+    const qint64 queryMs = timer.elapsed();
+
+    if (!ctx.json) {
+        for (const QString& path : paths) {
+            out() << path << '\n';
+        }
+        out().flush();
+        return ExitOk;
+    }
+
+    // Tags for every result from one join over the result paths
+    QHash<qint64, QString> tagNames;
+    for (const Tag& tag : tags->allTags()) {
+        tagNames.insert(tag.id, tag.name);
+    }
+    QHash<QString, QStringList> pathTags;
+    for (const auto& association : tags->imageTagsFor(paths)) {
+        pathTags[association.first] << tagNames.value(association.second);
+    }
+
+    QJsonArray images;
+    for (const QString& path : paths) {
+        QStringList names = pathTags.value(path);
+        names.sort(Qt::CaseInsensitive);
+        QJsonObject image;
+        image["path"] = path;
+        image["tags"] = QJsonArray::fromStringList(names);
+        image["rating"] = ratings.value(path);
+        images.append(image);
+    }
+    QJsonObject result;
+    result["count"] = int(paths.size());
+    result["queryMs"] = queryMs;
+    result["images"] = images;
+    jsonResult() = result;
+    return ExitOk;
+}
+
+int runRate(const Context& ctx)
+{
+    QHash<QString, int> ratings;
+    if (!ctx.csvPath.isEmpty()) {
+        QVector<QStringList> rows;
+        if (!readCsv(ctx.csvPath, &rows)) {
+            return ExitUsage;
+        }
+        for (const QStringList& row : rows) {
+            bool ok = false;
+            const int rating = row.value(1).toInt(&ok);
+            if (!ok || rating < 0 || rating > 5) {
+                err() << "Skipping line with bad rating: " << row.join(',') << Qt::endl;
+                continue;
+            }
+            ratings.insert(resolvePath(ctx, row.first()), rating);
+        }
+    } else {
+        bool ok = false;
+        const int rating = ctx.args.value(0).toInt(&ok);
+        if (!ok || rating < 0 || rating > 5 || ctx.args.size() < 2) {
+            err() << "Expected <0-5> <files...> or --csv <file>" << Qt::endl;
+            return ExitUsage;
+        }
+        for (int i = 1; i < ctx.args.size(); ++i) {
+            ratings.insert(resolvePath(ctx, ctx.args.at(i)), rating);
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const int changed = TagManager::instance()->setRatings(ratings);
+    if (changed < 0) {
+        return ExitFailed;
+    }
+
+    if (ctx.json) {
+        QJsonObject result;
+        result["requested"] = int(ratings.size());
+        result["changed"] = changed;
+        result["dbMs"] = timer.elapsed();
+        jsonResult() = result;
+    } else {
+        out() << "Rated " << ratings.size() << " files (" << timer.elapsed() << " ms)" << Qt::endl;
+    }
+    return ExitOk;
+}
+
+int runThumbs(const Context& ctx)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QFileInfoList files = MediaScanner::scan(ctx.folder, ctx.recursive);
+
+    // Same disk cache the app reads; already-cached files are only counted
+    QAtomicInt created;
+    QAtomicInt cached;
+    QAtomicInt failed;
+    QThreadPool pool;
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+    for (const QFileInfo& info : files) {
+        const QString path = info.absoluteFilePath();
+        pool.start([&, path]() {
+            ThumbnailCreator creator(ctx.size);
+            if (!creator.loadFromDiskCache(path).isNull()) {
+                cached.fetchAndAddRelaxed(1);
+            } else if (!creator.create(path).isNull()) {
+                created.fetchAndAddRelaxed(1);
+            } else {
+                failed.fetchAndAddRelaxed(1);
+            }
+        });
+    }
+    pool.waitForDone();
+
+    const qint64 ms = timer.elapsed();
+    const double perSecond = ms > 0 ? created.loadRelaxed() * 1000.0 / ms : 0.0;
+    if (ctx.json) {
+        QJsonObject result;
+        result["files"] = int(files.size());
+        result["created"] = created.loadRelaxed();
+        result["cached"] = cached.loadRelaxed();
+        result["failed"] = failed.loadRelaxed();
+        result["size"] = ctx.size;
+        result["threads"] = pool.maxThreadCount();
+        result["ms"] = ms;
+        result["createdPerSecond"] = perSecond;
+        jsonResult() = result;
+    } else {
+        out() << files.size() << " files: " << created.loadRelaxed() << " created, "
+              << cached.loadRelaxed() << " already cached, " << failed.loadRelaxed() << " failed ("
+              << ms << " ms, " << QString::number(perSecond, 'f', 1) << "/s)" << Qt::endl;
+    }
+    return failed.loadRelaxed() > 0 ? ExitFailed : ExitOk;
+}
+
+int runStats(const Context& ctx)
+{
+    TagManager* tags = TagManager::instance();
+    const TagDatabaseStats stats = tags->databaseStats();
+    const QHash<qint64, int> counts = tags->tagImageCounts();
+
+    QList<Tag> allTags = tags->allTags();
+    std::sort(allTags.begin(), allTags.end(), [&](const Tag& a, const Tag& b) {
+        return counts.value(a.id) > counts.value(b.id);
+    });
+
+    if (ctx.json) {
+        QJsonArray tagList;
+        for (const Tag& tag : allTags) {
+            QJsonObject entry;
+            entry["name"] = tag.name;
+            entry["images"] = counts.value(tag.id);
+            if (tag.hasHotkey()) {
+                entry["hotkey"] = tag.hotkey;
+            }
+            if (tag.isAlbumTag()) {
+                entry["album"] = tag.albumPath;
+            }
+            tagList.append(entry);
+        }
+        QJsonObject result;
+        result["database"] = tags->databasePath();
+        result["images"] = stats.images;
+        result["tags"] = stats.tags;
+        result["imageTags"] = stats.imageTags;
+        result["ratings"] = stats.ratings;
+        result["sequences"] = stats.sequences;
+        result["tagCounts"] = tagList;
+        jsonResult() = result;
+        return ExitOk;
+    }
+
+    out() << tags->databasePath() << '\n'
+          << "images:     " << stats.images << '\n'
+          << "tags:       " << stats.tags << '\n'
+          << "image tags: " << stats.imageTags << '\n'
+          << "ratings:    " << stats.ratings << '\n'
+          << "sequences:  " << stats.sequences << '\n';
+    for (const Tag& tag : allTags) {
+        out() << QString("  %1 %2").arg(counts.value(tag.id), 8).arg(tag.name) << '\n';
+    }
+    out().flush();
+    return ExitOk;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // ThumbnailCreator paints placeholders and may pull video frames, both
+    // of which need a QGuiApplication; with no display, render offscreen
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+
+    // Same names as the app, so the thumbnail disk cache is shared
+    app.setApplicationName("FullFrame");
+    app.setApplicationVersion("1.2.0");
+    app.setOrganizationName("FullFrame");
+    app.setOrganizationDomain("fullframe.app");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Headless FullFrame: scan folders, edit tags and ratings, query, build thumbnails.\n"
+        "\n"
+        "Commands:\n"
+        "  scan [folder]              Add the folder's media files to its database\n"
+        "  tag <tag> <files...>       Tag files (missing tags are created); or --csv\n"
+        "  untag <tag> <files...>     Remove a tag from files; or --csv\n"
+        "  query <tags...>            Files with all the tags (--any: any of them)\n"
+        "  rate <0-5> <files...>      Set ratings (0 clears); or --csv path,rating\n"
+        "  thumbs [folder]            Fill the thumbnail disk cache\n"
+        "  stats                      Database and per-tag counts\n"
+        "\n"
+        "Tag CSV lines are path,tag[,tag...]; relative paths are taken from the folder.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("command", "scan, tag, untag, query, rate, thumbs or stats");
+
+    const QCommandLineOption folderOption({ "f", "folder" },
+        "Media folder; its fullframe.db is used (default: current directory).", "folder");
+    const QCommandLineOption dbOption("db", "Use this database instead of <folder>/fullframe.db.", "path");
+    const QCommandLineOption jsonOption("json", "Print results as JSON.");
+    const QCommandLineOption recursiveOption({ "r", "recursive" }, "Include subfolders (scan, thumbs).");
+    const QCommandLineOption csvOption("csv", "Read assignments from a CSV file (tag, untag, rate).", "file");
+    const QCommandLineOption anyOption("any", "Match files with any of the tags (query).");
+    const QCommandLineOption minRatingOption("min-rating", "Only files rated at least this (query).", "stars");
+    const QCommandLineOption sizeOption("size", "Thumbnail size in pixels (thumbs, default 256).", "pixels", "256");
+    const QCommandLineOption traceOption("trace", "Write a Chrome trace of the run to this file.", "file");
+    const QCommandLineOption memoryOption("memory", "Print a memory report after the command.");
+    parser.addOptions({ folderOption, dbOption, jsonOption, recursiveOption, csvOption, anyOption,
+                        minRatingOption, sizeOption, traceOption, memoryOption });
+    parser.process(app);
+
+    QStringList positional = parser.positionalArguments();
+    if (positional.isEmpty()) {
+        parser.showHelp(ExitUsage);
+    }
+    const QString command = positional.takeFirst();
+    static const QStringList commands = { "scan", "tag", "untag", "query", "rate", "thumbs", "stats" };
+    if (!commands.contains(command)) {
+        // Before anything is opened, so a typo doesn't create a database
+        err() << "Unknown command: " << command << Qt::endl;
+        return ExitUsage;
+    }
+
+    Context ctx;
+    ctx.json = parser.isSet(jsonOption);
+    ctx.recursive = parser.isSet(recursiveOption);
+    ctx.csvPath = parser.value(csvOption);
+    ctx.any = parser.isSet(anyOption);
+    ctx.minRating = parser.value(minRatingOption).toInt();
+    ctx.size = qBound(32, parser.value(sizeOption).toInt(), 1024);
+    ctx.folder = parser.isSet(folderOption) ? parser.value(folderOption) : QDir::currentPath();
+    if ((command == "scan" || command == "thumbs") && !positional.isEmpty()) {
+        ctx.folder = positional.takeFirst();
+    }
+    ctx.folder = QDir::cleanPath(QDir(ctx.folder).absolutePath());
+    ctx.args = positional;
+
+    if (!QFileInfo(ctx.folder).isDir()) {
+        err() << "Not a folder: " << ctx.folder << Qt::endl;
+        return ExitUsage;
+    }
+
+    const QString tracePath = parser.value(traceOption);
+    EventTrace::setEnabled(!tracePath.isEmpty());
+
+    int result = ExitUsage;
+    const QString dbPath = parser.isSet(dbOption) ? parser.value(dbOption)
+                                                  : ctx.folder + "/fullframe.db";
+    if (command == "thumbs") {
+        // Thumbnails don't touch the database
+        result = runThumbs(ctx);
+    } else if (!TagManager::instance()->initialize(dbPath)) {
+        err() << "Cannot open database " << dbPath << Qt::endl;
+        result = ExitFailed;
+    } else if (command == "scan") {
+        result = runScan(ctx);
+    } else if (command == "tag" || command == "untag") {
+        result = runTag(ctx, command == "tag");
+    } else if (command == "query") {
+        result = runQuery(ctx);
+    } else if (command == "rate") {
+        result = runRate(ctx);
+    } else if (command == "stats") {
+        result = runStats(ctx);
+    }
+
+    if (parser.isSet(memoryOption)) {
+        MemoryReport report;
+        TagManager::instance()->reportMemory(report);
+        if (ctx.json) {
+            jsonResult()["memory"] = report.toJson();
+        } else {
+            out() << '\n' << report.toText();
+            out().flush();
+        }
+    }
+    if (ctx.json && !jsonResult().isEmpty()) {
+        printJson(jsonResult());
+    }
+
+    TagManager::cleanup();
+
+    if (!tracePath.isEmpty()) {
+        EventTrace::setEnabled(false);
+        QString error;
+        if (!EventTrace::writeChromeTrace(tracePath, &error)) {
+            err() << "Cannot write trace " << tracePath << ": " << error << Qt::endl;
+        }
+    }
+    return result;
+}
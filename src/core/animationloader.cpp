@@ -0,0 +1,541 @@
+/**
+ * AnimationLoader implementation
+ */
+
+#include "animationloader.h"
+#include "memoryreport.h"
+
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSet>
+#include <QThreadPool>
+#include <QTimer>
+#include <QDebug>
+
+namespace FullFrame {
+
+AnimationLoader* AnimationLoader::s_instance = nullptr;
+
+namespace {
+constexpr int CacheBudgetKiB = 128 * 1024;
+constexpr int FirstFrameBudgetKiB = 16 * 1024;
+
+// Browsers treat delays this short as "unspecified" and use 100ms
+constexpr int MinFrameDelayMs = 20;
+constexpr int DefaultFrameDelayMs = 100;
+
+int costKiB(qint64 bytes)
+{
+    return int(qMax<qint64>(1, bytes / 1024));
+}
+}
+
+// ============== AnimationDecoder ==============
+
+AnimationDecoder::AnimationDecoder(const QSharedPointer<AnimationData>& data)
+    : m_data(data)
+{
+    setAutoDelete(true);
+}
+
+void AnimationDecoder::run()
+{
+    QImageReader reader(m_data->filePath);
+    if (m_data->frameSize.isValid()) {
+        // Handlers that can't scale (GIF) get scaled by the reader, still
+        // on this thread
+        reader.setScaledSize(m_data->frameSize);
+    }
+
+    int frameNumber = 0;
+    int framesThisPass = 0;
+    for (;;) {
+        QImage image = reader.canRead() ? reader.read() : QImage();
+
+        if (image.isNull()) {
+            // End of one pass through the file
+            QMutexLocker locker(&m_data->mutex);
+            if (framesThisPass == 0) {
+                if (frameNumber == 0) {
+                    qWarning() << "AnimationLoader: failed to decode" << m_data->filePath
+                               << reader.errorString();
+                    m_data->failed = true;
+                }
+                break;
+            }
+            if (m_data->frameCount < 0) {
+                m_data->frameCount = framesThisPass;
+            }
+            if (!m_data->streaming) {
+                m_data->complete = true;
+                break;
+            }
+            if (m_data->stop) {
+                break;
+            }
+            locker.unlock();
+
+            // Streaming: wrap around and keep feeding the ring
+            reader.setFileName(m_data->filePath);
+            if (m_data->frameSize.isValid()) {
+                reader.setScaledSize(m_data->frameSize);
+            }
+            framesThisPass = 0;
+            continue;
+        }
+
+        int delayMs = reader.nextImageDelay();
+        if (delayMs < MinFrameDelayMs) {
+            delayMs = DefaultFrameDelayMs;
+        }
+
+        // Premultiplied ARGB is what QPixmap stores, so fromImage() on the
+        // GUI thread is a plain copy
+        image.convertTo(QImage::Format_ARGB32_Premultiplied);
+
+        if (!append(image, delayMs)) {
+            break;
+        }
+        ++frameNumber;
+        ++framesThisPass;
+        Q_EMIT framesAppended(m_data->key);
+    }
+
+    Q_EMIT finished(m_data->key);
+}
+
+bool AnimationDecoder::append(const QImage& image, int delayMs)
+{
+    QMutexLocker locker(&m_data->mutex);
+
+    const qint64 frameBytes = image.sizeInBytes();
+    if (!m_data->streaming && m_data->bytes + frameBytes > AnimationLoader::PerAnimationBudgetBytes) {
+        // Too big to keep whole: drop what has been shown and become a ring
+        m_data->streaming = true;
+        const int shown = qBound(0, m_data->playhead - m_data->firstFrameNumber, int(m_data->frames.size()));
+        for (int i = 0; i < shown; ++i) {
+            m_data->bytes -= m_data->frames[i].image.sizeInBytes();
+        }
+        m_data->frames.remove(0, shown);
+        m_data->firstFrameNumber += shown;
+    }
+
+    if (m_data->streaming) {
+        while (!m_data->stop && m_data->frames.size() >= AnimationLoader::RingFrames) {
+            m_data->spaceAvailable.wait(&m_data->mutex);
+        }
+    }
+    if (m_data->stop) {
+        return false;
+    }
+
+    m_data->frames.append(AnimationFrame{image, delayMs});
+    m_data->bytes += frameBytes;
+    return true;
+}
+
+// ============== AnimationPlayer ==============
+
+AnimationPlayer::AnimationPlayer(QObject* parent)
+    : QObject(parent)
+{
+}
+
+AnimationPlayer::~AnimationPlayer()
+{
+    stop();
+}
+
+QString AnimationPlayer::filePath() const
+{
+    return m_data ? m_data->filePath : QString();
+}
+
+void AnimationPlayer::start(const QString& filePath, const QSize& boundingSize)
+{
+    stop();
+
+    AnimationLoader* loader = AnimationLoader::instance();
+    m_data = loader->acquire(filePath, boundingSize);
+    m_frameNumber = -1;
+    m_deadlineMs = -1;
+    loader->registerPlayer(this);
+
+    bool complete = false;
+    bool decodeFailed = false;
+    {
+        QMutexLocker locker(&m_data->mutex);
+        complete = m_data->complete;
+        decodeFailed = m_data->failed;
+    }
+    if (decodeFailed) {
+        Q_EMIT failed();
+        return;
+    }
+
+    // Revisits show the remembered first frame while decoding starts over
+    if (!complete) {
+        const QImage first = loader->firstFrame(m_data->key);
+        if (!first.isNull()) {
+            Q_EMIT frameChanged(first);
+        }
+    }
+
+    advance(loader->nowMs());
+    loader->scheduleTick();
+}
+
+void AnimationPlayer::stop()
+{
+    if (!m_data) {
+        return;
+    }
+    QSharedPointer<AnimationData> data = m_data;
+    m_data.reset();
+    m_deadlineMs = -1;
+
+    AnimationLoader* loader = AnimationLoader::instance();
+    loader->unregisterPlayer(this);
+    loader->release(data);
+}
+
+void AnimationPlayer::advance(qint64 nowMs)
+{
+    if (!m_data) {
+        return;
+    }
+
+    const int next = m_frameNumber + 1;
+    QImage image;
+    int delayMs = 0;
+    bool found = false;
+    bool still = false;
+    {
+        QMutexLocker locker(&m_data->mutex);
+        QVector<AnimationFrame>& frames = m_data->frames;
+
+        if (m_data->complete) {
+            if (!frames.isEmpty()) {
+                const AnimationFrame& frame = frames[next % frames.size()];
+                image = frame.image;
+                delayMs = frame.delayMs;
+                found = true;
+                still = frames.size() == 1;
+            }
+        } else {
+            const int index = next - m_data->firstFrameNumber;
+            if (index >= 0 && index < frames.size()) {
+                image = frames[index].image;
+                delayMs = frames[index].delayMs;
+                found = true;
+
+                // The ring only needs to hold frames not yet shown
+                if (m_data->streaming && index > 0) {
+                    for (int i = 0; i < index; ++i) {
+                        m_data->bytes -= frames[i].image.sizeInBytes();
+                    }
+                    frames.remove(0, index);
+                    m_data->firstFrameNumber = next;
+                }
+                m_data->playhead = next;
+                m_data->spaceAvailable.wakeAll();
+            }
+        }
+    }
+
+    if (!found) {
+        m_deadlineMs = -1;   // Starved; framesAvailable() resumes playback
+        return;
+    }
+
+    m_frameNumber = next;
+    m_deadlineMs = still ? -1 : nowMs + delayMs;
+    Q_EMIT frameChanged(image);
+}
+
+void AnimationPlayer::framesAvailable(qint64 nowMs)
+{
+    if (m_data && m_deadlineMs < 0) {
+        advance(nowMs);
+    }
+}
+
+// ============== AnimationLoader ==============
+
+AnimationLoader* AnimationLoader::instance()
+{
+    if (!s_instance) {
+        s_instance = new AnimationLoader();
+    }
+    return s_instance;
+}
+
+void AnimationLoader::cleanup()
+{
+    delete s_instance;
+    s_instance = nullptr;
+}
+
+bool AnimationLoader::isAnimationFile(const QString& filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    return suffix == "gif" || suffix == "webp" || suffix == "apng";
+}
+
+AnimationLoader::AnimationLoader(QObject* parent)
+    : QObject(parent)
+    , m_threadPool(new QThreadPool(this))
+    , m_cache(CacheBudgetKiB)
+    , m_firstFrames(FirstFrameBudgetKiB)
+    , m_tickTimer(new QTimer(this))
+{
+    // Streaming decoders block while their ring is full, so they get their
+    // own pool rather than occupying thumbnail threads
+    m_threadPool->setMaxThreadCount(2);
+
+    m_tickTimer->setSingleShot(true);
+    m_tickTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_tickTimer, &QTimer::timeout, this, &AnimationLoader::onTick);
+
+    m_clock.start();
+}
+
+AnimationLoader::~AnimationLoader()
+{
+    // Players outlive the loader at shutdown; detach them
+    for (AnimationPlayer* player : m_players) {
+        player->m_data.reset();
+        player->m_deadlineMs = -1;
+    }
+    m_players.clear();
+
+    for (const QSharedPointer<AnimationData>& data : m_decoding) {
+        QMutexLocker locker(&data->mutex);
+        data->stop = true;
+        data->spaceAvailable.wakeAll();
+    }
+    m_threadPool->clear();
+    m_threadPool->waitForDone();
+}
+
+QSharedPointer<AnimationData> AnimationLoader::acquire(const QString& filePath, const QSize& boundingSize)
+{
+    // Header read only, to fit the frames to the view
+    QImageReader reader(filePath);
+    QSize frameSize = reader.size();
+    if (frameSize.isValid() && !boundingSize.isEmpty()) {
+        frameSize = frameSize.scaled(boundingSize, Qt::KeepAspectRatio);
+    }
+
+    const QString key = QString("%1@%2x%3").arg(filePath).arg(frameSize.width()).arg(frameSize.height());
+
+    if (CacheEntry* entry = m_cache.object(key)) {
+        return entry->data;
+    }
+    auto it = m_decoding.constFind(key);
+    if (it != m_decoding.constEnd()) {
+        return it.value();
+    }
+
+    QSharedPointer<AnimationData> data(new AnimationData);
+    data->key = key;
+    data->filePath = filePath;
+    data->frameSize = frameSize;
+    m_decoding.insert(key, data);
+
+    AnimationDecoder* decoder = new AnimationDecoder(data);
+    connect(decoder, &AnimationDecoder::framesAppended,
+            this, &AnimationLoader::onFramesAppended,
+            Qt::QueuedConnection);
+    connect(decoder, &AnimationDecoder::finished,
+            this, &AnimationLoader::onDecoderFinished,
+            Qt::QueuedConnection);
+    m_threadPool->start(decoder);
+
+    return data;
+}
+
+void AnimationLoader::release(const QSharedPointer<AnimationData>& data)
+{
+    for (AnimationPlayer* player : m_players) {
+        if (player->m_data == data) {
+            return;   // Still playing elsewhere
+        }
+    }
+
+    QMutexLocker locker(&data->mutex);
+    if (data->complete) {
+        return;   // Lives on in m_cache
+    }
+    // Abandon a partial decode; the first frame is remembered for a revisit
+    data->stop = true;
+    data->spaceAvailable.wakeAll();
+    locker.unlock();
+
+    if (m_decoding.value(data->key) == data) {
+        m_decoding.remove(data->key);
+    }
+}
+
+QImage AnimationLoader::firstFrame(const QString& key) const
+{
+    const QImage* image = m_firstFrames.object(key);
+    return image ? *image : QImage();
+}
+
+void AnimationLoader::onFramesAppended(const QString& key)
+{
+    QSharedPointer<AnimationData> data = m_decoding.value(key);
+    if (data && !m_firstFrames.contains(key)) {
+        QMutexLocker locker(&data->mutex);
+        if (data->firstFrameNumber == 0 && !data->frames.isEmpty()) {
+            const QImage& first = data->frames.first().image;
+            m_firstFrames.insert(key, new QImage(first), costKiB(first.sizeInBytes()));
+        }
+    }
+
+    const qint64 now = nowMs();
+    for (AnimationPlayer* player : m_players) {
+        if (player->m_data && player->m_data->key == key) {
+            player->framesAvailable(now);
+        }
+    }
+    scheduleTick();
+}
+
+void AnimationLoader::onDecoderFinished(const QString& key)
+{
+    // The entry may already belong to a newer decode of the same key
+    QSharedPointer<AnimationData> data = m_decoding.value(key);
+    if (!data) {
+        return;
+    }
+    bool complete = false;
+    bool failed = false;
+    qint64 bytes = 0;
+    {
+        QMutexLocker locker(&data->mutex);
+        complete = data->complete;
+        failed = data->failed;
+        bytes = data->bytes;
+    }
+    if (!complete && !failed) {
+        return;
+    }
+    m_decoding.remove(key);
+
+    if (complete) {
+        m_cache.insert(key, new CacheEntry{data}, costKiB(bytes));
+    }
+
+    // Players may be starved for the final frames, or waiting on a failure
+    const qint64 now = nowMs();
+    const QVector<AnimationPlayer*> players = m_players;
+    for (AnimationPlayer* player : players) {
+        if (player->m_data != data) {
+            continue;
+        }
+        if (failed) {
+            Q_EMIT player->failed();
+        } else {
+            player->framesAvailable(now);
+        }
+    }
+    scheduleTick();
+}
+
+void AnimationLoader::registerPlayer(AnimationPlayer* player)
+{
+    if (!m_players.contains(player)) {
+        m_players.append(player);
+    }
+}
+
+void AnimationLoader::unregisterPlayer(AnimationPlayer* player)
+{
+    m_players.removeAll(player);
+    scheduleTick();
+}
+
+void AnimationLoader::onTick()
+{
+    // Slack of a millisecond so frames due together advance together
+    const qint64 now = nowMs();
+    const QVector<AnimationPlayer*> players = m_players;
+    for (AnimationPlayer* player : players) {
+        if (player->m_deadlineMs >= 0 && player->m_deadlineMs <= now + 1) {
+            player->advance(now);
+        }
+    }
+    scheduleTick();
+}
+
+void AnimationLoader::scheduleTick()
+{
+    qint64 earliest = -1;
+    for (const AnimationPlayer* player : m_players) {
+        if (player->m_deadlineMs >= 0 && (earliest < 0 || player->m_deadlineMs < earliest)) {
+            earliest = player->m_deadlineMs;
+        }
+    }
+
+    if (earliest < 0) {
+        m_tickTimer->stop();
+        return;
+    }
+    m_tickTimer->start(int(qMax<qint64>(0, earliest - nowMs())));
+}
+
+void AnimationLoader::clear()
+{
+    m_cache.clear();
+    m_firstFrames.clear();
+}
+
+void AnimationLoader::reportMemory(MemoryReport& report) const
+{
+    auto frameBytes = [&report](const QSharedPointer<AnimationData>& data) {
+        QMutexLocker locker(&data->mutex);
+        qint64 bytes = MemoryReport::stringBytes(data->key) + MemoryReport::stringBytes(data->filePath)
+                     + qint64(data->frames.capacity()) * sizeof(AnimationFrame);
+        for (const AnimationFrame& frame : data->frames) {
+            bytes += report.imageBytes(frame.image);
+        }
+        return bytes;
+    };
+
+    // QCache has no peek: object() makes each entry the most recent, so
+    // the animations being played are looked up last to stay that way
+    QSet<QString> playing;
+    for (const AnimationPlayer* player : m_players) {
+        if (player->m_data) {
+            playing.insert(player->m_data->key);
+        }
+    }
+    const QStringList keys = m_cache.keys();
+    qint64 bytes = 0;
+    for (const QString& key : keys) {
+        if (!playing.contains(key)) {
+            bytes += frameBytes(m_cache.object(key)->data);
+        }
+    }
+    for (const QString& key : playing) {
+        if (const CacheEntry* entry = m_cache.object(key)) {
+            bytes += frameBytes(entry->data);
+        }
+    }
+    for (const QSharedPointer<AnimationData>& data : m_decoding) {
+        bytes += frameBytes(data);
+    }
+    report.add("Animation frame cache", bytes, keys.size() + m_decoding.size());
+
+    // First frames usually share their data with a cached animation's
+    const QStringList firstKeys = m_firstFrames.keys();
+    qint64 firstBytes = 0;
+    for (const QString& key : firstKeys) {
+        firstBytes += MemoryReport::stringBytes(key) + report.imageBytes(*m_firstFrames.object(key));
+    }
+    report.add("Animation first frames", firstBytes, firstKeys.size());
+}
+
+} // namespace FullFrame
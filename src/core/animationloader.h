@@ -0,0 +1,197 @@
+/**
+ * AnimationLoader - Off-GUI-thread decoding and playback of animated images
+ *
+ * GIF (and WebP, or APNG where an image plugin provides it) animations are
+ * decoded by a worker at the size they are displayed at, never on the GUI
+ * thread:
+ * - Frames go into a shared AnimationData. Animations that fit in
+ *   PerAnimationBudgetBytes are kept whole, and once decoded they stay in
+ *   a byte-bounded LRU, so going back to one replays it without decoding
+ * - Larger animations switch to a ring of RingFrames frames that the
+ *   decoder fills ahead of playback and wraps around at the end
+ * - The first frame of every animation is remembered separately, so a
+ *   revisit shows it instantly even when the rest has to be decoded again
+ * - AnimationPlayers are driven by one precise timer in the loader, armed
+ *   for the earliest due frame across all players
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QCache>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QSize>
+#include <QVector>
+#include <QWaitCondition>
+
+class QThreadPool;
+class QTimer;
+
+namespace FullFrame {
+
+class MemoryReport;
+
+struct AnimationFrame
+{
+    QImage image;
+    int delayMs = 100;
+};
+
+/**
+ * Frames of one animation at one display size, shared between its decoder
+ * and the players showing it. Everything below `mutex` is guarded by it.
+ */
+struct AnimationData
+{
+    QString key;          // "path@WxH"
+    QString filePath;
+    QSize frameSize;      // Display size frames are decoded at
+
+    QMutex mutex;
+    QWaitCondition spaceAvailable;
+    QVector<AnimationFrame> frames;   // All frames, or a window when streaming
+    int firstFrameNumber = 0;         // Frame number of frames[0] (streaming)
+    int playhead = 0;                 // Frame number the player is showing
+    int frameCount = -1;              // Known after one pass
+    qint64 bytes = 0;
+    bool complete = false;            // `frames` holds the whole animation
+    bool streaming = false;           // Over budget; `frames` is a ring
+    bool failed = false;
+    bool stop = false;                // Ask the decoder to exit
+};
+
+/**
+ * Worker decoding one animation into its AnimationData
+ */
+class AnimationDecoder : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    explicit AnimationDecoder(const QSharedPointer<AnimationData>& data);
+    void run() override;
+
+Q_SIGNALS:
+    void framesAppended(const QString& key);
+    void finished(const QString& key);
+
+private:
+    // Returns false when asked to stop
+    bool append(const QImage& image, int delayMs);
+
+private:
+    QSharedPointer<AnimationData> m_data;
+};
+
+/**
+ * Plays one animation; frames arrive through frameChanged()
+ */
+class AnimationPlayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AnimationPlayer(QObject* parent = nullptr);
+    ~AnimationPlayer() override;
+
+    // Play filePath fitted into boundingSize (device pixels)
+    void start(const QString& filePath, const QSize& boundingSize);
+    void stop();
+
+    bool isActive() const { return !m_data.isNull(); }
+    QString filePath() const;
+
+Q_SIGNALS:
+    void frameChanged(const QImage& frame);
+    void failed();
+
+private:
+    friend class AnimationLoader;
+
+    // Called by AnimationLoader from its timer / when frames are decoded
+    void advance(qint64 nowMs);
+    void framesAvailable(qint64 nowMs);
+
+private:
+    QSharedPointer<AnimationData> m_data;
+    int m_frameNumber = -1;     // Frame currently shown
+    qint64 m_deadlineMs = -1;   // Next frame due; -1 while waiting for the decoder
+};
+
+/**
+ * Animation decoding/cache manager
+ * Singleton - use instance() to access
+ */
+class AnimationLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr qint64 PerAnimationBudgetBytes = 48ll * 1024 * 1024;
+    static constexpr int RingFrames = 16;
+
+    static AnimationLoader* instance();
+    static bool hasInstance() { return s_instance; }
+    static void cleanup();
+
+    // Formats that may be animated and go through this loader
+    static bool isAnimationFile(const QString& filePath);
+
+    void clear();
+
+    // Decoded frames (cached and in progress) and first frames
+    void reportMemory(MemoryReport& report) const;
+
+private Q_SLOTS:
+    void onFramesAppended(const QString& key);
+    void onDecoderFinished(const QString& key);
+    void onTick();
+
+private:
+    explicit AnimationLoader(QObject* parent = nullptr);
+    ~AnimationLoader() override;
+
+    // Disable copy
+    AnimationLoader(const AnimationLoader&) = delete;
+    AnimationLoader& operator=(const AnimationLoader&) = delete;
+
+    friend class AnimationPlayer;
+
+    QSharedPointer<AnimationData> acquire(const QString& filePath, const QSize& boundingSize);
+    void release(const QSharedPointer<AnimationData>& data);
+    QImage firstFrame(const QString& key) const;
+
+    void registerPlayer(AnimationPlayer* player);
+    void unregisterPlayer(AnimationPlayer* player);
+    void scheduleTick();
+    qint64 nowMs() const { return m_clock.elapsed(); }
+
+private:
+    struct CacheEntry
+    {
+        QSharedPointer<AnimationData> data;
+    };
+
+    static AnimationLoader* s_instance;
+
+    QThreadPool* m_threadPool;
+
+    // Fully decoded animations (cost in KiB), and the animations still
+    // being decoded for a player
+    QCache<QString, CacheEntry> m_cache;
+    QHash<QString, QSharedPointer<AnimationData>> m_decoding;
+
+    // First frame of every animation seen, for instant revisits (KiB)
+    QCache<QString, QImage> m_firstFrames;
+
+    QVector<AnimationPlayer*> m_players;
+    QTimer* m_tickTimer;
+    QElapsedTimer m_clock;
+};
+
+} // namespace FullFrame
@@ -0,0 +1,239 @@
+/**
+ * EventTrace implementation
+ */
+
+#include "eventtrace.h"
+
+#include <QCoreApplication>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <QVector>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace FullFrame {
+
+std::atomic<bool> EventTrace::s_enabled{false};
+
+namespace {
+struct Event
+{
+    const char* name;
+    const char* category;
+    qint64 startNs;
+    qint64 durationNs;
+    qint64 arg;
+};
+
+// A thread that wrote into a buffer, from event number `firstEvent` on
+struct BufferOwner
+{
+    quint64 firstEvent;
+    int tid;
+    QString threadName;
+};
+
+/**
+ * One thread's spans. Only the owning thread writes; the exporter reads
+ * behind the published count and drops slots that were overwritten while
+ * it was copying.
+ */
+struct ThreadBuffer
+{
+    QVector<Event> events;
+    std::atomic<quint64> written{0};
+    QVector<BufferOwner> owners;   // Oldest first; guarded by the registry mutex
+    bool inUse = true;
+};
+
+struct Registry
+{
+    QMutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    int nextTid = 1;
+    std::atomic<qint64> recordingStartNs{0};
+};
+
+Registry& registry()
+{
+    static Registry r;
+    return r;
+}
+
+// A pool thread that exits hands its buffer to the next new thread, so
+// thread churn doesn't grow memory while tracing. The new thread gets its
+// own tid; spans the old one left behind keep the old tid and name.
+struct ThreadSlot
+{
+    ThreadBuffer* buffer = nullptr;
+
+    ~ThreadSlot()
+    {
+        if (buffer) {
+            QMutexLocker locker(&registry().mutex);
+            buffer->inUse = false;
+        }
+    }
+};
+
+thread_local ThreadSlot t_slot;
+
+ThreadBuffer* acquireBuffer()
+{
+    Registry& r = registry();
+    QMutexLocker locker(&r.mutex);
+
+    QThread* thread = QThread::currentThread();
+    QString name = thread ? thread->objectName() : QString();
+    if (name.isEmpty()) {
+        const bool isMain = QCoreApplication::instance()
+                            && thread == QCoreApplication::instance()->thread();
+        name = isMain ? QStringLiteral("GUI") : QStringLiteral("Worker");
+    }
+
+    for (const auto& buffer : r.buffers) {
+        if (!buffer->inUse) {
+            buffer->inUse = true;
+            const quint64 firstEvent = buffer->written.load(std::memory_order_acquire);
+            // Forget owners whose spans have all been overwritten
+            const quint64 oldest = firstEvent > quint64(EventTrace::BufferCapacity)
+                                 ? firstEvent - EventTrace::BufferCapacity : 0;
+            while (buffer->owners.size() > 1 && buffer->owners.at(1).firstEvent <= oldest) {
+                buffer->owners.removeFirst();
+            }
+            buffer->owners.append({ firstEvent, r.nextTid++, name });
+            return buffer.get();
+        }
+    }
+
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->events.resize(EventTrace::BufferCapacity);
+    buffer->owners.append({ 0, r.nextTid++, name });
+    r.buffers.push_back(std::move(buffer));
+    return r.buffers.back().get();
+}
+
+void appendJsonString(QByteArray& out, const QByteArray& text)
+{
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += (c >= 0 && c < 0x20) ? ' ' : c;
+    }
+    out += '"';
+}
+
+QByteArray micros(qint64 ns)
+{
+    return QByteArray::number(ns / 1000.0, 'f', 3);
+}
+}
+
+qint64 EventTrace::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void EventTrace::setEnabled(bool enabled)
+{
+    if (enabled) {
+        registry().recordingStartNs.store(now(), std::memory_order_relaxed);
+    }
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void EventTrace::record(const char* name, const char* category, qint64 startNs, qint64 durationNs, qint64 arg)
+{
+    ThreadBuffer* buffer = t_slot.buffer;
+    if (!buffer) {
+        buffer = acquireBuffer();
+        t_slot.buffer = buffer;
+    }
+
+    const quint64 index = buffer->written.load(std::memory_order_relaxed);
+    buffer->events[int(index % BufferCapacity)] = { name, category, startNs, durationNs, arg };
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+bool EventTrace::writeChromeTrace(const QString& path, QString* error)
+{
+    Registry& r = registry();
+    const qint64 originNs = r.recordingStartNs.load(std::memory_order_relaxed);
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray json;
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) {
+            json += ",\n";
+        }
+        first = false;
+    };
+
+    {
+        QMutexLocker locker(&r.mutex);
+        QVector<Event> events;
+        for (const auto& buffer : r.buffers) {
+            for (const BufferOwner& owner : buffer->owners) {
+                separator();
+                json += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + pid
+                      + ",\"tid\":" + QByteArray::number(owner.tid) + ",\"args\":{\"name\":";
+                appendJsonString(json, owner.threadName.toUtf8());
+                json += "}}";
+            }
+
+            const quint64 end = buffer->written.load(std::memory_order_acquire);
+            const quint64 begin = end > quint64(BufferCapacity) ? end - BufferCapacity : 0;
+            events.clear();
+            events.reserve(int(end - begin));
+            for (quint64 i = begin; i < end; ++i) {
+                events.append(buffer->events[int(i % BufferCapacity)]);
+            }
+
+            // Slots the thread reused while we copied hold newer spans now,
+            // and the slot for span `after` may be half written
+            const quint64 after = buffer->written.load(std::memory_order_acquire);
+            const quint64 valid = after + 1 > quint64(BufferCapacity) ? after + 1 - BufferCapacity : 0;
+            int ownerIndex = 0;
+            for (quint64 i = qMax(begin, valid); i < end; ++i) {
+                while (ownerIndex + 1 < buffer->owners.size() && buffer->owners.at(ownerIndex + 1).firstEvent <= i) {
+                    ++ownerIndex;
+                }
+                const Event& event = events[int(i - begin)];
+                if (event.startNs < originNs) {
+                    continue;
+                }
+                separator();
+                json += "{\"ph\":\"X\",\"pid\":" + pid
+                      + ",\"tid\":" + QByteArray::number(buffer->owners.at(ownerIndex).tid)
+                      + ",\"ts\":" + micros(event.startNs - originNs)
+                      + ",\"dur\":" + micros(event.durationNs)
+                      + ",\"name\":\"" + event.name
+                      + "\",\"cat\":\"" + event.category + '"';
+                if (event.arg != NoArg) {
+                    json += ",\"args\":{\"n\":" + QByteArray::number(event.arg) + '}';
+                }
+                json += '}';
+            }
+        }
+    }
+    json += "\n]}\n";
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size() || !file.commit()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+} // namespace FullFrame
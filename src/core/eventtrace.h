@@ -0,0 +1,83 @@
+/**
+ * EventTrace - Timeline of what every thread is doing, for chrome://tracing
+ *
+ * Stages of the pipeline (scan, database, thumbnail I/O and decode, cache,
+ * model, paint, result delivery) open a Span for their duration. Each
+ * thread writes finished spans into its own fixed-size ring buffer, so
+ * recording takes no locks and keeps only the newest BufferCapacity spans
+ * per thread however long it runs. writeChromeTrace() exports what is
+ * buffered as Chrome trace-event JSON, which chrome://tracing and
+ * ui.perfetto.dev open directly.
+ *
+ * Off by default; while off a Span is one relaxed load and a not-taken
+ * branch. Span names and categories must be string literals: only the
+ * pointers are stored.
+ */
+
+#pragma once
+
+#include <QString>
+#include <atomic>
+#include <limits>
+
+namespace FullFrame {
+
+class EventTrace
+{
+public:
+    static constexpr int BufferCapacity = 32768;   // Spans kept per thread
+    static constexpr qint64 NoArg = std::numeric_limits<qint64>::min();
+
+    /**
+     * Records the time until it goes out of scope as one span on the
+     * calling thread, if tracing was on when it was created
+     */
+    class Span
+    {
+    public:
+        Span(const char* name, const char* category)
+            : m_name(name)
+            , m_category(category)
+            , m_startNs(isEnabled() ? now() : -1)
+        {
+        }
+        ~Span()
+        {
+            if (m_startNs >= 0) {
+                record(m_name, m_category, m_startNs, now() - m_startNs, m_arg);
+            }
+        }
+
+        // One number shown with the span, e.g. a file or row count
+        void setArg(qint64 value) { m_arg = value; }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char* m_name;
+        const char* m_category;
+        qint64 m_startNs;
+        qint64 m_arg = NoArg;
+    };
+
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    // Turning tracing on starts a new recording; spans from before it are
+    // left out of the export
+    static void setEnabled(bool enabled);
+
+    // Everything recorded since tracing was last turned on
+    static bool writeChromeTrace(const QString& path, QString* error = nullptr);
+
+private:
+    static qint64 now();
+    static void record(const char* name, const char* category, qint64 startNs, qint64 durationNs, qint64 arg);
+
+    static std::atomic<bool> s_enabled;
+};
+
+} // namespace FullFrame
@@ -0,0 +1,304 @@
+/**
+ * FileCopier implementation
+ */
+
+#include "filecopier.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#endif
+
+namespace FullFrame {
+
+#ifdef Q_OS_LINUX
+
+namespace {
+constexpr size_t StreamChunkBytes = 1 << 20;
+constexpr size_t CopyRangeChunkBytes = size_t(1) << 30;
+
+void setError(QString* error, int errorNumber)
+{
+    if (error) {
+        *error = QString::fromLocal8Bit(std::strerror(errorNumber));
+    }
+}
+
+// Copies the rest of `in` to `out` from their current offsets
+bool streamCopy(int in, int out, int* errorNumber)
+{
+    std::vector<char> buffer(StreamChunkBytes);
+    for (;;) {
+        const ssize_t got = ::read(in, buffer.data(), buffer.size());
+        if (got == 0) {
+            return true;
+        }
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            *errorNumber = errno;
+            return false;
+        }
+        for (ssize_t written = 0; written < got;) {
+            const ssize_t put = ::write(out, buffer.data() + written, size_t(got - written));
+            if (put < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                *errorNumber = errno;
+                return false;
+            }
+            written += put;
+        }
+    }
+}
+
+bool copyData(int in, int out, off_t size, int* errorNumber, FileCopier::Method* method)
+{
+#ifdef FICLONE
+    // Share the source's extents; fails cheaply (EOPNOTSUPP, EXDEV, EINVAL)
+    // where the filesystem can't
+    if (::ioctl(out, FICLONE, in) == 0) {
+        *method = FileCopier::Reflink;
+        return true;
+    }
+#endif
+
+    *method = FileCopier::CopyRange;
+    off_t remaining = size;
+    while (remaining > 0) {
+        const ssize_t copied = ::copy_file_range(in, nullptr, out, nullptr,
+                                                 size_t(qMin<off_t>(remaining, CopyRangeChunkBytes)), 0);
+        if (copied > 0) {
+            remaining -= copied;
+            continue;
+        }
+        if (copied == 0) {
+            break;   // Source shrank; whatever is left is copied below
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP) {
+            *method = FileCopier::ReadWrite;
+            break;   // Not for this pair of filesystems; offsets are where it stopped
+        }
+        *errorNumber = errno;
+        return false;
+    }
+    return streamCopy(in, out, errorNumber);
+}
+}
+
+FileCopier::Result FileCopier::copy(const QString& source, const QString& destination, QString* error,
+                                    Method* method)
+{
+    const QByteArray sourcePath = QFile::encodeName(source);
+    const QByteArray destinationPath = QFile::encodeName(destination);
+
+    const int in = ::open(sourcePath.constData(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        setError(error, errno);
+        return Failed;
+    }
+    struct stat info;
+    if (::fstat(in, &info) != 0) {
+        setError(error, errno);
+        ::close(in);
+        return Failed;
+    }
+
+    const int out = ::open(destinationPath.constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+                           info.st_mode & 07777);
+    if (out < 0) {
+        const int openError = errno;
+        ::close(in);
+        if (openError == EEXIST) {
+            return DestinationExists;
+        }
+        setError(error, openError);
+        return Failed;
+    }
+
+    int errorNumber = 0;
+    Method used = ReadWrite;
+    bool ok = copyData(in, out, info.st_size, &errorNumber, &used);
+    if (ok) {
+        const struct timespec times[2] = { info.st_atim, info.st_mtim };
+        ::futimens(out, times);
+    }
+    if (::close(out) != 0 && ok) {
+        errorNumber = errno;
+        ok = false;
+    }
+    ::close(in);
+
+    if (!ok) {
+        ::unlink(destinationPath.constData());
+        setError(error, errorNumber);
+        return Failed;
+    }
+    if (method) {
+        *method = used;
+    }
+    return Done;
+}
+
+FileCopier::Result FileCopier::move(const QString& source, const QString& destination, QString* error)
+{
+    const QByteArray sourcePath = QFile::encodeName(source);
+    const QByteArray destinationPath = QFile::encodeName(destination);
+
+    int renameError = 0;
+#ifdef RENAME_NOREPLACE
+    if (::renameat2(AT_FDCWD, sourcePath.constData(), AT_FDCWD, destinationPath.constData(),
+                    RENAME_NOREPLACE) == 0) {
+        return Done;
+    }
+    renameError = errno;
+    if (renameError == EEXIST) {
+        return DestinationExists;
+    }
+#else
+    renameError = EINVAL;
+#endif
+    if (renameError == EINVAL || renameError == ENOSYS) {
+        // Filesystem without RENAME_NOREPLACE
+        struct stat existing;
+        if (::lstat(destinationPath.constData(), &existing) == 0) {
+            return DestinationExists;
+        }
+        if (::rename(sourcePath.constData(), destinationPath.constData()) == 0) {
+            return Done;
+        }
+        renameError = errno;
+    }
+
+    if (renameError != EXDEV) {
+        setError(error, renameError);
+        return Failed;
+    }
+
+    // Different filesystems: copy, then drop the source
+    const Result copied = copy(source, destination, error);
+    if (copied != Done) {
+        return copied;
+    }
+    if (::unlink(sourcePath.constData()) != 0) {
+        const int unlinkError = errno;
+        ::unlink(destinationPath.constData());
+        setError(error, unlinkError);
+        return Failed;
+    }
+    return Done;
+}
+
+#else
+
+FileCopier::Result FileCopier::copy(const QString& source, const QString& destination, QString* error,
+                                    Method* method)
+{
+    if (QFileInfo::exists(destination)) {
+        return DestinationExists;
+    }
+
+    QFile file(source);
+    const QDateTime modified = file.fileTime(QFileDevice::FileModificationTime);
+    if (!file.copy(destination)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return Failed;
+    }
+
+    QFile copied(destination);
+    if (copied.open(QIODevice::Append)) {
+        copied.setFileTime(modified, QFileDevice::FileModificationTime);
+    }
+    if (method) {
+        *method = PlatformCopy;
+    }
+    return Done;
+}
+
+FileCopier::Result FileCopier::move(const QString& source, const QString& destination, QString* error)
+{
+    if (QFileInfo::exists(destination)) {
+        return DestinationExists;
+    }
+
+    // QFile::rename already copies and removes across volumes
+    QFile file(source);
+    if (!file.rename(destination)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return Failed;
+    }
+    return Done;
+}
+
+#endif
+
+// ============== DestinationNames ==============
+
+DestinationNames::DestinationNames(const QDir& dir)
+{
+    const QStringList existing = dir.entryList(
+        QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    m_taken.reserve(existing.size());
+    for (const QString& name : existing) {
+        m_taken.insert(key(name));
+    }
+}
+
+QString DestinationNames::claim(const QString& fileName, const QString& companionSuffix)
+{
+    QString name = fileName;
+    if (!isFree(name, companionSuffix)) {
+        const QFileInfo info(fileName);
+        const QString base = info.completeBaseName();
+        const QString suffix = info.suffix();
+        int counter = 1;
+        do {
+            name = suffix.isEmpty()
+                ? QString("%1_%2").arg(base).arg(counter++)
+                : QString("%1_%2.%3").arg(base).arg(counter++).arg(suffix);
+        } while (!isFree(name, companionSuffix));
+    }
+
+    m_taken.insert(key(name));
+    if (!companionSuffix.isEmpty()) {
+        m_taken.insert(key(name + companionSuffix));
+    }
+    return name;
+}
+
+bool DestinationNames::isFree(const QString& name, const QString& companionSuffix) const
+{
+    return !m_taken.contains(key(name))
+        && (companionSuffix.isEmpty() || !m_taken.contains(key(name + companionSuffix)));
+}
+
+QString DestinationNames::key(const QString& name)
+{
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+    return name.toLower();   // Case-insensitive filesystems
+#else
+    return name;
+#endif
+}
+
+} // namespace FullFrame
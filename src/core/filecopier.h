@@ -0,0 +1,71 @@
+/**
+ * FileCopier - Moving and copying single files without going through Qt's
+ * buffered fallbacks
+ *
+ * - move() renames without ever replacing an existing file. When source
+ *   and destination are on different filesystems it streams a copy and
+ *   unlinks the source instead
+ * - copy() creates the destination exclusively and, on Linux, first tries
+ *   a FICLONE reflink (btrfs, XFS: the copy shares the source's extents and
+ *   costs a metadata update), then lets the kernel move the data with
+ *   copy_file_range (no round trip through user space), then falls back to
+ *   a plain read/write loop. Permissions and the modification time are kept
+ * - DestinationNames lists a destination folder once and hands out names
+ *   that don't collide with it or with each other ("IMG_1.jpg", "IMG_2.jpg")
+ *
+ * Safe to call from worker threads.
+ */
+
+#pragma once
+
+#include <QDir>
+#include <QSet>
+#include <QString>
+
+namespace FullFrame {
+
+class FileCopier
+{
+public:
+    enum Result {
+        Done,
+        DestinationExists,   // Nothing was touched; pick another name
+        Failed
+    };
+
+    // How copy() ended up moving the data
+    enum Method {
+        Reflink,
+        CopyRange,
+        ReadWrite,
+        PlatformCopy   // QFile::copy on platforms without the Linux paths
+    };
+
+    static Result move(const QString& source, const QString& destination, QString* error = nullptr);
+    static Result copy(const QString& source, const QString& destination, QString* error = nullptr,
+                       Method* method = nullptr);
+};
+
+/**
+ * Free file names in one folder, for a batch that puts many files there.
+ * Not thread-safe; each batch owns its instance
+ */
+class DestinationNames
+{
+public:
+    explicit DestinationNames(const QDir& dir);
+
+    // fileName itself if free, else "<base>_<n>.<suffix>" for the first free
+    // n. With a companion suffix (".xmp"), fileName + companion must be free
+    // too and is claimed alongside it. Calling again after a move reported
+    // DestinationExists moves on to the next candidate
+    QString claim(const QString& fileName, const QString& companionSuffix = QString());
+
+private:
+    bool isFree(const QString& name, const QString& companionSuffix) const;
+    static QString key(const QString& name);
+
+    QSet<QString> m_taken;
+};
+
+} // namespace FullFrame
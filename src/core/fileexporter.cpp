@@ -0,0 +1,192 @@
+/**
+ * FileExporter implementation
+ */
+
+#include "fileexporter.h"
+#include "filecopier.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+
+namespace FullFrame {
+
+// ============== ExportWorker ==============
+
+ExportWorker::ExportWorker(const QSharedPointer<ExportPlan>& plan)
+    : m_plan(plan)
+{
+    setAutoDelete(true);
+}
+
+void ExportWorker::run()
+{
+    for (;;) {
+        if (m_plan->cancelled.loadRelaxed()) {
+            break;
+        }
+        const int index = m_plan->next.fetchAndAddRelaxed(1);
+        if (index >= m_plan->entries.size()) {
+            break;
+        }
+        const ExportPlan::Entry& entry = m_plan->entries[index];
+
+        QString error;
+        FileCopier::Method method = FileCopier::ReadWrite;
+        const FileCopier::Result result = FileCopier::copy(entry.source, entry.destination, &error, &method);
+        bool ok = result == FileCopier::Done;
+        if (result == FileCopier::DestinationExists) {
+            error = QStringLiteral("Destination already exists");
+        }
+
+        if (ok && !entry.sidecar.isEmpty()) {
+            QFile sidecar(entry.destination + QLatin1String(".xmp"));
+            if (!sidecar.open(QIODevice::WriteOnly | QIODevice::NewOnly)
+                || sidecar.write(entry.sidecar) != entry.sidecar.size()) {
+                ok = false;
+                error = QStringLiteral("Sidecar: ") + sidecar.errorString();
+            }
+        }
+
+        const qint64 bytes = ok ? QFileInfo(entry.destination).size() : 0;
+        Q_EMIT fileExported(index, ok, method, bytes, error);
+    }
+    Q_EMIT finished();
+}
+
+// ============== FileExporter ==============
+
+FileExporter::FileExporter(QObject* parent)
+    : QObject(parent)
+    , m_threadPool(new QThreadPool(this))
+{
+    // Reflinks are metadata updates and copy_file_range is I/O bound; a few
+    // threads keep the device queue full without thrashing a spinning disk
+    m_threadPool->setMaxThreadCount(qBound(2, QThread::idealThreadCount(), 4));
+}
+
+FileExporter::~FileExporter()
+{
+    cancel();
+    m_threadPool->waitForDone();
+}
+
+bool FileExporter::start(const QVector<ExportItem>& items, const QString& destinationDir, bool writeSidecars)
+{
+    if (isRunning() || items.isEmpty()) {
+        return false;
+    }
+
+    QDir dir(destinationDir);
+    if (!dir.exists() && !QDir().mkpath(destinationDir)) {
+        return false;
+    }
+
+    // A sidecar's name has to be free as well as its image's
+    DestinationNames names(dir);
+    const QString companion = writeSidecars ? QStringLiteral(".xmp") : QString();
+
+    QSharedPointer<ExportPlan> plan(new ExportPlan);
+    plan->entries.reserve(items.size());
+    for (const ExportItem& item : items) {
+        const QString name = names.claim(QFileInfo(item.source).fileName(), companion);
+
+        ExportPlan::Entry entry;
+        entry.source = item.source;
+        entry.destination = dir.filePath(name);
+        if (writeSidecars) {
+            entry.sidecar = sidecarXmp(item.tags, item.rating);
+        }
+        plan->entries.append(entry);
+    }
+
+    m_plan = plan;
+    m_done = 0;
+    m_failed = 0;
+    m_reflinked = 0;
+    m_bytes = 0;
+    m_errors.clear();
+
+    m_runningWorkers = qMin(m_threadPool->maxThreadCount(), int(plan->entries.size()));
+    for (int i = 0; i < m_runningWorkers; ++i) {
+        ExportWorker* worker = new ExportWorker(plan);
+        connect(worker, &ExportWorker::fileExported,
+                this, &FileExporter::onFileExported, Qt::QueuedConnection);
+        connect(worker, &ExportWorker::finished,
+                this, &FileExporter::onWorkerFinished, Qt::QueuedConnection);
+        m_threadPool->start(worker);
+    }
+    return true;
+}
+
+void FileExporter::cancel()
+{
+    if (m_plan) {
+        m_plan->cancelled.storeRelaxed(1);
+    }
+}
+
+void FileExporter::onFileExported(int entry, bool ok, int method, qint64 bytes, const QString& error)
+{
+    if (!m_plan) {
+        return;
+    }
+
+    ++m_done;
+    if (ok) {
+        m_bytes += bytes;
+        if (method == FileCopier::Reflink) {
+            ++m_reflinked;
+        }
+    } else {
+        ++m_failed;
+        m_errors.append(QString("%1: %2").arg(QFileInfo(m_plan->entries[entry].source).fileName(), error));
+    }
+    Q_EMIT progress(m_done, m_plan->entries.size(), m_bytes);
+}
+
+void FileExporter::onWorkerFinished()
+{
+    if (--m_runningWorkers > 0 || !m_plan) {
+        return;
+    }
+
+    const bool cancelled = m_plan->cancelled.loadRelaxed() != 0;
+    m_plan.reset();
+    Q_EMIT finished(m_done - m_failed, m_failed, m_reflinked, m_bytes, cancelled, m_errors);
+}
+
+// ============== Sidecars ==============
+
+QByteArray FileExporter::sidecarXmp(const QStringList& tags, int rating)
+{
+    QString xmp;
+    xmp += "<x:xmpmeta xmlns:x=\"adobe:ns:meta/\">\n"
+           " <rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\">\n"
+           "  <rdf:Description rdf:about=\"\"\n"
+           "    xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\"\n"
+           "    xmlns:dc=\"http://purl.org/dc/elements/1.1/\"";
+    if (rating > 0) {
+        xmp += QString("\n    xmp:Rating=\"%1\"").arg(qBound(1, rating, 5));
+    }
+    xmp += ">\n";
+
+    if (!tags.isEmpty()) {
+        xmp += "   <dc:subject>\n"
+               "    <rdf:Bag>\n";
+        for (const QString& tag : tags) {
+            xmp += "     <rdf:li>" + tag.toHtmlEscaped() + "</rdf:li>\n";
+        }
+        xmp += "    </rdf:Bag>\n"
+               "   </dc:subject>\n";
+    }
+
+    xmp += "  </rdf:Description>\n"
+           " </rdf:RDF>\n"
+           "</x:xmpmeta>\n";
+    return xmp.toUtf8();
+}
+
+} // namespace FullFrame
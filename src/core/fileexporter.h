@@ -0,0 +1,109 @@
+/**
+ * FileExporter - Copies a selection of images into a delivery folder
+ *
+ * - Destination names are settled up front against one listing of the
+ *   folder, so the copies themselves can run in parallel
+ * - Each file goes through FileCopier::copy(): a reflink where the
+ *   filesystem supports it (btrfs, XFS), copy_file_range otherwise
+ * - Optionally writes an XMP sidecar per file ("photo.jpg.xmp") carrying
+ *   its tags as dc:subject keywords and its rating as xmp:Rating, in the
+ *   same pass as the copy
+ * - Workers pull the next file from a shared counter, so a few large
+ *   files don't leave the other threads idle
+ *
+ * One export at a time per FileExporter. Signals are delivered on the
+ * owner's thread.
+ */
+
+#pragma once
+
+#include <QAtomicInt>
+#include <QObject>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+
+class QThreadPool;
+
+namespace FullFrame {
+
+struct ExportItem
+{
+    QString source;
+    QStringList tags;   // Sidecar keywords
+    int rating = 0;     // Sidecar rating, 0 = none
+};
+
+/**
+ * State shared by the workers of one export
+ */
+struct ExportPlan
+{
+    struct Entry
+    {
+        QString source;
+        QString destination;
+        QByteArray sidecar;   // Empty = no sidecar
+    };
+
+    QVector<Entry> entries;
+    QAtomicInt next;
+    QAtomicInt cancelled;
+};
+
+class ExportWorker : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    explicit ExportWorker(const QSharedPointer<ExportPlan>& plan);
+    void run() override;
+
+Q_SIGNALS:
+    // method is a FileCopier::Method; meaningless when ok is false
+    void fileExported(int entry, bool ok, int method, qint64 bytes, const QString& error);
+    void finished();
+
+private:
+    QSharedPointer<ExportPlan> m_plan;
+};
+
+class FileExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FileExporter(QObject* parent = nullptr);
+    ~FileExporter() override;
+
+    // Returns false if an export is already running or the folder can't be
+    // created
+    bool start(const QVector<ExportItem>& items, const QString& destinationDir, bool writeSidecars);
+    void cancel();
+    bool isRunning() const { return !m_plan.isNull(); }
+
+    static QByteArray sidecarXmp(const QStringList& tags, int rating);
+
+Q_SIGNALS:
+    void progress(int done, int total, qint64 bytes);
+    // reflinked: files whose data was shared rather than copied
+    void finished(int exported, int failed, int reflinked, qint64 bytes, bool cancelled,
+                  const QStringList& errors);
+
+private Q_SLOTS:
+    void onFileExported(int entry, bool ok, int method, qint64 bytes, const QString& error);
+    void onWorkerFinished();
+
+private:
+    QThreadPool* m_threadPool;
+    QSharedPointer<ExportPlan> m_plan;
+    int m_runningWorkers = 0;
+    int m_done = 0;
+    int m_failed = 0;
+    int m_reflinked = 0;
+    qint64 m_bytes = 0;
+    QStringList m_errors;
+};
+
+} // namespace FullFrame
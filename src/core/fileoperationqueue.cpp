@@ -0,0 +1,222 @@
+/**
+ * FileOperationQueue implementation
+ */
+
+#include "fileoperationqueue.h"
+#include "filecopier.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThreadPool>
+
+namespace FullFrame {
+
+FileOperationQueue* FileOperationQueue::s_instance = nullptr;
+
+// ============== FileOperationWorker ==============
+
+FileOperationWorker::FileOperationWorker(const QSharedPointer<FileOperationJob>& job)
+    : m_job(job)
+{
+    setAutoDelete(true);
+}
+
+void FileOperationWorker::run()
+{
+    if (m_job->kind == FileOperationJob::Move) {
+        runMove();
+    } else {
+        runTrash();
+    }
+    Q_EMIT finished(m_job->id, m_job->cancelled.loadRelaxed() != 0);
+}
+
+void FileOperationWorker::runMove()
+{
+    QDir destinationDir(m_job->destinationDir);
+    if (!destinationDir.exists()) {
+        QDir().mkpath(m_job->destinationDir);
+    }
+    const QString destinationPath = destinationDir.absolutePath();
+
+    DestinationNames names(destinationDir);
+
+    QVector<FileOperationResult> batch;
+    int handled = 0;
+    for (const QString& source : m_job->sources) {
+        if (m_job->cancelled.loadRelaxed()) {
+            break;
+        }
+        ++handled;
+
+        const QFileInfo info(source);
+        if (info.absolutePath() == destinationPath || !info.exists()) {
+            continue;
+        }
+
+        FileOperationResult result;
+        result.source = source;
+        for (;;) {
+            const QString destination = destinationDir.filePath(names.claim(info.fileName()));
+            const FileCopier::Result moved = FileCopier::move(source, destination, &result.error);
+            if (moved == FileCopier::DestinationExists) {
+                continue;   // Created since the listing
+            }
+            result.ok = moved == FileCopier::Done;
+            if (result.ok) {
+                result.destination = destination;
+            }
+            break;
+        }
+        batch.append(result);
+
+        if (batch.size() == FileOperationQueue::BatchSize) {
+            Q_EMIT batchDone(m_job->id, batch, handled);
+            batch.clear();
+        }
+    }
+
+    Q_EMIT batchDone(m_job->id, batch, handled);
+}
+
+void FileOperationWorker::runTrash()
+{
+    QVector<FileOperationResult> batch;
+    int handled = 0;
+    for (const QString& source : m_job->sources) {
+        if (m_job->cancelled.loadRelaxed()) {
+            break;
+        }
+        ++handled;
+
+        FileOperationResult result;
+        result.source = source;
+        QFile file(source);
+        result.ok = file.moveToTrash();
+        if (!result.ok) {
+            result.error = file.errorString();
+        }
+        batch.append(result);
+
+        if (batch.size() == FileOperationQueue::BatchSize) {
+            Q_EMIT batchDone(m_job->id, batch, handled);
+            batch.clear();
+        }
+    }
+
+    Q_EMIT batchDone(m_job->id, batch, handled);
+}
+
+// ============== FileOperationQueue ==============
+
+FileOperationQueue* FileOperationQueue::instance()
+{
+    if (!s_instance) {
+        s_instance = new FileOperationQueue();
+    }
+    return s_instance;
+}
+
+void FileOperationQueue::cleanup()
+{
+    delete s_instance;
+    s_instance = nullptr;
+}
+
+FileOperationQueue::FileOperationQueue(QObject* parent)
+    : QObject(parent)
+    , m_threadPool(new QThreadPool(this))
+{
+    qRegisterMetaType<QVector<FileOperationResult>>();
+
+    // One job at a time, in the order they were queued
+    m_threadPool->setMaxThreadCount(1);
+}
+
+FileOperationQueue::~FileOperationQueue()
+{
+    cancelAll();
+    m_threadPool->clear();
+    m_threadPool->waitForDone();
+}
+
+int FileOperationQueue::move(const QStringList& sources, const QString& destinationDir)
+{
+    QSharedPointer<FileOperationJob> job(new FileOperationJob);
+    job->kind = FileOperationJob::Move;
+    job->sources = sources;
+    job->destinationDir = destinationDir;
+    return enqueue(job);
+}
+
+int FileOperationQueue::moveToTrash(const QStringList& paths)
+{
+    QSharedPointer<FileOperationJob> job(new FileOperationJob);
+    job->kind = FileOperationJob::Trash;
+    job->sources = paths;
+    return enqueue(job);
+}
+
+int FileOperationQueue::enqueue(const QSharedPointer<FileOperationJob>& job)
+{
+    job->id = m_nextJobId++;
+
+    JobState state;
+    state.job = job;
+    m_jobs.insert(job->id, state);
+
+    FileOperationWorker* worker = new FileOperationWorker(job);
+    connect(worker, &FileOperationWorker::batchDone,
+            this, &FileOperationQueue::slotBatchDone, Qt::QueuedConnection);
+    connect(worker, &FileOperationWorker::finished,
+            this, &FileOperationQueue::slotWorkerFinished, Qt::QueuedConnection);
+    m_threadPool->start(worker);
+    return job->id;
+}
+
+void FileOperationQueue::cancel(int jobId)
+{
+    auto it = m_jobs.find(jobId);
+    if (it != m_jobs.end()) {
+        it->job->cancelled.storeRelaxed(1);
+    }
+}
+
+void FileOperationQueue::cancelAll()
+{
+    for (const JobState& state : m_jobs) {
+        state.job->cancelled.storeRelaxed(1);
+    }
+}
+
+void FileOperationQueue::slotBatchDone(int jobId, const QVector<FileOperationResult>& results, int handled)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end()) {
+        return;
+    }
+    for (const FileOperationResult& result : results) {
+        if (result.ok) {
+            ++it->succeeded;
+        } else {
+            ++it->failed;
+        }
+    }
+    const int total = it->job->sources.size();
+
+    if (!results.isEmpty()) {
+        Q_EMIT batchFinished(jobId, results);
+    }
+    Q_EMIT progress(jobId, handled, total);
+}
+
+void FileOperationQueue::slotWorkerFinished(int jobId, bool cancelled)
+{
+    const JobState state = m_jobs.take(jobId);
+    if (state.job) {
+        Q_EMIT jobFinished(jobId, state.succeeded, state.failed, cancelled);
+    }
+}
+
+} // namespace FullFrame
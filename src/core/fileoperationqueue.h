@@ -0,0 +1,135 @@
+/**
+ * FileOperationQueue - Background moves and trash operations on image files
+ *
+ * Album moves and deletes used to rename files one by one on the GUI
+ * thread and then rescan the folder. Here they are jobs run in order by a
+ * single worker thread:
+ * - A move lists its destination folder once and resolves name conflicts
+ *   against that listing ("name_1.jpg", "name_2.jpg", ...) instead of an
+ *   exists() probe per candidate
+ * - Files are moved with FileCopier, which streams a copy and unlinks the
+ *   source when the destination is on another filesystem
+ * - Results come back to the GUI thread in batches of BatchSize, so the
+ *   receiver can update the database in one transaction and the model
+ *   with row removals/inserts per batch
+ * - Jobs can be cancelled; files already handled stay handled
+ *
+ * Singleton - use instance() to access. Signals are delivered on the GUI
+ * thread.
+ */
+
+#pragma once
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QMetaType>
+#include <QObject>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+
+class QThreadPool;
+
+namespace FullFrame {
+
+struct FileOperationResult
+{
+    QString source;
+    QString destination;   // Empty for trash
+    bool ok = false;
+    QString error;
+};
+
+struct FileOperationJob
+{
+    enum Kind { Move, Trash };
+
+    int id = 0;
+    Kind kind = Move;
+    QStringList sources;
+    QString destinationDir;   // Move only
+    QAtomicInt cancelled;
+};
+
+/**
+ * Worker running one job in the queue's thread pool
+ */
+class FileOperationWorker : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    explicit FileOperationWorker(const QSharedPointer<FileOperationJob>& job);
+    void run() override;
+
+Q_SIGNALS:
+    // `handled` counts sources done so far, including skipped ones
+    void batchDone(int jobId, const QVector<FileOperationResult>& results, int handled);
+    void finished(int jobId, bool cancelled);
+
+private:
+    void runMove();
+    void runTrash();
+
+private:
+    QSharedPointer<FileOperationJob> m_job;
+};
+
+class FileOperationQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int BatchSize = 200;
+
+    static FileOperationQueue* instance();
+    static void cleanup();
+
+    // Queue a job; returns its id. Sources that no longer exist, or that
+    // are already in destinationDir, are skipped without a result.
+    int move(const QStringList& sources, const QString& destinationDir);
+    int moveToTrash(const QStringList& paths);
+
+    void cancel(int jobId);
+    void cancelAll();
+    bool isBusy() const { return !m_jobs.isEmpty(); }
+
+Q_SIGNALS:
+    // One batch of handled files; apply it before the next one arrives
+    void batchFinished(int jobId, const QVector<FileOperationResult>& results);
+    void progress(int jobId, int handled, int total);
+    void jobFinished(int jobId, int succeeded, int failed, bool cancelled);
+
+private Q_SLOTS:
+    void slotBatchDone(int jobId, const QVector<FileOperationResult>& results, int handled);
+    void slotWorkerFinished(int jobId, bool cancelled);
+
+private:
+    explicit FileOperationQueue(QObject* parent = nullptr);
+    ~FileOperationQueue() override;
+
+    // Disable copy
+    FileOperationQueue(const FileOperationQueue&) = delete;
+    FileOperationQueue& operator=(const FileOperationQueue&) = delete;
+
+    int enqueue(const QSharedPointer<FileOperationJob>& job);
+
+    struct JobState
+    {
+        QSharedPointer<FileOperationJob> job;
+        int succeeded = 0;
+        int failed = 0;
+    };
+
+private:
+    static FileOperationQueue* s_instance;
+
+    QThreadPool* m_threadPool;
+    QHash<int, JobState> m_jobs;   // Queued or running
+    int m_nextJobId = 1;
+};
+
+} // namespace FullFrame
+
+Q_DECLARE_METATYPE(QVector<FullFrame::FileOperationResult>)
@@ -0,0 +1,298 @@
+/**
+ * HotkeyLatency implementation
+ */
+
+#include "hotkeylatency.h"
+#include "perfcounters.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QTimer>
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace FullFrame {
+
+bool HotkeyLatency::s_tracing = false;
+
+namespace {
+struct OpenScope
+{
+    HotkeyLatency::Phase phase;
+    qint64 startNs;
+    qint64 childNs;   // Time spent in scopes nested in this one
+};
+
+struct TraceState
+{
+    QElapsedTimer clock;
+
+    // Trace in progress
+    HotkeyLatency::Record current;
+    qint64 startNs = 0;
+    qint64 handlerEndNs = 0;
+    qint64 phaseNs[HotkeyLatency::PhaseCount] = {};
+    QVector<OpenScope> scopes;
+    bool awaitingPaint = false;
+    quint64 traceSerial = 0;
+
+    // Ring buffer of finished traces and their histogram
+    QVector<HotkeyLatency::Record> history = QVector<HotkeyLatency::Record>(HotkeyLatency::HistoryCapacity);
+    int head = 0;
+    int count = 0;
+    int buckets[HotkeyLatency::BucketCount] = {};
+};
+
+TraceState& state()
+{
+    static TraceState s;
+    return s;
+}
+
+int bucketFor(qint64 totalUs)
+{
+    const double ms = totalUs / 1000.0;
+    for (int bucket = 0; bucket < HotkeyLatency::BucketCount - 1; ++bucket) {
+        if (ms < HotkeyLatency::bucketLimitMs(bucket)) {
+            return bucket;
+        }
+    }
+    return HotkeyLatency::BucketCount - 1;
+}
+}
+
+double HotkeyLatency::bucketLimitMs(int bucket)
+{
+    if (bucket >= BucketCount - 1) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return 0.5 * double(1 << bucket);
+}
+
+// ============== Tracing ==============
+
+void HotkeyLatency::begin(const QString& key)
+{
+    TraceState& s = state();
+    if (s.awaitingPaint) {
+        // The next key arrived before anything was painted
+        finish(false);
+    }
+    s_tracing = false;
+    s.scopes.clear();
+
+    if (!PerfCounters::isEnabled()) {
+        return;
+    }
+    if (!s.clock.isValid()) {
+        s.clock.start();
+    }
+
+    s.current = Record();
+    s.current.key = key;
+    s.current.timestampMs = s.clock.elapsed();
+    std::fill(std::begin(s.phaseNs), std::end(s.phaseNs), 0);
+    s.startNs = s.clock.nsecsElapsed();
+    s_tracing = true;
+}
+
+void HotkeyLatency::setImageCount(int count)
+{
+    if (s_tracing) {
+        state().current.imageCount = count;
+    }
+}
+
+void HotkeyLatency::end()
+{
+    if (!s_tracing) {
+        return;
+    }
+    TraceState& s = state();
+    s_tracing = false;
+    s.scopes.clear();
+    s.handlerEndNs = s.clock.nsecsElapsed();
+    s.awaitingPaint = true;
+
+    // Nothing on screen may change (e.g. the tagged images are filtered
+    // out); don't let such a trace wait for an unrelated frame
+    const quint64 serial = ++s.traceSerial;
+    QTimer::singleShot(PaintTimeoutMs, [serial]() {
+        TraceState& s = state();
+        if (s.awaitingPaint && s.traceSerial == serial) {
+            finish(false);
+        }
+    });
+}
+
+void HotkeyLatency::cancel()
+{
+    s_tracing = false;
+    state().scopes.clear();
+}
+
+void HotkeyLatency::framePainted()
+{
+    if (state().awaitingPaint) {
+        finish(true);
+    }
+}
+
+void HotkeyLatency::push(Phase phase)
+{
+    TraceState& s = state();
+    s.scopes.append(OpenScope{phase, s.clock.nsecsElapsed(), 0});
+}
+
+void HotkeyLatency::pop()
+{
+    TraceState& s = state();
+    if (s.scopes.isEmpty()) {
+        return;   // Trace ended inside the scope
+    }
+    const OpenScope scope = s.scopes.takeLast();
+    const qint64 elapsedNs = s.clock.nsecsElapsed() - scope.startNs;
+    s.phaseNs[scope.phase] += elapsedNs - scope.childNs;
+    if (!s.scopes.isEmpty()) {
+        s.scopes.last().childNs += elapsedNs;
+    }
+}
+
+void HotkeyLatency::finish(bool painted)
+{
+    TraceState& s = state();
+    s.awaitingPaint = false;
+
+    const qint64 endNs = painted ? s.clock.nsecsElapsed() : s.handlerEndNs;
+    s.phaseNs[Repaint] = painted ? endNs - s.handlerEndNs : 0;
+
+    Record& record = s.current;
+    qint64 phasedNs = 0;
+    for (int phase = 0; phase < PhaseCount; ++phase) {
+        record.phaseUs[phase] = s.phaseNs[phase] / 1000;
+        if (phase != Repaint) {
+            phasedNs += s.phaseNs[phase];
+        }
+    }
+    record.otherUs = qMax<qint64>(0, s.handlerEndNs - s.startNs - phasedNs) / 1000;
+    record.totalUs = (endNs - s.startNs) / 1000;
+    record.painted = painted;
+
+    if (s.count == HistoryCapacity) {
+        --s.buckets[bucketFor(s.history[s.head].totalUs)];
+    }
+    s.history[s.head] = record;
+    ++s.buckets[bucketFor(record.totalUs)];
+    s.head = (s.head + 1) % HistoryCapacity;
+    s.count = qMin(s.count + 1, int(HistoryCapacity));
+}
+
+// ============== Queries ==============
+
+int HotkeyLatency::count()
+{
+    return state().count;
+}
+
+const HotkeyLatency::Record& HotkeyLatency::recordAt(int age)
+{
+    const TraceState& s = state();
+    return s.history[(s.head - 1 - age + HistoryCapacity) % HistoryCapacity];
+}
+
+int HotkeyLatency::bucketCount(int bucket)
+{
+    return state().buckets[bucket];
+}
+
+const char* HotkeyLatency::phaseName(Phase phase)
+{
+    switch (phase) {
+        case DbLookup:     return "dbLookup";
+        case DbWrite:      return "dbWrite";
+        case SignalFanOut: return "signalFanOut";
+        case ModelUpdate:  return "modelUpdate";
+        case Repaint:      return "repaint";
+        case PhaseCount:   break;
+    }
+    return "unknown";
+}
+
+// ============== Export ==============
+
+QJsonObject HotkeyLatency::toJson(int seconds)
+{
+    QJsonObject result;
+    result["seconds"] = seconds;
+
+    const int total = count();
+    if (total == 0) {
+        result["traces"] = QJsonArray();
+        return result;
+    }
+
+    const qint64 cutoff = recordAt(0).timestampMs - qint64(seconds) * 1000;
+    int oldestAge = -1;
+    while (oldestAge + 1 < total && recordAt(oldestAge + 1).timestampMs >= cutoff) {
+        ++oldestAge;
+    }
+
+    QJsonArray traces;
+    QVector<double> totals;
+    double phaseSumMs[PhaseCount] = {};
+    int buckets[BucketCount] = {};
+    totals.reserve(oldestAge + 1);
+    for (int age = oldestAge; age >= 0; --age) {
+        const Record& record = recordAt(age);
+        QJsonObject trace;
+        trace["tMs"] = double(record.timestampMs);
+        trace["key"] = record.key;
+        trace["images"] = record.imageCount;
+        for (int phase = 0; phase < PhaseCount; ++phase) {
+            const double ms = record.phaseUs[phase] / 1000.0;
+            trace[QString("%1Ms").arg(phaseName(Phase(phase)))] = ms;
+            phaseSumMs[phase] += ms;
+        }
+        trace["otherMs"] = record.otherUs / 1000.0;
+        trace["totalMs"] = record.totalUs / 1000.0;
+        trace["painted"] = record.painted;
+        traces.append(trace);
+        totals.append(record.totalUs / 1000.0);
+        ++buckets[bucketFor(record.totalUs)];
+    }
+    result["traces"] = traces;
+
+    std::sort(totals.begin(), totals.end());
+    auto percentile = [&totals](double p) {
+        return totals[qMin(totals.size() - 1, qsizetype(p * totals.size()))];
+    };
+
+    QJsonObject summary;
+    summary["traceCount"] = int(totals.size());
+    summary["p50Ms"] = percentile(0.50);
+    summary["p95Ms"] = percentile(0.95);
+    summary["p99Ms"] = percentile(0.99);
+    summary["maxMs"] = totals.last();
+    QJsonObject phaseAverages;
+    for (int phase = 0; phase < PhaseCount; ++phase) {
+        phaseAverages[phaseName(Phase(phase))] = phaseSumMs[phase] / totals.size();
+    }
+    summary["avgPhaseMs"] = phaseAverages;
+
+    QJsonArray histogram;
+    for (int bucket = 0; bucket < BucketCount; ++bucket) {
+        QJsonObject entry;
+        const double limit = bucketLimitMs(bucket);
+        entry["underMs"] = std::isinf(limit) ? QJsonValue() : QJsonValue(limit);
+        entry["count"] = buckets[bucket];
+        histogram.append(entry);
+    }
+    summary["histogram"] = histogram;
+    result["summary"] = summary;
+
+    return result;
+}
+
+} // namespace FullFrame
@@ -0,0 +1,112 @@
+/**
+ * HotkeyLatency - Keystroke-to-paint tracing for tag hotkeys
+ *
+ * Each tag hotkey is traced from the key event to the first view frame
+ * painted after it. The handler brackets its work with begin()/end(), and
+ * the tagging hot path marks its phases with Scope guards:
+ * - DbLookup:     resolving the hotkey and checking which images have the tag
+ * - DbWrite:      the image_tags inserts/deletes and their transaction
+ * - SignalFanOut: imageTagged/imageUntagged receivers other than the model
+ * - ModelUpdate:  ImageThumbnailModel reacting to the change
+ * - Repaint:      from the handler returning to the next frame painted
+ * Phase times are exclusive: a scope nested in another is not counted twice.
+ *
+ * Tracing runs only while PerfCounters are enabled (the frame-stats HUD is
+ * on), so with the HUD off every hook is one relaxed load or a bool test.
+ * GUI thread only.
+ */
+
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+
+namespace FullFrame {
+
+class HotkeyLatency
+{
+public:
+    enum Phase {
+        DbLookup,
+        DbWrite,
+        SignalFanOut,
+        ModelUpdate,
+        Repaint,
+        PhaseCount
+    };
+
+    struct Record
+    {
+        qint64 timestampMs = 0;   // When the key arrived, since the first trace
+        QString key;
+        int imageCount = 0;
+        qint64 phaseUs[PhaseCount] = {};
+        qint64 otherUs = 0;       // Handler time outside every phase
+        qint64 totalUs = 0;
+        bool painted = false;     // False if no frame followed within PaintTimeoutMs
+    };
+
+    /**
+     * Attributes the time until it goes out of scope to a phase of the
+     * current trace, if there is one
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(Phase phase)
+            : m_active(s_tracing)
+        {
+            if (m_active) {
+                push(phase);
+            }
+        }
+        ~Scope()
+        {
+            if (m_active) {
+                pop();
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        bool m_active;
+    };
+
+    static constexpr int HistoryCapacity = 4096;
+    static constexpr int PaintTimeoutMs = 500;
+
+    // Histogram of total latency: bucket i holds traces under 0.5 ms * 2^i,
+    // the last bucket everything slower
+    static constexpr int BucketCount = 10;
+    static double bucketLimitMs(int bucket);
+
+    // Start tracing the hotkey `key`; a no-op unless PerfCounters are on
+    static void begin(const QString& key);
+    static void setImageCount(int count);
+    // The handler is done; the trace completes at the next framePainted()
+    static void end();
+    // The key turned out not to be a tag hotkey; drop the trace
+    static void cancel();
+
+    // Called by FrameStatsOverlay after each recorded frame
+    static void framePainted();
+
+    static int count();
+    static const Record& recordAt(int age);   // 0 = newest
+    static int bucketCount(int bucket);       // Over the kept history
+    static const char* phaseName(Phase phase);
+
+    // Traces recorded within the last `seconds`, plus a summary
+    static QJsonObject toJson(int seconds);
+
+private:
+    static void push(Phase phase);
+    static void pop();
+    static void finish(bool painted);
+
+    static bool s_tracing;
+};
+
+} // namespace FullFrame
@@ -0,0 +1,505 @@
+/**
+ * ImageTileLoader implementation
+ */
+
+#include "imagetileloader.h"
+#include "memoryreport.h"
+
+#include <QImageReader>
+#include <QThread>
+#include <QThreadPool>
+#include <QTransform>
+#include <QDebug>
+#include <QtMath>
+#include <cmath>
+
+namespace FullFrame {
+
+ImageTileLoader* ImageTileLoader::s_instance = nullptr;
+
+namespace {
+constexpr int CacheBudgetKiB = 96 * 1024;   // ~96 tiles; a 4K view at one level needs ~40
+
+// Whole levels kept for the file in view; a 100 MP image's level 0 is ~400 MB
+constexpr qint64 LevelBudgetBytes = qint64(1024) * 1024 * 1024;
+
+// A level is decoded once per file, so it may exceed QImageReader's default
+// allocation limit (256 MB); beyond this it fails rather than swap
+constexpr int MaxLevelDecodeMiB = 4096;
+
+// Stored -> displayed pixel coordinates, oriented the way QImageReader's
+// auto-transform does it: mirror/flip first, then rotate clockwise
+QTransform orientation(QImageIOHandler::Transformations transformation, const QSize& storedSize)
+{
+    const qreal width = storedSize.width();
+    const qreal height = storedSize.height();
+    QTransform transform;
+    if (transformation & QImageIOHandler::TransformationMirror) {
+        transform *= QTransform(-1, 0, 0, 1, width, 0);
+    }
+    if (transformation & QImageIOHandler::TransformationFlip) {
+        transform *= QTransform(1, 0, 0, -1, 0, height);
+    }
+    if (transformation & QImageIOHandler::TransformationRotate90) {
+        transform *= QTransform(0, 1, -1, 0, height, 0);
+    }
+    return transform;
+}
+}
+
+// ============== ImageTileWorker ==============
+
+ImageTileWorker::ImageTileWorker(const QString& filePath, const QSize& sourceSize,
+                                 QImageIOHandler::Transformations transformation,
+                                 int level, const QVector<QPoint>& tiles)
+    : m_filePath(filePath)
+    , m_sourceSize(sourceSize)
+    , m_transformation(transformation)
+    , m_level(level)
+    , m_tiles(tiles)
+{
+    setAutoDelete(true);
+}
+
+void ImageTileWorker::run()
+{
+    ImageTileLoader* loader = ImageTileLoader::instance();
+    const int scale = 1 << m_level;
+    const QRect sourceBounds(QPoint(0, 0), m_sourceSize);
+
+    // Clip rects are in stored pixels, tiles in displayed ones
+    const bool rotated = m_transformation & QImageIOHandler::TransformationRotate90;
+    const QSize storedSize = rotated ? m_sourceSize.transposed() : m_sourceSize;
+    const QRect storedBounds(QPoint(0, 0), storedSize);
+    const QTransform toStored = orientation(m_transformation, storedSize).inverted();
+
+    for (const QPoint& tile : m_tiles) {
+        if (!loader->isWanted(ImageTileLoader::makeTileKey(m_filePath, m_level, tile))) {
+            Q_EMIT tileDecoded(m_filePath, m_level, tile, QImage(), true);
+            continue;
+        }
+
+        // Clip in source pixels, then let the codec scale the clip down to
+        // the tile (libjpeg does this during the IDCT)
+        const QRect levelRect = ImageTileLoader::tileRect(m_sourceSize, m_level, tile);
+        const QRect sourceRect = QRect(levelRect.topLeft() * scale, levelRect.size() * scale) & sourceBounds;
+        const QRect storedRect = toStored.mapRect(QRectF(sourceRect)).toAlignedRect() & storedBounds;
+
+        QImageReader reader(m_filePath);
+        reader.setAutoTransform(false);
+        reader.setClipRect(storedRect);
+        reader.setScaledSize(rotated ? levelRect.size().transposed() : levelRect.size());
+        QImage image = reader.read();
+        if (image.isNull()) {
+            qWarning() << "ImageTileLoader: failed to decode tile" << tile << "of" << m_filePath
+                       << reader.errorString();
+        } else if (m_transformation != QImageIOHandler::TransformationNone) {
+            image = image.transformed(orientation(m_transformation, image.size()));
+        }
+        Q_EMIT tileDecoded(m_filePath, m_level, tile, image, false);
+    }
+}
+
+// ============== ImageLevelWorker ==============
+
+ImageLevelWorker::ImageLevelWorker(const QString& filePath, const QSize& sourceSize, int level)
+    : m_filePath(filePath)
+    , m_sourceSize(sourceSize)
+    , m_level(level)
+{
+    setAutoDelete(true);
+}
+
+void ImageLevelWorker::run()
+{
+    if (!ImageTileLoader::instance()->isLevelWanted(ImageTileLoader::makeLevelKey(m_filePath, m_level))) {
+        Q_EMIT levelDecoded(m_filePath, m_level, QVector<QImage>(), true);
+        return;
+    }
+
+    // Decode at level size where the codec can
+    const QSize levelSize = ImageTileLoader::levelSize(m_sourceSize, m_level);
+    QImageReader reader(m_filePath);
+    reader.setAutoTransform(true);
+    QSize decodeSize = reader.size();
+    if (m_level > 0 && reader.supportsOption(QImageIOHandler::ScaledSize)) {
+        decodeSize = levelSize;
+        if (reader.transformation() & QImageIOHandler::TransformationRotate90) {
+            decodeSize.transpose();
+        }
+        reader.setScaledSize(decodeSize);
+    }
+    const qint64 decodeMiB = qint64(decodeSize.width()) * decodeSize.height() * 4 / (1024 * 1024) + 1;
+    if (reader.allocationLimit() > 0 && decodeMiB > reader.allocationLimit()) {
+        reader.setAllocationLimit(int(qMin<qint64>(decodeMiB, MaxLevelDecodeMiB)));
+    }
+
+    QImage image = reader.read();
+    QVector<QImage> tiles;
+    if (image.isNull()) {
+        qWarning() << "ImageTileLoader: failed to decode level" << m_level << "of" << m_filePath
+                   << reader.errorString();
+    } else {
+        if (image.size() != levelSize) {
+            image = image.scaled(levelSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+        const int columns = (levelSize.width() + ImageTileLoader::TileSize - 1) / ImageTileLoader::TileSize;
+        const int rows = (levelSize.height() + ImageTileLoader::TileSize - 1) / ImageTileLoader::TileSize;
+        tiles.reserve(columns * rows);
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < columns; ++col) {
+                tiles.append(image.copy(ImageTileLoader::tileRect(m_sourceSize, m_level, QPoint(col, row))));
+            }
+        }
+    }
+    Q_EMIT levelDecoded(m_filePath, m_level, tiles, false);
+}
+
+// ============== ImageTileLoader ==============
+
+ImageTileLoader* ImageTileLoader::instance()
+{
+    if (!s_instance) {
+        s_instance = new ImageTileLoader();
+    }
+    return s_instance;
+}
+
+void ImageTileLoader::cleanup()
+{
+    delete s_instance;
+    s_instance = nullptr;
+}
+
+ImageTileLoader::ImageTileLoader(QObject* parent)
+    : QObject(parent)
+    , m_threadPool(new QThreadPool(this))
+    , m_cache(CacheBudgetKiB)
+{
+    m_threadPool->setMaxThreadCount(qMax(2, QThread::idealThreadCount() / 2));
+}
+
+ImageTileLoader::~ImageTileLoader()
+{
+    cancel();
+    m_threadPool->clear();
+    m_threadPool->waitForDone();
+}
+
+ImageTileLoader::ImageInfo ImageTileLoader::imageInfo(const QString& filePath)
+{
+    auto it = m_infoCache.constFind(filePath);
+    if (it != m_infoCache.constEnd()) {
+        return it.value();
+    }
+
+    ImageInfo info;
+    QImageReader reader(filePath);
+    reader.setAutoTransform(true);
+    info.size = reader.size();
+    if (info.size.isValid()) {
+        info.transformation = reader.transformation();
+        if (info.transformation & QImageIOHandler::TransformationRotate90) {
+            info.size.transpose();
+        }
+        // Rotated files too: the worker maps each tile back to stored pixels
+        info.regionDecode = reader.supportsOption(QImageIOHandler::ClipRect) &&
+                            reader.supportsOption(QImageIOHandler::ScaledSize);
+    }
+
+    m_infoCache.insert(filePath, info);
+    return info;
+}
+
+QSize ImageTileLoader::levelSize(const QSize& sourceSize, int level)
+{
+    const int scale = 1 << level;
+    return QSize(qMax(1, (sourceSize.width() + scale - 1) / scale),
+                 qMax(1, (sourceSize.height() + scale - 1) / scale));
+}
+
+QRect ImageTileLoader::tileRect(const QSize& sourceSize, int level, const QPoint& tile)
+{
+    const QRect tileBounds(tile.x() * TileSize, tile.y() * TileSize, TileSize, TileSize);
+    return tileBounds & QRect(QPoint(0, 0), levelSize(sourceSize, level));
+}
+
+int ImageTileLoader::levelForScale(qreal scale)
+{
+    if (scale <= 0.0 || scale >= 1.0) {
+        return 0;
+    }
+    return qMax(0, qFloor(std::log2(1.0 / scale)));
+}
+
+QString ImageTileLoader::makeTileKey(const QString& filePath, int level, const QPoint& tile)
+{
+    return QString("%1@L%2:%3,%4").arg(filePath).arg(level).arg(tile.x()).arg(tile.y());
+}
+
+QString ImageTileLoader::makeLevelKey(const QString& filePath, int level)
+{
+    return QString("%1@L%2").arg(filePath).arg(level);
+}
+
+bool ImageTileLoader::isWanted(const QString& tileKey) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_wanted.contains(tileKey);
+}
+
+bool ImageTileLoader::isLevelWanted(const QString& levelKey) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_wantedLevel == levelKey;
+}
+
+bool ImageTileLoader::find(const QString& filePath, int level, const QPoint& tile, QPixmap& pixmap)
+{
+    const QString key = makeTileKey(filePath, level, tile);
+    if (const QPixmap* cached = m_cache.object(key)) {
+        pixmap = *cached;
+        return true;
+    }
+
+    // Tiles of a whole-level decode are uploaded on first paint
+    auto it = m_levels.constFind(makeLevelKey(filePath, level));
+    if (it == m_levels.constEnd() || tile.x() < 0 || tile.y() < 0 || tile.x() >= it->columns) {
+        return false;
+    }
+    const int index = tile.y() * it->columns + tile.x();
+    if (index >= it->tiles.size()) {
+        return false;
+    }
+    pixmap = QPixmap::fromImage(it->tiles.at(index));
+    insertPixmap(key, pixmap);
+    return true;
+}
+
+void ImageTileLoader::insertPixmap(const QString& tileKey, const QPixmap& pixmap)
+{
+    const int cost = int(qMax<qint64>(1, qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8 / 1024));
+    m_cache.insert(tileKey, new QPixmap(pixmap), cost);
+}
+
+void ImageTileLoader::request(const QString& filePath, int level, const QVector<QPoint>& tiles)
+{
+    const ImageInfo info = imageInfo(filePath);
+    if (!info.isValid()) {
+        return;
+    }
+
+    const QString levelKey = makeLevelKey(filePath, level);
+    QVector<QPoint> missing;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_wanted.clear();
+        m_wantedLevel = levelKey;
+        for (const QPoint& tile : tiles) {
+            const QString key = makeTileKey(filePath, level, tile);
+            m_wanted.insert(key);
+            if (!m_pending.contains(key) && !m_cache.contains(key)) {
+                missing.append(tile);
+            }
+        }
+    }
+
+    if (missing.isEmpty()) {
+        return;
+    }
+    if (info.regionDecode) {
+        schedule(filePath, info, level, missing);
+    } else if (!m_levels.contains(levelKey)) {
+        scheduleLevel(filePath, info, level);
+    }
+}
+
+void ImageTileLoader::schedule(const QString& filePath, const ImageInfo& info, int level,
+                               const QVector<QPoint>& tiles)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QPoint& tile : tiles) {
+            m_pending.insert(makeTileKey(filePath, level, tile));
+        }
+    }
+
+    // Independent tiles: one worker each so they decode in parallel, in
+    // the order given (the view puts the centre first)
+    for (const QPoint& tile : tiles) {
+        ImageTileWorker* worker = new ImageTileWorker(filePath, info.size, info.transformation, level, {tile});
+        connect(worker, &ImageTileWorker::tileDecoded,
+                this, &ImageTileLoader::slotTileDecoded,
+                Qt::QueuedConnection);
+        m_threadPool->start(worker);
+    }
+}
+
+void ImageTileLoader::scheduleLevel(const QString& filePath, const ImageInfo& info, int level)
+{
+    const QString levelKey = makeLevelKey(filePath, level);
+    if (m_pendingLevels.contains(levelKey) || m_failedLevels.contains(levelKey)) {
+        return;
+    }
+    releaseLevels(filePath);
+    m_pendingLevels.insert(levelKey);
+
+    ImageLevelWorker* worker = new ImageLevelWorker(filePath, info.size, level);
+    connect(worker, &ImageLevelWorker::levelDecoded,
+            this, &ImageTileLoader::slotLevelDecoded,
+            Qt::QueuedConnection);
+    m_threadPool->start(worker);
+}
+
+void ImageTileLoader::cancel()
+{
+    QMutexLocker locker(&m_mutex);
+    m_wanted.clear();
+    m_wantedLevel.clear();
+}
+
+void ImageTileLoader::releaseLevels(const QString& keepFilePath)
+{
+    if (keepFilePath == m_levelsFile) {
+        return;
+    }
+    // Decodes still running for the old file are dropped when they finish
+    m_levels.clear();
+    m_levelBytes = 0;
+    m_levelsFile = keepFilePath;
+}
+
+void ImageTileLoader::trimLevels(int keepLevel)
+{
+    // Furthest from the level in view first
+    while (m_levelBytes > LevelBudgetBytes && m_levels.size() > 1) {
+        auto victim = m_levels.end();
+        for (auto it = m_levels.begin(); it != m_levels.end(); ++it) {
+            if (it->level != keepLevel &&
+                (victim == m_levels.end() || qAbs(it->level - keepLevel) > qAbs(victim->level - keepLevel))) {
+                victim = it;
+            }
+        }
+        m_levelBytes -= victim->bytes;
+        m_levels.erase(victim);
+    }
+}
+
+void ImageTileLoader::slotTileDecoded(const QString& filePath, int level, const QPoint& tile,
+                                      const QImage& image, bool skipped)
+{
+    const QString key = makeTileKey(filePath, level, tile);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending.remove(key);
+    }
+
+    if (skipped) {
+        // Dropped while queued, but panned back into view since
+        if (isWanted(key)) {
+            schedule(filePath, imageInfo(filePath), level, {tile});
+        }
+        return;
+    }
+
+    if (image.isNull()) {
+        return;   // The view keeps showing the scaled preview here
+    }
+
+    insertPixmap(key, QPixmap::fromImage(image));
+    Q_EMIT tileReady(filePath, level, tile);
+}
+
+void ImageTileLoader::slotLevelDecoded(const QString& filePath, int level, const QVector<QImage>& tiles,
+                                       bool skipped)
+{
+    const QString levelKey = makeLevelKey(filePath, level);
+    m_pendingLevels.remove(levelKey);
+
+    if (skipped) {
+        if (isLevelWanted(levelKey)) {
+            scheduleLevel(filePath, imageInfo(filePath), level);
+        }
+        return;
+    }
+    if (tiles.isEmpty()) {
+        // Retrying on every pan step would repeat the whole decode
+        m_failedLevels.insert(levelKey);
+        return;
+    }
+    if (filePath != m_levelsFile) {
+        return;   // The view moved on to another image
+    }
+
+    DecodedLevel decoded;
+    decoded.level = level;
+    decoded.columns = (levelSize(imageInfo(filePath).size, level).width() + TileSize - 1) / TileSize;
+    decoded.tiles = tiles;
+    for (const QImage& tile : tiles) {
+        decoded.bytes += tile.sizeInBytes();
+    }
+    m_levelBytes += decoded.bytes;
+    m_levels.insert(levelKey, decoded);
+    trimLevels(level);
+
+    // Repaint whichever of its tiles are in view
+    QVector<QPoint> ready;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (int index = 0; index < tiles.size(); ++index) {
+            const QPoint tile(index % decoded.columns, index / decoded.columns);
+            if (m_wanted.contains(makeTileKey(filePath, level, tile))) {
+                ready.append(tile);
+            }
+        }
+    }
+    for (const QPoint& tile : ready) {
+        Q_EMIT tileReady(filePath, level, tile);
+    }
+}
+
+void ImageTileLoader::clear()
+{
+    m_cache.clear();
+    m_infoCache.clear();
+    m_levels.clear();
+    m_levelBytes = 0;
+    m_failedLevels.clear();
+}
+
+void ImageTileLoader::reportMemory(MemoryReport& report) const
+{
+    QSet<QString> wanted;
+    {
+        QMutexLocker locker(&m_mutex);
+        wanted = m_wanted;
+    }
+
+    // QCache has no peek: object() makes each entry the most recent, so
+    // the tiles in view are looked up last to stay that way
+    const QStringList keys = m_cache.keys();
+    qint64 bytes = MemoryReport::hashBytes(keys.size(), sizeof(QString) + sizeof(QPixmap));
+    for (const QString& key : keys) {
+        if (!wanted.contains(key)) {
+            bytes += MemoryReport::stringBytes(key) + report.pixmapBytes(*m_cache.object(key));
+        }
+    }
+    for (const QString& key : wanted) {
+        if (const QPixmap* pixmap = m_cache.object(key)) {
+            bytes += MemoryReport::stringBytes(key) + report.pixmapBytes(*pixmap);
+        }
+    }
+    report.add("Image tile cache", bytes, keys.size());
+
+    qint64 levelBytes = 0;
+    qint64 levelTiles = 0;
+    for (const DecodedLevel& decoded : m_levels) {
+        for (const QImage& tile : decoded.tiles) {
+            levelBytes += report.imageBytes(tile);
+        }
+        levelTiles += decoded.tiles.size();
+    }
+    report.add("Image tile levels", levelBytes, levelTiles);
+}
+
+} // namespace FullFrame
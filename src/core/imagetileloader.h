@@ -0,0 +1,201 @@
+/**
+ * ImageTileLoader - Multi-resolution tiles for zooming into large images
+ *
+ * The fit-to-window preview comes from PreviewLoader; this supplies the
+ * detail once the user zooms past it. An image is treated as a pyramid of
+ * levels, level L being the source scaled by 1/2^L, each cut into
+ * TileSize x TileSize tiles:
+ * - Codecs that decode regions (JPEG via libjpeg clip + scaled decode)
+ *   produce each tile straight from the file, so a 20000x15000 panorama
+ *   never has to exist in memory as a whole. EXIF-rotated files stay on
+ *   this path: tile rects are mapped back to stored pixels and each
+ *   decoded tile is oriented on its own
+ * - Other codecs decode a level once per file, cut all of its tiles and
+ *   keep them while the view shows that file. At most one decode per
+ *   level is in flight, however many requests arrive meanwhile
+ * - Tile pixmaps live in a byte-bounded LRU on the GUI thread; only the
+ *   tiles currently in view are requested, and queued tiles that have
+ *   scrolled out of view are skipped
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QImageIOHandler>
+#include <QMutex>
+#include <QPixmap>
+#include <QPoint>
+#include <QRect>
+#include <QRunnable>
+#include <QSet>
+#include <QSize>
+#include <QVector>
+
+class QThreadPool;
+
+namespace FullFrame {
+
+class MemoryReport;
+
+/**
+ * Worker decoding tiles of one pyramid level straight from the file
+ * (region-decodable codecs only)
+ */
+class ImageTileWorker : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    ImageTileWorker(const QString& filePath, const QSize& sourceSize,
+                    QImageIOHandler::Transformations transformation,
+                    int level, const QVector<QPoint>& tiles);
+    void run() override;
+
+Q_SIGNALS:
+    // Emitted once per tile. `skipped` is set when the tile left the view
+    // before it was decoded; a null image otherwise means decoding failed
+    void tileDecoded(const QString& filePath, int level, const QPoint& tile,
+                     const QImage& image, bool skipped);
+
+private:
+    QString m_filePath;
+    QSize m_sourceSize;
+    QImageIOHandler::Transformations m_transformation;
+    int m_level;
+    QVector<QPoint> m_tiles;
+};
+
+/**
+ * Worker decoding a whole pyramid level and cutting it into tiles
+ * (codecs without region decode)
+ */
+class ImageLevelWorker : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    ImageLevelWorker(const QString& filePath, const QSize& sourceSize, int level);
+    void run() override;
+
+Q_SIGNALS:
+    // All tiles of the level, row by row; empty when decoding failed.
+    // `skipped` is set when the level was no longer wanted at the start
+    void levelDecoded(const QString& filePath, int level, const QVector<QImage>& tiles, bool skipped);
+
+private:
+    QString m_filePath;
+    QSize m_sourceSize;
+    int m_level;
+};
+
+/**
+ * Tile decoding/cache manager
+ * Singleton - use instance() to access
+ */
+class ImageTileLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int TileSize = 512;
+
+    struct ImageInfo
+    {
+        QSize size;                 // Displayed (auto-transformed) size
+        bool regionDecode = false;  // Tiles can be decoded individually
+        QImageIOHandler::Transformations transformation = QImageIOHandler::TransformationNone;
+        bool isValid() const { return size.isValid(); }
+    };
+
+    static ImageTileLoader* instance();
+    static bool hasInstance() { return s_instance; }
+    static void cleanup();
+
+    // Reads (and remembers) the header of filePath
+    ImageInfo imageInfo(const QString& filePath);
+
+    // Geometry of a pyramid level
+    static QSize levelSize(const QSize& sourceSize, int level);
+    static QRect tileRect(const QSize& sourceSize, int level, const QPoint& tile);   // Level coords
+    static int levelForScale(qreal scale);   // Coarsest level with at least `scale` resolution
+
+    bool find(const QString& filePath, int level, const QPoint& tile, QPixmap& pixmap);
+
+    // Make `tiles` of `level` the wanted set for filePath, scheduling the
+    // ones not cached. Tiles wanted by an earlier call are dropped.
+    void request(const QString& filePath, int level, const QVector<QPoint>& tiles);
+
+    // Drop the wanted set (e.g. when the view switches images)
+    void cancel();
+
+    // Drop the decoded levels of every file but keepFilePath
+    void releaseLevels(const QString& keepFilePath = QString());
+
+    void clear();
+
+    // Tile pixmaps and decoded levels
+    void reportMemory(MemoryReport& report) const;
+
+Q_SIGNALS:
+    void tileReady(const QString& filePath, int level, const QPoint& tile);
+
+private Q_SLOTS:
+    void slotTileDecoded(const QString& filePath, int level, const QPoint& tile,
+                         const QImage& image, bool skipped);
+    void slotLevelDecoded(const QString& filePath, int level, const QVector<QImage>& tiles, bool skipped);
+
+private:
+    struct DecodedLevel
+    {
+        int level = 0;
+        int columns = 0;
+        QVector<QImage> tiles;   // Row by row
+        qint64 bytes = 0;
+    };
+
+    explicit ImageTileLoader(QObject* parent = nullptr);
+    ~ImageTileLoader() override;
+
+    // Disable copy
+    ImageTileLoader(const ImageTileLoader&) = delete;
+    ImageTileLoader& operator=(const ImageTileLoader&) = delete;
+
+    static QString makeTileKey(const QString& filePath, int level, const QPoint& tile);
+    static QString makeLevelKey(const QString& filePath, int level);
+    bool isWanted(const QString& tileKey) const;
+    bool isLevelWanted(const QString& levelKey) const;
+    void schedule(const QString& filePath, const ImageInfo& info, int level, const QVector<QPoint>& tiles);
+    void scheduleLevel(const QString& filePath, const ImageInfo& info, int level);
+    void insertPixmap(const QString& tileKey, const QPixmap& pixmap);
+    void trimLevels(int keepLevel);
+
+    friend class ImageTileWorker;
+    friend class ImageLevelWorker;
+
+private:
+    static ImageTileLoader* s_instance;
+
+    QThreadPool* m_threadPool;
+
+    // Cost is in KiB of pixmap memory (GUI thread only)
+    QCache<QString, QPixmap> m_cache;
+    QHash<QString, ImageInfo> m_infoCache;
+
+    // Whole-level decodes of m_levelsFile, by level key (GUI thread only)
+    QString m_levelsFile;
+    QHash<QString, DecodedLevel> m_levels;
+    qint64 m_levelBytes = 0;
+    QSet<QString> m_pendingLevels;
+    QSet<QString> m_failedLevels;   // Not retried until clear()
+
+    // Tile keys queued or decoding, and the tiles/level currently in view
+    mutable QMutex m_mutex;
+    QSet<QString> m_pending;
+    QSet<QString> m_wanted;
+    QString m_wantedLevel;
+};
+
+} // namespace FullFrame
@@ -0,0 +1,34 @@
+/**
+ * MediaScanner implementation
+ */
+
+#include "mediascanner.h"
+#include "thumbnailcreator.h"
+#include "eventtrace.h"
+
+#include <QDir>
+#include <QDirIterator>
+
+namespace FullFrame {
+
+QFileInfoList MediaScanner::scan(const QString& path, bool recursive)
+{
+    EventTrace::Span span("listMediaFiles", "scan");
+    QFileInfoList files;
+
+    QDir::Filters filters = QDir::Files | QDir::Readable;
+    QDirIterator::IteratorFlags flags = recursive ?
+        QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags;
+
+    QDirIterator it(path, filters, flags);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        if (ThumbnailCreator::isMediaFile(info.filePath())) {
+            files.append(info);
+        }
+    }
+    return files;
+}
+
+} // namespace FullFrame
@@ -0,0 +1,22 @@
+/**
+ * MediaScanner - Lists the media files in a folder
+ *
+ * Shared by the thumbnail model and the command-line tool so both see the
+ * same set of files. Filesystem only: no tags, no thumbnails.
+ */
+
+#pragma once
+
+#include <QFileInfoList>
+#include <QString>
+
+namespace FullFrame {
+
+class MediaScanner
+{
+public:
+    // Readable files ThumbnailCreator can handle, in directory order
+    static QFileInfoList scan(const QString& path, bool recursive);
+};
+
+} // namespace FullFrame
@@ -0,0 +1,175 @@
+/**
+ * MemoryReport implementation
+ */
+
+#include "memoryreport.h"
+
+#include <QFile>
+#include <QImage>
+#include <QJsonArray>
+#include <QLocale>
+#include <QPixmap>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_WIN
+#include <Windows.h>
+#include <psapi.h>
+#endif
+
+namespace FullFrame {
+
+namespace {
+// Per-node bookkeeping of QHash/QSet spans (offset byte, growth slack)
+constexpr qint64 HashEntryOverhead = 8;
+
+// QArrayData header in front of every string's characters
+constexpr qint64 StringHeaderBytes = 16;
+
+QString formatBytes(qint64 bytes)
+{
+    return QLocale::c().formattedDataSize(bytes, 1, QLocale::DataSizeTraditionalFormat);
+}
+
+QString formatChange(qint64 delta)
+{
+    if (delta == 0) {
+        return QStringLiteral("0");
+    }
+    return (delta > 0 ? QStringLiteral("+") : QStringLiteral("-")) + formatBytes(qAbs(delta));
+}
+}
+
+void MemoryReport::add(const QString& name, qint64 bytes, qint64 entries)
+{
+    m_rows.append({ name, bytes, entries });
+}
+
+qint64 MemoryReport::imageBytes(const QImage& image)
+{
+    if (image.isNull() || m_seenImages.contains(image.cacheKey())) {
+        return 0;
+    }
+    m_seenImages.insert(image.cacheKey());
+    return image.sizeInBytes();
+}
+
+qint64 MemoryReport::pixmapBytes(const QPixmap& pixmap)
+{
+    if (pixmap.isNull() || m_seenPixmaps.contains(pixmap.cacheKey())) {
+        return 0;
+    }
+    m_seenPixmaps.insert(pixmap.cacheKey());
+    return qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
+qint64 MemoryReport::stringBytes(const QString& string)
+{
+    return string.isNull() ? 0 : StringHeaderBytes + qint64(string.capacity()) * qint64(sizeof(QChar));
+}
+
+qint64 MemoryReport::hashBytes(qint64 entries, qint64 nodeSize)
+{
+    return entries * (nodeSize + HashEntryOverhead);
+}
+
+qint64 MemoryReport::residentBytes()
+{
+#if defined(Q_OS_LINUX)
+    // Second field of statm: resident pages
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (statm.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() > 1) {
+            return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+    return -1;
+#elif defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return qint64(counters.WorkingSetSize);
+    }
+    return -1;
+#else
+    return -1;
+#endif
+}
+
+qint64 MemoryReport::totalBytes() const
+{
+    qint64 total = 0;
+    for (const Row& row : m_rows) {
+        total += row.bytes;
+    }
+    return total;
+}
+
+QHash<QString, qint64> MemoryReport::bytesByRow() const
+{
+    QHash<QString, qint64> result;
+    for (const Row& row : m_rows) {
+        result.insert(row.name, row.bytes);
+    }
+    return result;
+}
+
+QString MemoryReport::toText(const QHash<QString, qint64>& previous) const
+{
+    const bool showChange = !previous.isEmpty();
+    auto line = [&](const QString& name, const QString& entries, qint64 bytes, const QString& change) {
+        QString text = QString("%1 %2 %3").arg(name, -40).arg(entries, 9).arg(formatBytes(bytes), 11);
+        if (showChange) {
+            text += QString(" %1").arg(change, 11);
+        }
+        return text + '\n';
+    };
+
+    QString text = QString("%1 %2 %3").arg(QStringLiteral("Subsystem"), -40)
+                       .arg(QStringLiteral("Entries"), 9).arg(QStringLiteral("Size"), 11);
+    if (showChange) {
+        text += QString(" %1").arg(QStringLiteral("Change"), 11);
+    }
+    text += '\n';
+
+    for (const Row& row : m_rows) {
+        const QString change = previous.contains(row.name)
+            ? formatChange(row.bytes - previous.value(row.name)) : QStringLiteral("new");
+        text += line(row.name, row.entries >= 0 ? QString::number(row.entries) : QString(),
+                     row.bytes, change);
+    }
+
+    const qint64 total = totalBytes();
+    text += '\n' + line(QStringLiteral("Accounted"), QString(), total, QString());
+    const qint64 resident = residentBytes();
+    if (resident >= 0) {
+        text += line(QStringLiteral("Process resident"), QString(), resident, QString());
+        text += line(QStringLiteral("Not accounted (code, heap slack, GPU...)"), QString(),
+                     qMax<qint64>(0, resident - total), QString());
+    }
+    return text;
+}
+
+QJsonObject MemoryReport::toJson() const
+{
+    QJsonArray rows;
+    for (const Row& row : m_rows) {
+        QJsonObject entry;
+        entry["name"] = row.name;
+        entry["bytes"] = row.bytes;
+        if (row.entries >= 0) {
+            entry["entries"] = row.entries;
+        }
+        rows.append(entry);
+    }
+
+    QJsonObject result;
+    result["rows"] = rows;
+    result["accountedBytes"] = totalBytes();
+    result["residentBytes"] = residentBytes();
+    return result;
+}
+
+} // namespace FullFrame
@@ -0,0 +1,71 @@
+/**
+ * MemoryReport - Bytes held by each subsystem, for finding what grows
+ *
+ * Subsystems add their own rows through reportMemory(MemoryReport&); the
+ * caller picks which subsystems take part (the app has views and loaders,
+ * the command-line tool only the database). Taking two reports a while
+ * apart and comparing them (toText(previous)) shows which row keeps
+ * climbing.
+ *
+ * Sizes are estimates: pixel data from sizeInBytes() and pixmap depth,
+ * containers from their entry counts plus a per-entry overhead, strings
+ * from their capacity. Implicitly shared QImage/QPixmap data is counted
+ * once, by the first row that reports it, so owners (the caches) should
+ * report before borrowers (model items). The process resident size is
+ * included so what the rows don't explain is visible too.
+ *
+ * GUI thread only.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QJsonObject>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+class QImage;
+class QPixmap;
+
+namespace FullFrame {
+
+class MemoryReport
+{
+public:
+    struct Row
+    {
+        QString name;
+        qint64 bytes = 0;
+        qint64 entries = -1;   // -1 = not a count of anything
+    };
+
+    void add(const QString& name, qint64 bytes, qint64 entries = -1);
+
+    // Pixel bytes not already counted in this report
+    qint64 imageBytes(const QImage& image);
+    qint64 pixmapBytes(const QPixmap& pixmap);
+
+    static qint64 stringBytes(const QString& string);
+    // Hash/set storage for `entries` nodes of `nodeSize` bytes
+    static qint64 hashBytes(qint64 entries, qint64 nodeSize);
+
+    // Resident set size of the process, or -1 where unsupported
+    static qint64 residentBytes();
+
+    const QVector<Row>& rows() const { return m_rows; }
+    qint64 totalBytes() const;
+    QHash<QString, qint64> bytesByRow() const;
+
+    // Table of the rows; with `previous` (bytesByRow() of an earlier
+    // report) a column shows how each row changed since
+    QString toText(const QHash<QString, qint64>& previous = QHash<QString, qint64>()) const;
+    QJsonObject toJson() const;
+
+private:
+    QVector<Row> m_rows;
+    QSet<qint64> m_seenImages;
+    QSet<qint64> m_seenPixmaps;
+};
+
+} // namespace FullFrame
@@ -0,0 +1,61 @@
+/**
+ * PerfCounters implementation
+ */
+
+#include "perfcounters.h"
+
+namespace FullFrame {
+
+std::atomic<int> PerfCounters::s_users{0};
+std::atomic<qint64> PerfCounters::s_values[PerfCounters::CounterCount] = {};
+
+PerfCounters::Snapshot PerfCounters::Snapshot::operator-(const Snapshot& earlier) const
+{
+    Snapshot delta;
+    for (int i = 0; i < CounterCount; ++i) {
+        delta.values[i] = values[i] - earlier.values[i];
+    }
+    return delta;
+}
+
+void PerfCounters::acquire()
+{
+    s_users.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfCounters::release()
+{
+    s_users.fetch_sub(1, std::memory_order_relaxed);
+}
+
+qint64 PerfCounters::value(Counter counter)
+{
+    return s_values[counter].load(std::memory_order_relaxed);
+}
+
+PerfCounters::Snapshot PerfCounters::snapshot()
+{
+    Snapshot result;
+    for (int i = 0; i < CounterCount; ++i) {
+        result.values[i] = s_values[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+const char* PerfCounters::name(Counter counter)
+{
+    switch (counter) {
+        case PixmapCacheHit:  return "pixmapCacheHits";
+        case PixmapCacheMiss: return "pixmapCacheMisses";
+        case ImageCacheHit:   return "imageCacheHits";
+        case ImageCacheMiss:  return "imageCacheMisses";
+        case PixmapFromImage: return "fromImageConversions";
+        case TilesPainted:    return "tilesPainted";
+        case LoadsScheduled:  return "loadsScheduled";
+        case LoadsCompleted:  return "loadsCompleted";
+        case CounterCount:    break;
+    }
+    return "unknown";
+}
+
+} // namespace FullFrame
@@ -0,0 +1,68 @@
+/**
+ * PerfCounters - Process-wide instrumentation counters
+ *
+ * The thumbnail cache, the loader and the delegates bump these counters;
+ * diagnostics (the frame-stats HUD) read them as per-frame deltas.
+ * Counting is off unless at least one consumer has called acquire(), and
+ * while off every hook is a single relaxed load and a not-taken branch.
+ */
+
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+
+namespace FullFrame {
+
+class PerfCounters
+{
+public:
+    enum Counter {
+        PixmapCacheHit,
+        PixmapCacheMiss,
+        ImageCacheHit,
+        ImageCacheMiss,
+        PixmapFromImage,    // QPixmap::fromImage() conversions on the GUI thread
+        TilesPainted,       // Delegate paint() calls
+        LoadsScheduled,
+        LoadsCompleted,
+        CounterCount
+    };
+
+    /**
+     * Plain copy of every counter at one instant
+     */
+    struct Snapshot
+    {
+        qint64 values[CounterCount] = {};
+
+        qint64 operator[](Counter counter) const { return values[counter]; }
+        Snapshot operator-(const Snapshot& earlier) const;
+    };
+
+    static bool isEnabled()
+    {
+        return s_users.load(std::memory_order_relaxed) > 0;
+    }
+
+    static void add(Counter counter, qint64 amount = 1)
+    {
+        if (isEnabled()) {
+            s_values[counter].fetch_add(amount, std::memory_order_relaxed);
+        }
+    }
+
+    // Reference-counted enable: counting stays on while any consumer holds it
+    static void acquire();
+    static void release();
+
+    static qint64 value(Counter counter);
+    static Snapshot snapshot();
+    static const char* name(Counter counter);
+
+private:
+    static std::atomic<int> s_users;
+    static std::atomic<qint64> s_values[CounterCount];
+};
+
+} // namespace FullFrame
@@ -0,0 +1,248 @@
+/**
+ * PreviewLoader implementation
+ */
+
+#include "previewloader.h"
+#include "memoryreport.h"
+
+#include <QImageReader>
+#include <QThreadPool>
+#include <QDebug>
+
+namespace FullFrame {
+
+PreviewLoader* PreviewLoader::s_instance = nullptr;
+
+namespace {
+constexpr int CacheBudgetKiB = 128 * 1024;   // ~20 screen-sized previews
+constexpr int CurrentPriority = 1;
+constexpr int PrefetchPriority = 0;
+}
+
+// ============== PreviewWorker ==============
+
+PreviewWorker::PreviewWorker(const QString& filePath, const QSize& boundingSize)
+    : m_filePath(filePath)
+    , m_boundingSize(boundingSize)
+{
+    setAutoDelete(true);
+}
+
+void PreviewWorker::run()
+{
+    // The user may have moved on while this sat in the queue
+    if (!PreviewLoader::instance()->isWanted(m_filePath)) {
+        Q_EMIT finished(m_filePath, m_boundingSize, QImage(), true);
+        return;
+    }
+    Q_EMIT finished(m_filePath, m_boundingSize, decode(m_filePath, m_boundingSize), false);
+}
+
+QImage PreviewWorker::decode(const QString& filePath, const QSize& boundingSize)
+{
+    QImageReader reader(filePath);
+    reader.setAutoTransform(true);
+
+    // QImageReader::size() is pre-rotation; swap for 90° EXIF orientations so
+    // the fitted size matches what read() returns
+    QSize sourceSize = reader.size();
+    if (sourceSize.isValid() && (reader.transformation() & QImageIOHandler::TransformationRotate90)) {
+        sourceSize.transpose();
+    }
+
+    if (sourceSize.isValid() &&
+        (sourceSize.width() > boundingSize.width() || sourceSize.height() > boundingSize.height())) {
+        QSize scaled = sourceSize.scaled(boundingSize, Qt::KeepAspectRatio);
+        if (reader.transformation() & QImageIOHandler::TransformationRotate90) {
+            scaled.transpose();
+        }
+        reader.setScaledSize(scaled);
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "PreviewLoader: failed to decode" << filePath << reader.errorString();
+    }
+    return image;
+}
+
+// ============== PreviewLoader ==============
+
+PreviewLoader* PreviewLoader::instance()
+{
+    if (!s_instance) {
+        s_instance = new PreviewLoader();
+    }
+    return s_instance;
+}
+
+void PreviewLoader::cleanup()
+{
+    delete s_instance;
+    s_instance = nullptr;
+}
+
+PreviewLoader::PreviewLoader(QObject* parent)
+    : QObject(parent)
+    , m_threadPool(new QThreadPool(this))
+    , m_cache(CacheBudgetKiB)
+{
+    // Two decoders: the current image plus one prefetch at a time keeps
+    // the thumbnail pool's cores free
+    m_threadPool->setMaxThreadCount(2);
+}
+
+PreviewLoader::~PreviewLoader()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_wanted.clear();
+    }
+    m_threadPool->clear();
+    m_threadPool->waitForDone();
+}
+
+bool PreviewLoader::covers(const Entry& entry, const QSize& boundingSize)
+{
+    if (entry.image.isNull()) {
+        return false;
+    }
+    if (entry.boundingSize.width() >= boundingSize.width() &&
+        entry.boundingSize.height() >= boundingSize.height()) {
+        return true;
+    }
+    // Smaller than the box it was decoded for on both axes means it is
+    // the full-resolution image; a larger request can't do better
+    return entry.image.width() < entry.boundingSize.width() &&
+           entry.image.height() < entry.boundingSize.height();
+}
+
+bool PreviewLoader::find(const QString& filePath, const QSize& boundingSize, QImage& image)
+{
+    const Entry* entry = m_cache.object(filePath);
+    if (!entry || !covers(*entry, boundingSize)) {
+        return false;
+    }
+    image = entry->image;
+    return true;
+}
+
+void PreviewLoader::request(const QString& filePath, const QSize& boundingSize,
+                            const QStringList& prefetchPaths)
+{
+    if (boundingSize.isEmpty()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_wanted.clear();
+        if (!filePath.isEmpty()) {
+            m_wanted.insert(filePath);
+        }
+        for (const QString& path : prefetchPaths) {
+            m_wanted.insert(path);
+        }
+    }
+
+    m_currentPath = filePath;
+    m_currentSize = boundingSize;
+
+    if (!filePath.isEmpty()) {
+        QImage cached;
+        if (find(filePath, boundingSize, cached)) {
+            Q_EMIT previewReady(filePath, cached);
+        } else {
+            schedule(filePath, boundingSize, CurrentPriority);
+        }
+    }
+
+    for (const QString& path : prefetchPaths) {
+        const Entry* entry = m_cache.object(path);
+        if (!entry || !covers(*entry, boundingSize)) {
+            schedule(path, boundingSize, PrefetchPriority);
+        }
+    }
+}
+
+void PreviewLoader::schedule(const QString& filePath, const QSize& boundingSize, int priority)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_pending.contains(filePath)) {
+            return;
+        }
+        m_pending.insert(filePath);
+    }
+
+    PreviewWorker* worker = new PreviewWorker(filePath, boundingSize);
+    connect(worker, &PreviewWorker::finished,
+            this, &PreviewLoader::slotWorkerFinished,
+            Qt::QueuedConnection);
+    m_threadPool->start(worker, priority);
+}
+
+bool PreviewLoader::isWanted(const QString& filePath) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_wanted.contains(filePath);
+}
+
+void PreviewLoader::slotWorkerFinished(const QString& filePath, const QSize& boundingSize,
+                                       const QImage& image, bool skipped)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending.remove(filePath);
+    }
+
+    if (skipped) {
+        // Dropped while queued, but the user has come back to it since
+        if (filePath == m_currentPath) {
+            schedule(filePath, m_currentSize, CurrentPriority);
+        } else if (isWanted(filePath)) {
+            schedule(filePath, m_currentSize, PrefetchPriority);
+        }
+        return;
+    }
+
+    if (image.isNull()) {
+        Q_EMIT previewFailed(filePath);
+        return;
+    }
+
+    const int cost = int(qMax<qint64>(1, image.sizeInBytes() / 1024));
+    const Entry entry{image, boundingSize};
+    m_cache.insert(filePath, new Entry(entry), cost);
+    Q_EMIT previewReady(filePath, image);
+
+    // Pending decodes are tracked by path, so a request at a larger size
+    // made while this one ran was dropped; show this one meanwhile
+    if (filePath == m_currentPath && !covers(entry, m_currentSize)) {
+        schedule(filePath, m_currentSize, CurrentPriority);
+    }
+}
+
+void PreviewLoader::clear()
+{
+    m_cache.clear();
+}
+
+void PreviewLoader::reportMemory(MemoryReport& report) const
+{
+    // QCache has no peek: object() makes each entry the most recent, so
+    // the preview in view is looked up last to stay that way
+    const QStringList keys = m_cache.keys();
+    qint64 bytes = MemoryReport::hashBytes(keys.size(), sizeof(QString) + sizeof(Entry));
+    for (const QString& key : keys) {
+        if (key != m_currentPath) {
+            bytes += MemoryReport::stringBytes(key) + report.imageBytes(m_cache.object(key)->image);
+        }
+    }
+    if (const Entry* current = m_cache.object(m_currentPath)) {
+        bytes += MemoryReport::stringBytes(m_currentPath) + report.imageBytes(current->image);
+    }
+    report.add("Preview loader cache", bytes, keys.size());
+}
+
+} // namespace FullFrame
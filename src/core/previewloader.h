@@ -0,0 +1,126 @@
+/**
+ * PreviewLoader - Background decoding of full-screen image previews
+ *
+ * Tagging mode shows one large image at a time and steps through them with
+ * the arrow keys. Decoding a 40–60MP original on the GUI thread stalls every
+ * keypress, so previews are decoded here instead:
+ * - Decoded on a small private thread pool, never on the GUI thread
+ * - Sized to the preview widget with QImageReader::setScaledSize, so JPEGs
+ *   decode at reduced scale and nothing larger than the screen is kept
+ * - Neighbouring images are prefetched at low priority into a small
+ *   byte-bounded LRU, so stepping to them is a cache hit
+ * - Requests that fall out of the wanted window before a worker starts
+ *   them are skipped
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QRunnable>
+#include <QSet>
+#include <QSize>
+#include <QStringList>
+
+class QThreadPool;
+
+namespace FullFrame {
+
+class MemoryReport;
+
+/**
+ * Worker decoding one preview in the loader's thread pool
+ */
+class PreviewWorker : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    PreviewWorker(const QString& filePath, const QSize& boundingSize);
+    void run() override;
+
+    static QImage decode(const QString& filePath, const QSize& boundingSize);
+
+Q_SIGNALS:
+    // `skipped` is set when the path left the wanted window before decoding
+    void finished(const QString& filePath, const QSize& boundingSize, const QImage& image, bool skipped);
+
+private:
+    QString m_filePath;
+    QSize m_boundingSize;
+};
+
+/**
+ * Preview decoding/prefetch manager
+ * Singleton - use instance() to access
+ */
+class PreviewLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    static PreviewLoader* instance();
+    static bool hasInstance() { return s_instance; }
+    static void cleanup();
+
+    // Cached preview that fills boundingSize (or is the full image), if any
+    bool find(const QString& filePath, const QSize& boundingSize, QImage& image);
+
+    // Decode filePath for display at boundingSize; previewReady follows.
+    // Also replaces the prefetch window: anything queued and not in
+    // `prefetchPaths` is dropped.
+    void request(const QString& filePath, const QSize& boundingSize,
+                 const QStringList& prefetchPaths = QStringList());
+
+    void clear();
+
+    // Cached previews, counted before the views that show them
+    void reportMemory(MemoryReport& report) const;
+
+Q_SIGNALS:
+    void previewReady(const QString& filePath, const QImage& image);
+    void previewFailed(const QString& filePath);
+
+private Q_SLOTS:
+    void slotWorkerFinished(const QString& filePath, const QSize& boundingSize,
+                            const QImage& image, bool skipped);
+
+private:
+    explicit PreviewLoader(QObject* parent = nullptr);
+    ~PreviewLoader() override;
+
+    // Disable copy
+    PreviewLoader(const PreviewLoader&) = delete;
+    PreviewLoader& operator=(const PreviewLoader&) = delete;
+
+    struct Entry
+    {
+        QImage image;
+        QSize boundingSize;   // Size it was decoded for
+    };
+
+    bool isWanted(const QString& filePath) const;
+    void schedule(const QString& filePath, const QSize& boundingSize, int priority);
+    static bool covers(const Entry& entry, const QSize& boundingSize);
+
+    friend class PreviewWorker;
+
+private:
+    static PreviewLoader* s_instance;
+
+    QThreadPool* m_threadPool;
+
+    // Cost is in KiB of decoded image memory (GUI thread only)
+    QCache<QString, Entry> m_cache;
+    QString m_currentPath;
+    QSize m_currentSize;
+
+    // Paths queued or decoding, and the current window of wanted paths
+    mutable QMutex m_mutex;
+    QSet<QString> m_pending;
+    QSet<QString> m_wanted;
+};
+
+} // namespace FullFrame
@@ -0,0 +1,126 @@
+/**
+ * StartupTrace implementation
+ */
+
+#include "startuptrace.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+namespace FullFrame {
+
+namespace {
+struct Phase
+{
+    const char* name;
+    qint64 endNs;
+};
+
+struct TraceState
+{
+    QElapsedTimer clock;
+    QVector<Phase> phases;
+    bool verbose = false;
+    bool finished = false;
+};
+
+TraceState& state()
+{
+    static TraceState s;
+    return s;
+}
+
+double toMs(qint64 ns)
+{
+    return ns / 1e6;
+}
+}
+
+void StartupTrace::begin()
+{
+    TraceState& s = state();
+    s.clock.start();
+    s.phases.clear();
+    s.phases.reserve(16);
+    s.finished = false;
+}
+
+void StartupTrace::mark(const char* phase)
+{
+    TraceState& s = state();
+    if (s.finished || !s.clock.isValid()) {
+        return;
+    }
+    s.phases.append({ phase, s.clock.nsecsElapsed() });
+}
+
+void StartupTrace::setVerbose(bool verbose)
+{
+    state().verbose = verbose;
+}
+
+bool StartupTrace::isFinished()
+{
+    return state().finished;
+}
+
+QString StartupTrace::report()
+{
+    const TraceState& s = state();
+    QString text;
+    qint64 previousNs = 0;
+    for (const Phase& phase : s.phases) {
+        text += QString("%1 %2 ms\n")
+                    .arg(QString::fromLatin1(phase.name) + ':', -28)
+                    .arg(toMs(phase.endNs - previousNs), 8, 'f', 1);
+        previousNs = phase.endNs;
+    }
+    text += QString("%1 %2 ms\n").arg(QStringLiteral("total:"), -28).arg(toMs(previousNs), 8, 'f', 1);
+    return text;
+}
+
+void StartupTrace::finish()
+{
+    TraceState& s = state();
+    if (s.finished || !s.clock.isValid()) {
+        return;
+    }
+    s.finished = true;
+
+    if (s.verbose) {
+        const QStringList lines = report().split('\n', Qt::SkipEmptyParts);
+        for (const QString& line : lines) {
+            qInfo().noquote() << "startup" << line;
+        }
+    }
+
+    // One line per launch so regressions show up when comparing runs
+    QStringList fields;
+    qint64 previousNs = 0;
+    for (const Phase& phase : s.phases) {
+        fields << QString("%1=%2").arg(QString::fromLatin1(phase.name)).arg(toMs(phase.endNs - previousNs), 0, 'f', 1);
+        previousNs = phase.endNs;
+    }
+
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (dir.isEmpty() || !QDir().mkpath(dir)) {
+        return;
+    }
+    QFile log(QDir(dir).filePath("startup.log"));
+    if (!log.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        return;
+    }
+    QTextStream out(&log);
+    out << QDateTime::currentDateTime().toString(Qt::ISODate)
+        << " total=" << QString::number(toMs(previousNs), 'f', 1) << "ms "
+        << fields.join(' ') << '\n';
+}
+
+} // namespace FullFrame
@@ -0,0 +1,33 @@
+/**
+ * StartupTrace - Time spent in each phase of application startup
+ *
+ * main() calls begin() first thing and mark() as each phase ends; a phase
+ * runs from the previous mark to its own. finish() is called once the
+ * window has painted and the last folder is restored: it appends a one-line
+ * summary to startup.log in the app data folder and, with --trace-startup
+ * on the command line, prints the full table to the debug output.
+ *
+ * Marks after finish() are ignored. GUI thread only.
+ */
+
+#pragma once
+
+#include <QString>
+
+namespace FullFrame {
+
+class StartupTrace
+{
+public:
+    static void begin();
+    static void mark(const char* phase);
+    static void finish();
+
+    static void setVerbose(bool verbose);
+    static bool isFinished();
+
+    // "phase: ms" lines plus the total, as written with --trace-startup
+    static QString report();
+};
+
+} // namespace FullFrame
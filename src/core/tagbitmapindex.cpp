@@ -0,0 +1,106 @@
+/**
+ * TagBitmapIndex implementation
+ */
+
+#include "tagbitmapindex.h"
+
+#include <QtAlgorithms>
+
+namespace FullFrame {
+
+void TagBitmapIndex::reset(const QStringList& imagePaths)
+{
+    m_indexByPath.clear();
+    m_indexByPath.reserve(imagePaths.size());
+    for (const QString& path : imagePaths) {
+        if (!m_indexByPath.contains(path)) {
+            m_indexByPath.insert(path, m_indexByPath.size());
+        }
+    }
+    m_imageCount = m_indexByPath.size();
+
+    m_tags.clear();
+    m_selection.fill(0, wordCount());
+    m_selectionSize = 0;
+    m_selectionFirstWord = 0;
+    m_selectionLastWord = 0;
+}
+
+bool TagBitmapIndex::setTagged(const QString& imagePath, qint64 tagId, bool tagged)
+{
+    const int index = m_indexByPath.value(imagePath, -1);
+    if (index < 0) {
+        return false;
+    }
+
+    Bitmap& bitmap = m_tags[tagId];
+    if (bitmap.words.isEmpty()) {
+        bitmap.words.fill(0, wordCount());
+    }
+
+    quint64& word = bitmap.words[index / 64];
+    const quint64 bit = quint64(1) << (index % 64);
+    if (bool(word & bit) == tagged) {
+        return false;
+    }
+    word ^= bit;
+    bitmap.count += tagged ? 1 : -1;
+    return true;
+}
+
+int TagBitmapIndex::count(qint64 tagId) const
+{
+    const auto it = m_tags.constFind(tagId);
+    return it != m_tags.constEnd() ? it->count : 0;
+}
+
+QStringList TagBitmapIndex::setSelection(const QStringList& imagePaths)
+{
+    QStringList unindexed;
+    m_selection.fill(0, wordCount());
+    m_selectionSize = 0;
+    m_selectionFirstWord = wordCount();
+    m_selectionLastWord = 0;
+
+    for (const QString& path : imagePaths) {
+        const int index = m_indexByPath.value(path, -1);
+        if (index < 0) {
+            unindexed.append(path);
+            continue;
+        }
+
+        quint64& word = m_selection[index / 64];
+        const quint64 bit = quint64(1) << (index % 64);
+        if (!(word & bit)) {
+            word |= bit;
+            ++m_selectionSize;
+            m_selectionFirstWord = qMin(m_selectionFirstWord, index / 64);
+            m_selectionLastWord = qMax(m_selectionLastWord, index / 64 + 1);
+        }
+    }
+    if (m_selectionSize == 0) {
+        m_selectionFirstWord = 0;
+    }
+    return unindexed;
+}
+
+int TagBitmapIndex::selectedCount(qint64 tagId) const
+{
+    if (m_selectionSize == 0) {
+        return 0;
+    }
+    const auto it = m_tags.constFind(tagId);
+    if (it == m_tags.constEnd() || it->count == 0) {
+        return 0;
+    }
+
+    const quint64* tagWords = it->words.constData();
+    const quint64* selectionWords = m_selection.constData();
+    int selected = 0;
+    for (int i = m_selectionFirstWord; i < m_selectionLastWord; ++i) {
+        selected += qPopulationCount(tagWords[i] & selectionWords[i]);
+    }
+    return selected;
+}
+
+} // namespace FullFrame
@@ -0,0 +1,67 @@
+/**
+ * TagBitmapIndex - Which images of the current folder carry each tag
+ *
+ * The folder's images are numbered once; each tag then keeps a bitmap of
+ * the images it is applied to, and the grid selection is a bitmap over
+ * the same numbering. "How many selected images have this tag" is an AND
+ * and a popcount over the words the selection spans, so the all / some /
+ * none state of every tag over a large selection costs a few microseconds
+ * per tag and no database access.
+ *
+ * TagSidebarModel builds it from TagManager::imageTagsFor() over the
+ * folder's paths, so building it costs the folder rather than the whole
+ * library, and keeps it current from TagManager::tagUsageChanged.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace FullFrame {
+
+class TagBitmapIndex
+{
+public:
+    // Number the images; drops every tag bitmap and the selection
+    void reset(const QStringList& imagePaths);
+    bool isEmpty() const { return m_imageCount == 0; }
+    bool contains(const QString& imagePath) const { return m_indexByPath.contains(imagePath); }
+
+    // Returns false if the image is not indexed or the bit was already set
+    // that way
+    bool setTagged(const QString& imagePath, qint64 tagId, bool tagged);
+
+    // Indexed images carrying the tag
+    int count(qint64 tagId) const;
+
+    // Returns the paths that are not indexed, which callers have to check
+    // some other way
+    QStringList setSelection(const QStringList& imagePaths);
+    int selectionSize() const { return m_selectionSize; }
+    // Selected images carrying the tag
+    int selectedCount(qint64 tagId) const;
+
+private:
+    struct Bitmap
+    {
+        QVector<quint64> words;
+        int count = 0;
+    };
+
+    int wordCount() const { return (m_imageCount + 63) / 64; }
+
+private:
+    QHash<QString, int> m_indexByPath;
+    int m_imageCount = 0;
+    QHash<qint64, Bitmap> m_tags;
+
+    QVector<quint64> m_selection;
+    int m_selectionSize = 0;
+    int m_selectionFirstWord = 0;   // Words outside [first, last) are zero
+    int m_selectionLastWord = 0;
+};
+
+} // namespace FullFrame
@@ -0,0 +1,220 @@
+/**
+ * TagCompletionIndex implementation
+ */
+
+#include "tagcompletionindex.h"
+
+#include <QDateTime>
+#include <algorithm>
+#include <cmath>
+
+namespace FullFrame {
+
+namespace {
+// A tag used just now ranks like one used on 15 more images; the boost
+// halves every half hour
+constexpr double RecencyWeight = 4.0;
+constexpr double RecencyHalfLifeMs = 30.0 * 60 * 1000;
+
+enum MatchClass { ExactMatch = 0, PrefixMatch = 1, InfixMatch = 2 };
+
+struct Candidate
+{
+    int matchClass;
+    double score;
+    qint64 tagId;
+    const QString* name;
+};
+}
+
+void TagCompletionIndex::clear()
+{
+    m_entries.clear();
+    m_idsByName.clear();
+    m_sorted.clear();
+    m_trigrams.clear();
+}
+
+QVector<quint64> TagCompletionIndex::trigrams(const QString& name)
+{
+    QVector<quint64> grams;
+    if (name.size() < 3) {
+        return grams;
+    }
+    grams.reserve(name.size() - 2);
+    for (int i = 0; i + 2 < name.size(); ++i) {
+        grams.append((quint64(name[i].unicode()) << 32)
+                     | (quint64(name[i + 1].unicode()) << 16)
+                     | quint64(name[i + 2].unicode()));
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+void TagCompletionIndex::indexName(qint64 tagId, const QString& name)
+{
+    m_idsByName.insert(name, tagId);
+
+    auto pos = std::lower_bound(m_sorted.begin(), m_sorted.end(), name,
+                                [](const SortedName& a, const QString& b) { return a.name < b; });
+    m_sorted.insert(pos, SortedName{name, tagId});
+
+    for (quint64 gram : trigrams(name)) {
+        QVector<qint64>& ids = m_trigrams[gram];
+        ids.insert(std::lower_bound(ids.begin(), ids.end(), tagId), tagId);
+    }
+}
+
+void TagCompletionIndex::unindexName(qint64 tagId, const QString& name)
+{
+    m_idsByName.remove(name);
+
+    auto pos = std::lower_bound(m_sorted.begin(), m_sorted.end(), name,
+                                [](const SortedName& a, const QString& b) { return a.name < b; });
+    if (pos != m_sorted.end() && pos->tagId == tagId) {
+        m_sorted.erase(pos);
+    }
+
+    for (quint64 gram : trigrams(name)) {
+        auto it = m_trigrams.find(gram);
+        if (it == m_trigrams.end()) {
+            continue;
+        }
+        QVector<qint64>& ids = it.value();
+        auto idPos = std::lower_bound(ids.begin(), ids.end(), tagId);
+        if (idPos != ids.end() && *idPos == tagId) {
+            ids.erase(idPos);
+        }
+        if (ids.isEmpty()) {
+            m_trigrams.erase(it);
+        }
+    }
+}
+
+void TagCompletionIndex::insert(qint64 tagId, const QString& name, int usageCount, qint64 lastUsedMs)
+{
+    if (m_entries.contains(tagId)) {
+        remove(tagId);
+    }
+
+    Entry entry;
+    entry.name = name;
+    entry.usageCount = usageCount;
+    entry.lastUsedMs = lastUsedMs;
+    m_entries.insert(tagId, entry);
+    indexName(tagId, name);
+}
+
+void TagCompletionIndex::remove(qint64 tagId)
+{
+    auto it = m_entries.find(tagId);
+    if (it == m_entries.end()) {
+        return;
+    }
+    unindexName(tagId, it->name);
+    m_entries.erase(it);
+}
+
+void TagCompletionIndex::rename(qint64 tagId, const QString& newName)
+{
+    auto it = m_entries.find(tagId);
+    if (it == m_entries.end() || it->name == newName) {
+        return;
+    }
+    unindexName(tagId, it->name);
+    it->name = newName;
+    indexName(tagId, newName);
+}
+
+void TagCompletionIndex::addUsage(qint64 tagId, int delta, qint64 usedAtMs)
+{
+    auto it = m_entries.find(tagId);
+    if (it == m_entries.end()) {
+        return;
+    }
+    it->usageCount = qMax(0, it->usageCount + delta);
+    if (usedAtMs > it->lastUsedMs) {
+        it->lastUsedMs = usedAtMs;
+    }
+}
+
+double TagCompletionIndex::score(const Entry& entry, qint64 nowMs) const
+{
+    double result = std::log2(1.0 + entry.usageCount);
+    if (entry.lastUsedMs > 0) {
+        const double ageMs = double(qMax<qint64>(0, nowMs - entry.lastUsedMs));
+        result += RecencyWeight * std::exp2(-ageMs / RecencyHalfLifeMs);
+    }
+    return result;
+}
+
+qint64 TagCompletionIndex::tagId(const QString& name) const
+{
+    return m_idsByName.value(name.trimmed().toLower(), -1);
+}
+
+QList<TagCompletion> TagCompletionIndex::complete(const QString& text, int limit) const
+{
+    QList<TagCompletion> results;
+    const QString query = text.trimmed().toLower();
+    if (query.isEmpty() || limit <= 0) {
+        return results;
+    }
+
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    QVector<Candidate> candidates;
+
+    // Prefix matches: one contiguous range of the sorted array
+    auto byName = [](const SortedName& a, const QString& b) { return a.name < b; };
+    auto first = std::lower_bound(m_sorted.cbegin(), m_sorted.cend(), query, byName);
+    auto last = std::lower_bound(first, m_sorted.cend(), query + QChar(0xFFFF), byName);
+    candidates.reserve(int(last - first));
+    for (auto it = first; it != last; ++it) {
+        const Entry& entry = *m_entries.constFind(it->tagId);
+        candidates.append(Candidate{it->name == query ? ExactMatch : PrefixMatch,
+                                    score(entry, nowMs), it->tagId, &entry.name});
+    }
+
+    // Infix matches: candidates from the rarest trigram of the query
+    const QVector<quint64> grams = trigrams(query);
+    const QVector<qint64>* rarest = nullptr;
+    for (quint64 gram : grams) {
+        auto it = m_trigrams.constFind(gram);
+        if (it == m_trigrams.constEnd()) {
+            rarest = nullptr;   // Some trigram occurs nowhere: no infix match
+            break;
+        }
+        if (!rarest || it->size() < rarest->size()) {
+            rarest = &it.value();
+        }
+    }
+    if (rarest) {
+        for (qint64 tagId : *rarest) {
+            const Entry& entry = *m_entries.constFind(tagId);
+            if (!entry.name.startsWith(query) && entry.name.contains(query)) {
+                candidates.append(Candidate{InfixMatch, score(entry, nowMs), tagId, &entry.name});
+            }
+        }
+    }
+
+    auto better = [](const Candidate& a, const Candidate& b) {
+        if (a.matchClass != b.matchClass) {
+            return a.matchClass < b.matchClass;
+        }
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        return *a.name < *b.name;
+    };
+    const int count = qMin(limit, int(candidates.size()));
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), better);
+
+    results.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        results.append(TagCompletion{candidates[i].tagId, *candidates[i].name});
+    }
+    return results;
+}
+
+} // namespace FullFrame
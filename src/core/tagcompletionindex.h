@@ -0,0 +1,80 @@
+/**
+ * TagCompletionIndex - In-memory tag name completion
+ *
+ * Answers "which tags match what the user typed" without touching the
+ * database or scanning every name:
+ * - Names are kept in a sorted array; prefix matches are the binary-searched
+ *   range [lower_bound(text), lower_bound(text + U+FFFF))
+ * - A trigram index (3 UTF-16 units -> sorted tag ids) finds infix matches
+ *   for queries of three or more characters: the rarest trigram of the
+ *   query gives the candidates, which are then verified with contains()
+ * - Results are ranked exact > prefix > infix, and within each group by
+ *   how often and how recently the tag was used
+ *
+ * TagManager owns the index and updates it as tags are created, renamed,
+ * deleted and applied, so it never has to be rebuilt while typing.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+namespace FullFrame {
+
+struct TagCompletion
+{
+    qint64 tagId = -1;
+    QString name;
+};
+
+class TagCompletionIndex
+{
+public:
+    void clear();
+
+    // Names are expected lower-case, as TagManager stores them
+    void insert(qint64 tagId, const QString& name, int usageCount = 0, qint64 lastUsedMs = 0);
+    void remove(qint64 tagId);
+    void rename(qint64 tagId, const QString& newName);
+
+    // Usage bookkeeping for ranking; usedAtMs is msecs since epoch
+    void addUsage(qint64 tagId, int delta, qint64 usedAtMs = 0);
+
+    // Best matches for text (case-insensitive), at most limit of them
+    QList<TagCompletion> complete(const QString& text, int limit) const;
+
+    // Exact lookup, -1 if no tag has this name
+    qint64 tagId(const QString& name) const;
+
+    int size() const { return m_entries.size(); }
+
+private:
+    struct Entry
+    {
+        QString name;
+        int usageCount = 0;
+        qint64 lastUsedMs = 0;
+    };
+
+    struct SortedName
+    {
+        QString name;
+        qint64 tagId;
+    };
+
+    static QVector<quint64> trigrams(const QString& name);
+    void indexName(qint64 tagId, const QString& name);
+    void unindexName(qint64 tagId, const QString& name);
+    double score(const Entry& entry, qint64 nowMs) const;
+
+private:
+    QHash<qint64, Entry> m_entries;
+    QHash<QString, qint64> m_idsByName;
+    QVector<SortedName> m_sorted;                 // By name
+    QHash<quint64, QVector<qint64>> m_trigrams;   // Trigram -> sorted tag ids
+};
+
+} // namespace FullFrame
@@ -5,8 +5,12 @@
  */
 
 #include "tagmanager.h"
+#include "hotkeylatency.h"
+#include "eventtrace.h"
+#include "memoryreport.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QTimeZone>
 #include <QFileInfo>
 #include <QDebug>
 
@@ -59,6 +63,8 @@ bool TagManager::initialize(const QString& dbPath)
         return false;
     }
 
+    rebuildCompletionIndex();
+
     m_initialized = true;
     return true;
 }
@@ -71,6 +77,7 @@ bool TagManager::reinitialize(const QString& dbPath)
     m_initialized = false;
     m_tagCache.clear();
     m_imageTagCache.clear();
+    m_completionIndex.clear();
 
     QSqlDatabase::removeDatabase("fullframe_tags");
 
@@ -199,6 +206,7 @@ qint64 TagManager::createTag(const QString& name, const QString& color, qint64 p
     newTag.color = color;
     newTag.parentId = parentId;
     m_tagCache.insert(tagId, newTag);
+    m_completionIndex.insert(tagId, lowerName);
 
     Q_EMIT tagCreated(tagId, lowerName);
     Q_EMIT tagsChanged();
@@ -216,6 +224,7 @@ bool TagManager::deleteTag(qint64 tagId)
     }
 
     m_tagCache.remove(tagId);
+    m_completionIndex.remove(tagId);
     Q_EMIT tagDeleted(tagId);
     Q_EMIT tagsChanged();
     return true;
@@ -237,6 +246,7 @@ bool TagManager::renameTag(qint64 tagId, const QString& newName)
     if (m_tagCache.contains(tagId)) {
         m_tagCache[tagId].name = lowerName;
     }
+    m_completionIndex.rename(tagId, lowerName);
 
     Q_EMIT tagRenamed(tagId, lowerName);
     Q_EMIT tagsChanged();
@@ -375,6 +385,7 @@ Tag TagManager::tagByHotkey(const QString& hotkey) const
 
 QList<Tag> TagManager::allTags() const
 {
+    EventTrace::Span span("allTags", "db");
     QList<Tag> tags;
     QSqlQuery query(m_db);
     query.exec("SELECT id, name, color, hotkey, parent_id, album_path FROM tags ORDER BY name");
@@ -394,6 +405,24 @@ QList<Tag> TagManager::allTags() const
     return tags;
 }
 
+void TagManager::rebuildCompletionIndex()
+{
+    m_completionIndex.clear();
+
+    const QHash<qint64, int> counts = tagImageCounts();
+    const QHash<qint64, QDateTime> lastUsed = tagLastUsedTimes();
+
+    for (const Tag& tag : allTags()) {
+        // tagged_at is stored by SQLite as UTC without a zone
+        qint64 lastUsedMs = 0;
+        const QDateTime stamp = lastUsed.value(tag.id);
+        if (stamp.isValid()) {
+            lastUsedMs = QDateTime(stamp.date(), stamp.time(), QTimeZone::utc()).toMSecsSinceEpoch();
+        }
+        m_completionIndex.insert(tag.id, tag.name, counts.value(tag.id), lastUsedMs);
+    }
+}
+
 QList<Tag> TagManager::childTags(qint64 parentId) const
 {
     QList<Tag> tags;
@@ -450,28 +479,51 @@ qint64 TagManager::getOrCreateImageId(const QString& imagePath)
 
 bool TagManager::tagImage(const QString& imagePath, qint64 tagId, bool asSupertag)
 {
+    EventTrace::Span span("tagImage", "db");
     qint64 imgId = getOrCreateImageId(imagePath);
     if (imgId < 0) {
         return false;
     }
 
+    // Whether the image already had the tag comes from the insert itself,
+    // so the usage delta costs no extra lookup
     QSqlQuery query(m_db);
-    query.prepare("INSERT OR REPLACE INTO image_tags (image_id, tag_id, is_supertag) VALUES (?, ?, ?)");
+    query.prepare("INSERT OR IGNORE INTO image_tags (image_id, tag_id, is_supertag) VALUES (?, ?, ?)");
     query.addBindValue(imgId);
     query.addBindValue(tagId);
     query.addBindValue(asSupertag ? 1 : 0);
+    if (!query.exec()) {
+        return false;
+    }
 
-    if (query.exec()) {
-        // Update cache
-        m_imageTagCache[imagePath].insert(tagId);
-        Q_EMIT imageTagged(imagePath, tagId);
-        return true;
+    const bool wasTagged = query.numRowsAffected() == 0;
+    if (wasTagged) {
+        // Re-tagging refreshes the supertag flag and the timestamp
+        query.prepare("UPDATE image_tags SET is_supertag = ?, tagged_at = CURRENT_TIMESTAMP "
+                      "WHERE image_id = ? AND tag_id = ?");
+        query.addBindValue(asSupertag ? 1 : 0);
+        query.addBindValue(imgId);
+        query.addBindValue(tagId);
+        if (!query.exec()) {
+            return false;
+        }
     }
-    return false;
+
+    // Update cache; only complete tag sets are cached, others load on demand
+    auto cached = m_imageTagCache.find(imagePath);
+    if (cached != m_imageTagCache.end()) {
+        cached->insert(tagId);
+    }
+    m_completionIndex.addUsage(tagId, wasTagged ? 0 : 1, QDateTime::currentMSecsSinceEpoch());
+    HotkeyLatency::Scope fanOut(HotkeyLatency::SignalFanOut);
+    Q_EMIT imageTagged(imagePath, tagId);
+    Q_EMIT tagUsageChanged(imagePath, tagId, wasTagged ? 0 : 1);
+    return true;
 }
 
 bool TagManager::untagImage(const QString& imagePath, qint64 tagId)
 {
+    EventTrace::Span span("untagImage", "db");
     qint64 imgId = imageId(imagePath);
     if (imgId < 0) {
         return false;
@@ -483,8 +535,19 @@ bool TagManager::untagImage(const QString& imagePath, qint64 tagId)
     query.addBindValue(tagId);
 
     if (query.exec()) {
-        m_imageTagCache[imagePath].remove(tagId);
+        auto cached = m_imageTagCache.find(imagePath);
+        if (cached != m_imageTagCache.end()) {
+            cached->remove(tagId);
+        }
+        const bool removed = query.numRowsAffected() > 0;
+        if (removed) {
+            m_completionIndex.addUsage(tagId, -1);
+        }
+        HotkeyLatency::Scope fanOut(HotkeyLatency::SignalFanOut);
         Q_EMIT imageUntagged(imagePath, tagId);
+        if (removed) {
+            Q_EMIT tagUsageChanged(imagePath, tagId, -1);
+        }
         return true;
     }
     return false;
@@ -516,6 +579,7 @@ bool TagManager::setSupertag(const QString& imagePath, qint64 tagId, bool isSupe
         }
     }
 
+    HotkeyLatency::Scope fanOut(HotkeyLatency::SignalFanOut);
     Q_EMIT imageTagged(imagePath, tagId);
     return true;
 }
@@ -598,6 +662,7 @@ QSet<qint64> TagManager::tagIdsForImage(const QString& imagePath) const
         return m_imageTagCache.value(imagePath);
     }
 
+    EventTrace::Span span("tagIdsForImage", "db");
     QSet<qint64> tagIds;
     qint64 imgId = imageId(imagePath);
     if (imgId < 0) {
@@ -620,6 +685,7 @@ QSet<qint64> TagManager::tagIdsForImage(const QString& imagePath) const
 
 QStringList TagManager::imagesWithTag(qint64 tagId) const
 {
+    EventTrace::Span span("imagesWithTag", "db");
     QStringList paths;
     QSqlQuery query(m_db);
     query.prepare(R"(
@@ -641,6 +707,7 @@ QStringList TagManager::imagesWithTag(qint64 tagId) const
 
 QStringList TagManager::imagesWithAnyTag(const QSet<qint64>& tagIds) const
 {
+    EventTrace::Span span("imagesWithAnyTag", "db");
     if (tagIds.isEmpty()) {
         return QStringList();
     }
@@ -674,6 +741,7 @@ QStringList TagManager::imagesWithAnyTag(const QSet<qint64>& tagIds) const
 
 QStringList TagManager::imagesWithAllTags(const QSet<qint64>& tagIds) const
 {
+    EventTrace::Span span("imagesWithAllTags", "db");
     if (tagIds.isEmpty()) {
         return QStringList();
     }
@@ -710,6 +778,7 @@ QStringList TagManager::imagesWithAllTags(const QSet<qint64>& tagIds) const
 
 bool TagManager::tagImages(const QStringList& imagePaths, qint64 tagId)
 {
+    EventTrace::Span span("tagImages", "db");
     bool success = true;
     m_db.transaction();
     
@@ -725,6 +794,7 @@ bool TagManager::tagImages(const QStringList& imagePaths, qint64 tagId)
 
 bool TagManager::untagImages(const QStringList& imagePaths, qint64 tagId)
 {
+    EventTrace::Span span("untagImages", "db");
     bool success = true;
     m_db.transaction();
     
@@ -738,6 +808,248 @@ bool TagManager::untagImages(const QStringList& imagePaths, qint64 tagId)
     return success;
 }
 
+// ============== Set-Based Bulk Edits ==============
+
+qint64 TagManager::totalChanges() const
+{
+    QSqlQuery query(m_db);
+    if (query.exec("SELECT total_changes()") && query.next()) {
+        return query.value(0).toLongLong();
+    }
+    return 0;
+}
+
+int TagManager::registerImages(const QStringList& imagePaths)
+{
+    EventTrace::Span span("registerImages", "db");
+    if (imagePaths.isEmpty()) {
+        return 0;
+    }
+
+    const qint64 before = totalChanges();
+    m_db.transaction();
+
+    QSqlQuery query(m_db);
+    query.prepare("INSERT OR IGNORE INTO images (path) VALUES (?)");
+    query.addBindValue(QVariantList(imagePaths.cbegin(), imagePaths.cend()));
+    if (!query.execBatch()) {
+        qWarning() << "Failed to register images:" << query.lastError().text();
+        m_db.rollback();
+        return -1;
+    }
+
+    m_db.commit();
+    return int(totalChanges() - before);
+}
+
+// Loads (path, tag) pairs into a temp table so the edits below can join
+// against it. Caller holds the transaction.
+bool TagManager::stageImageTags(const QVector<QPair<QString, qint64>>& assignments)
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("CREATE TEMP TABLE IF NOT EXISTS bulk_image_tags (path TEXT NOT NULL, tag_id INTEGER NOT NULL)")
+        || !query.exec("DELETE FROM bulk_image_tags")) {
+        qWarning() << "Failed to stage image tags:" << query.lastError().text();
+        return false;
+    }
+
+    QVariantList paths;
+    QVariantList tagIds;
+    paths.reserve(assignments.size());
+    tagIds.reserve(assignments.size());
+    for (const auto& assignment : assignments) {
+        paths.append(assignment.first);
+        tagIds.append(assignment.second);
+    }
+
+    query.prepare("INSERT INTO bulk_image_tags (path, tag_id) VALUES (?, ?)");
+    query.addBindValue(paths);
+    query.addBindValue(tagIds);
+    if (!query.execBatch()) {
+        qWarning() << "Failed to stage image tags:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+// Loads paths into a temp table for a join. Caller holds the transaction.
+bool TagManager::stagePaths(const QStringList& imagePaths)
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("CREATE TEMP TABLE IF NOT EXISTS bulk_paths (path TEXT PRIMARY KEY)")
+        || !query.exec("DELETE FROM bulk_paths")) {
+        qWarning() << "Failed to stage paths:" << query.lastError().text();
+        return false;
+    }
+
+    query.prepare("INSERT OR IGNORE INTO bulk_paths (path) VALUES (?)");
+    query.addBindValue(QVariantList(imagePaths.cbegin(), imagePaths.cend()));
+    if (!query.execBatch()) {
+        qWarning() << "Failed to stage paths:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+int TagManager::addImageTags(const QVector<QPair<QString, qint64>>& assignments)
+{
+    EventTrace::Span span("addImageTags", "db");
+    if (assignments.isEmpty()) {
+        return 0;
+    }
+
+    m_db.transaction();
+    if (!stageImageTags(assignments)) {
+        m_db.rollback();
+        return -1;
+    }
+
+    QSqlQuery query(m_db);
+    if (!query.exec("INSERT OR IGNORE INTO images (path) SELECT DISTINCT path FROM bulk_image_tags")
+        || !query.exec(R"(
+            INSERT OR IGNORE INTO image_tags (image_id, tag_id)
+            SELECT DISTINCT i.id, b.tag_id FROM bulk_image_tags b
+            JOIN images i ON i.path = b.path
+            JOIN tags t ON t.id = b.tag_id
+        )")) {
+        qWarning() << "Failed to add image tags:" << query.lastError().text();
+        m_db.rollback();
+        return -1;
+    }
+    const int added = query.numRowsAffected();
+    query.exec("DELETE FROM bulk_image_tags");
+    m_db.commit();
+
+    // Reloaded from the database on next access
+    for (const auto& assignment : assignments) {
+        m_imageTagCache.remove(assignment.first);
+    }
+    rebuildCompletionIndex();
+    Q_EMIT tagsChanged();
+    return added;
+}
+
+int TagManager::removeImageTags(const QVector<QPair<QString, qint64>>& assignments)
+{
+    EventTrace::Span span("removeImageTags", "db");
+    if (assignments.isEmpty()) {
+        return 0;
+    }
+
+    m_db.transaction();
+    if (!stageImageTags(assignments)) {
+        m_db.rollback();
+        return -1;
+    }
+
+    QSqlQuery query(m_db);
+    if (!query.exec(R"(
+            DELETE FROM image_tags WHERE rowid IN (
+                SELECT it.rowid FROM bulk_image_tags b
+                JOIN images i ON i.path = b.path
+                JOIN image_tags it ON it.image_id = i.id AND it.tag_id = b.tag_id
+            )
+        )")) {
+        qWarning() << "Failed to remove image tags:" << query.lastError().text();
+        m_db.rollback();
+        return -1;
+    }
+    const int removed = query.numRowsAffected();
+    query.exec("DELETE FROM bulk_image_tags");
+    m_db.commit();
+
+    for (const auto& assignment : assignments) {
+        m_imageTagCache.remove(assignment.first);
+    }
+    rebuildCompletionIndex();
+    Q_EMIT tagsChanged();
+    return removed;
+}
+
+int TagManager::setRatings(const QHash<QString, int>& ratings)
+{
+    EventTrace::Span span("setRatings", "db");
+    if (ratings.isEmpty()) {
+        return 0;
+    }
+
+    QVariantList clearedPaths;
+    QVariantList ratedPaths;
+    QVariantList values;
+    for (auto it = ratings.cbegin(); it != ratings.cend(); ++it) {
+        if (it.value() <= 0) {
+            clearedPaths.append(it.key());
+        } else {
+            ratedPaths.append(it.key());
+            values.append(qMin(it.value(), 5));
+        }
+    }
+
+    const qint64 before = totalChanges();
+    m_db.transaction();
+
+    QSqlQuery query(m_db);
+    bool success = true;
+    if (!clearedPaths.isEmpty()) {
+        query.prepare("DELETE FROM ratings WHERE image_path = ?");
+        query.addBindValue(clearedPaths);
+        success = query.execBatch();
+    }
+    if (success && !ratedPaths.isEmpty()) {
+        query.prepare("INSERT OR REPLACE INTO ratings (image_path, rating) VALUES (?, ?)");
+        query.addBindValue(ratedPaths);
+        query.addBindValue(values);
+        success = query.execBatch();
+    }
+    if (!success) {
+        qWarning() << "Failed to set ratings:" << query.lastError().text();
+        m_db.rollback();
+        return -1;
+    }
+
+    m_db.commit();
+    return int(totalChanges() - before);
+}
+
+TagDatabaseStats TagManager::databaseStats() const
+{
+    TagDatabaseStats stats;
+    QSqlQuery query(m_db);
+    if (query.exec(R"(
+            SELECT (SELECT COUNT(*) FROM images),
+                   (SELECT COUNT(*) FROM tags),
+                   (SELECT COUNT(*) FROM image_tags),
+                   (SELECT COUNT(*) FROM ratings),
+                   (SELECT COUNT(*) FROM sequences)
+        )") && query.next()) {
+        stats.images = query.value(0).toLongLong();
+        stats.tags = query.value(1).toLongLong();
+        stats.imageTags = query.value(2).toLongLong();
+        stats.ratings = query.value(3).toLongLong();
+        stats.sequences = query.value(4).toLongLong();
+    }
+    return stats;
+}
+
+void TagManager::reportMemory(MemoryReport& report) const
+{
+    qint64 tagBytes = MemoryReport::hashBytes(m_tagCache.size(), sizeof(qint64) + sizeof(Tag));
+    for (const Tag& tag : m_tagCache) {
+        tagBytes += MemoryReport::stringBytes(tag.name) + MemoryReport::stringBytes(tag.color)
+                  + MemoryReport::stringBytes(tag.hotkey) + MemoryReport::stringBytes(tag.albumPath);
+    }
+    report.add("Tag cache", tagBytes, m_tagCache.size());
+
+    // Filled per image on first lookup and never evicted: it grows with
+    // every image looked up until the database is reopened
+    qint64 imageBytes = MemoryReport::hashBytes(m_imageTagCache.size(), sizeof(QString) + sizeof(QSet<qint64>));
+    for (auto it = m_imageTagCache.cbegin(); it != m_imageTagCache.cend(); ++it) {
+        imageBytes += MemoryReport::stringBytes(it.key())
+                    + MemoryReport::hashBytes(it.value().size(), sizeof(qint64));
+    }
+    report.add("Image tag cache", imageBytes, m_imageTagCache.size());
+}
+
 // ============== Album Tag Support ==============
 
 bool TagManager::setTagAlbumPath(qint64 tagId, const QString& albumPath)
@@ -801,6 +1113,56 @@ bool TagManager::updateImagePath(const QString& oldPath, const QString& newPath)
     return true;
 }
 
+bool TagManager::updateImagePaths(const QHash<QString, QString>& moves)
+{
+    EventTrace::Span span("updateImagePaths", "db");
+    if (moves.isEmpty()) {
+        return true;
+    }
+
+    m_db.transaction();
+
+    QSqlQuery imageQ(m_db);
+    imageQ.prepare("UPDATE images SET path = ? WHERE path = ?");
+    QSqlQuery seqQ(m_db);
+    seqQ.prepare("UPDATE sequence_items SET image_path = ? WHERE image_path = ?");
+    QSqlQuery ratingQ(m_db);
+    ratingQ.prepare("UPDATE ratings SET image_path = ? WHERE image_path = ?");
+
+    bool success = true;
+    for (auto it = moves.cbegin(); it != moves.cend(); ++it) {
+        imageQ.addBindValue(it.value());
+        imageQ.addBindValue(it.key());
+        if (!imageQ.exec()) {
+            qWarning() << "Failed to update image path:" << imageQ.lastError().text();
+            success = false;
+            continue;
+        }
+
+        seqQ.addBindValue(it.value());
+        seqQ.addBindValue(it.key());
+        seqQ.exec();
+
+        ratingQ.addBindValue(it.value());
+        ratingQ.addBindValue(it.key());
+        ratingQ.exec();
+
+        auto cached = m_imageTagCache.find(it.key());
+        if (cached != m_imageTagCache.end()) {
+            QSet<qint64> tags = cached.value();
+            m_imageTagCache.erase(cached);
+            m_imageTagCache.insert(it.value(), tags);
+        }
+    }
+
+    m_db.commit();
+
+    for (auto it = moves.cbegin(); it != moves.cend(); ++it) {
+        Q_EMIT imagePathUpdated(it.key(), it.value());
+    }
+    return success;
+}
+
 // ============== Image Ratings ==============
 
 bool TagManager::setRating(const QString& imagePath, int rating)
@@ -834,6 +1196,7 @@ int TagManager::rating(const QString& imagePath) const
 
 QHash<QString, int> TagManager::allRatings() const
 {
+    EventTrace::Span span("allRatings", "db");
     QHash<QString, int> result;
     QSqlQuery query(m_db);
     if (query.exec("SELECT image_path, rating FROM ratings")) {
@@ -848,6 +1211,7 @@ QHash<QString, int> TagManager::allRatings() const
 
 QHash<qint64, int> TagManager::tagImageCounts(const QStringList& imagePaths) const
 {
+    EventTrace::Span span("tagImageCounts", "db");
     QHash<qint64, int> counts;
     QSqlQuery query(m_db);
 
@@ -885,6 +1249,7 @@ QHash<qint64, int> TagManager::tagImageCounts(const QStringList& imagePaths) con
 
 QHash<qint64, QDateTime> TagManager::tagLastUsedTimes() const
 {
+    EventTrace::Span span("tagLastUsedTimes", "db");
     QHash<qint64, QDateTime> times;
     QSqlQuery query(m_db);
     query.exec("SELECT tag_id, MAX(tagged_at) FROM image_tags GROUP BY tag_id");
@@ -895,6 +1260,36 @@ QHash<qint64, QDateTime> TagManager::tagLastUsedTimes() const
     return times;
 }
 
+QVector<QPair<QString, qint64>> TagManager::imageTagsFor(const QStringList& imagePaths)
+{
+    EventTrace::Span span("imageTagsFor", "db");
+    QVector<QPair<QString, qint64>> pairs;
+    if (imagePaths.isEmpty()) {
+        return pairs;
+    }
+
+    m_db.transaction();
+    if (!stagePaths(imagePaths)) {
+        m_db.rollback();
+        return pairs;
+    }
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (query.exec("SELECT i.path, it.tag_id FROM bulk_paths p "
+                   "JOIN images i ON i.path = p.path "
+                   "JOIN image_tags it ON it.image_id = i.id")) {
+        while (query.next()) {
+            pairs.append(qMakePair(query.value(0).toString(), query.value(1).toLongLong()));
+        }
+    } else {
+        qWarning() << "Failed to read image tags:" << query.lastError().text();
+    }
+    query.finish();
+    m_db.commit();
+    return pairs;
+}
+
 // ============== Tag Hierarchy / Combining ==============
 
 bool TagManager::setTagParent(qint64 tagId, qint64 parentId)
@@ -1012,6 +1407,7 @@ bool TagManager::mergeTags(const QString& targetName, const QStringList& sourceN
     m_db.commit();
 
     m_imageTagCache.clear();
+    rebuildCompletionIndex();
     Q_EMIT tagsChanged();
     return allOk;
 }
@@ -1129,6 +1525,7 @@ int TagManager::sequenceCount(qint64 sequenceId) const
 
 QHash<QString, int> TagManager::allSequenceCovers() const
 {
+    EventTrace::Span span("allSequenceCovers", "db");
     QHash<QString, int> result;
     QSqlQuery query(m_db);
     query.exec(R"(
@@ -1145,6 +1542,7 @@ QHash<QString, int> TagManager::allSequenceCovers() const
 
 QSet<QString> TagManager::hiddenSequenceMembers() const
 {
+    EventTrace::Span span("hiddenSequenceMembers", "db");
     QSet<QString> hidden;
     QSqlQuery query(m_db);
     query.exec("SELECT image_path FROM sequence_items WHERE is_cover = 0");
@@ -1155,6 +1553,7 @@ QSet<QString> TagManager::hiddenSequenceMembers() const
 
 QHash<QString, qint64> TagManager::allImageSequenceIds() const
 {
+    EventTrace::Span span("allImageSequenceIds", "db");
     QHash<QString, qint64> result;
     QSqlQuery query(m_db);
     query.exec("SELECT image_path, sequence_id FROM sequence_items");
@@ -1189,5 +1588,62 @@ bool TagManager::removeFromSequence(const QString& imagePath)
     return true;
 }
 
+bool TagManager::removeFromSequences(const QStringList& imagePaths)
+{
+    if (imagePaths.isEmpty()) {
+        return false;
+    }
+
+    // breakSequence()/setSequenceCover() open their own transactions, so
+    // the same statements are inlined here
+    m_db.transaction();
+
+    QSqlQuery find(m_db);
+    find.prepare("SELECT sequence_id FROM sequence_items WHERE image_path = ?");
+    QSqlQuery remove(m_db);
+    remove.prepare("DELETE FROM sequence_items WHERE image_path = ?");
+
+    QSet<qint64> touched;
+    for (const QString& path : imagePaths) {
+        find.addBindValue(path);
+        if (!find.exec() || !find.next()) {
+            continue;
+        }
+        touched.insert(find.value(0).toLongLong());
+        find.finish();
+
+        remove.addBindValue(path);
+        remove.exec();
+    }
+
+    QSqlQuery query(m_db);
+    for (qint64 seqId : touched) {
+        if (sequenceCount(seqId) <= 1) {
+            // 1 or fewer members remain: discard the sequence
+            query.prepare("DELETE FROM sequence_items WHERE sequence_id = ?");
+            query.addBindValue(seqId);
+            query.exec();
+            query.prepare("DELETE FROM sequences WHERE id = ?");
+            query.addBindValue(seqId);
+            query.exec();
+        } else if (sequenceCover(seqId).isEmpty()) {
+            // The cover was deleted; promote the first remaining member
+            const QStringList remaining = sequenceImages(seqId);
+            query.prepare("UPDATE sequence_items SET is_cover = 1 WHERE sequence_id = ? AND image_path = ?");
+            query.addBindValue(seqId);
+            query.addBindValue(remaining.first());
+            query.exec();
+        }
+    }
+
+    m_db.commit();
+
+    if (touched.isEmpty()) {
+        return false;
+    }
+    Q_EMIT sequencesChanged();
+    return true;
+}
+
 } // namespace FullFrame
 
@@ -15,11 +15,17 @@
 #include <QStringList>
 #include <QSet>
 #include <QHash>
+#include <QPair>
+#include <QVector>
 #include <QDateTime>
 #include <QSqlDatabase>
 
+#include "tagcompletionindex.h"
+
 namespace FullFrame {
 
+class MemoryReport;
+
 struct Tag
 {
     qint64 id = -1;
@@ -35,6 +41,16 @@ struct Tag
     bool isAlbumTag() const { return !albumPath.isEmpty(); }
 };
 
+// Row counts of the tag database, for reports
+struct TagDatabaseStats
+{
+    qint64 images = 0;
+    qint64 tags = 0;
+    qint64 imageTags = 0;
+    qint64 ratings = 0;
+    qint64 sequences = 0;
+};
+
 /**
  * Manages tags and image-tag associations
  * Uses SQLite for persistence
@@ -67,6 +83,8 @@ public:
     
     // Update image path (after file move)
     bool updateImagePath(const QString& oldPath, const QString& newPath);
+    // Same for a batch of moves (old → new path), in one transaction
+    bool updateImagePaths(const QHash<QString, QString>& moves);
 
     // Image ratings (1-5 stars; 0 clears the rating)
     bool setRating(const QString& imagePath, int rating);
@@ -80,6 +98,9 @@ public:
     QList<Tag> allTags() const;
     QList<Tag> childTags(qint64 parentId) const;
     
+    // Name completion over all tags, kept current as tags change
+    const TagCompletionIndex& completionIndex() const { return m_completionIndex; }
+    
     // Image-tag associations
     bool tagImage(const QString& imagePath, qint64 tagId, bool asSupertag = false);
     bool untagImage(const QString& imagePath, qint64 tagId);
@@ -103,10 +124,28 @@ public:
     // Get the most recent tagged_at timestamp for each tag
     QHash<qint64, QDateTime> tagLastUsedTimes() const;
     
+    // (image path, tag id) associations of the given images, for in-memory
+    // indexes; the paths are joined in the database, so the cost follows
+    // the folder rather than the library
+    QVector<QPair<QString, qint64>> imageTagsFor(const QStringList& imagePaths);
+    
     // Bulk operations
     bool tagImages(const QStringList& imagePaths, qint64 tagId);
     bool untagImages(const QStringList& imagePaths, qint64 tagId);
     
+    // Set-based edits for scripted imports: each is a handful of statements
+    // in one transaction whatever the input size, and emits tagsChanged once
+    // instead of per-image signals. Return the number of rows changed, or -1
+    int registerImages(const QStringList& imagePaths);
+    int addImageTags(const QVector<QPair<QString, qint64>>& assignments);
+    int removeImageTags(const QVector<QPair<QString, qint64>>& assignments);
+    int setRatings(const QHash<QString, int>& ratings);   // 0 clears
+    
+    TagDatabaseStats databaseStats() const;
+    
+    // Tag and image-tag cache rows
+    void reportMemory(MemoryReport& report) const;
+    
     // Tag hierarchy / combining
     bool setTagParent(qint64 tagId, qint64 parentId);
     bool groupTagsUnderParent(const QString& parentName, const QStringList& childNames);
@@ -127,6 +166,9 @@ public:
     // Returns image_path → sequence_id for every sequence member
     QHash<QString, qint64> allImageSequenceIds() const;
     bool removeFromSequence(const QString& imagePath);
+    // Same for many images (e.g. after a bulk delete); one transaction and
+    // at most one sequencesChanged
+    bool removeFromSequences(const QStringList& imagePaths);
 
 Q_SIGNALS:
     void tagCreated(qint64 tagId, const QString& name);
@@ -136,6 +178,9 @@ Q_SIGNALS:
     void tagHotkeyChanged(qint64 tagId, const QString& hotkey);
     void imageTagged(const QString& imagePath, qint64 tagId);
     void imageUntagged(const QString& imagePath, qint64 tagId);
+    // Follows imageTagged/imageUntagged with how the tag's image count
+    // moved: 1 newly tagged, 0 tagged again (only tagged_at changed), -1 removed
+    void tagUsageChanged(const QString& imagePath, qint64 tagId, int delta);
     void imagePathUpdated(const QString& oldPath, const QString& newPath);
     void tagAlbumPathChanged(qint64 tagId, const QString& albumPath);
     void tagsChanged();
@@ -152,6 +197,10 @@ private:
     bool createTables();
     qint64 imageId(const QString& imagePath) const;
     qint64 getOrCreateImageId(const QString& imagePath);
+    bool stageImageTags(const QVector<QPair<QString, qint64>>& assignments);
+    bool stagePaths(const QStringList& imagePaths);
+    qint64 totalChanges() const;
+    void rebuildCompletionIndex();
 
 private:
     static TagManager* s_instance;
@@ -162,6 +211,8 @@ private:
     // In-memory cache
     mutable QHash<qint64, Tag> m_tagCache;
     mutable QHash<QString, QSet<qint64>> m_imageTagCache;
+    
+    TagCompletionIndex m_completionIndex;
 };
 
 } // namespace FullFrame
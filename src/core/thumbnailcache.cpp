@@ -8,6 +8,9 @@
  */
 
 #include "thumbnailcache.h"
+#include "perfcounters.h"
+#include "eventtrace.h"
+#include "memoryreport.h"
 #include <QThread>
 #include <QApplication>
 
@@ -29,8 +32,13 @@ void ThumbnailCache::cleanup()
     s_instance = nullptr;
 }
 
+namespace {
+constexpr int PreviewBudgetKiB = 16 * 1024;   // ~1800 previews at 48px
+}
+
 ThumbnailCache::ThumbnailCache(QObject* parent)
     : QObject(parent)
+    , m_previewCache(PreviewBudgetKiB)
 {
 }
 
@@ -43,6 +51,7 @@ ThumbnailCache::~ThumbnailCache()
 
 const QImage* ThumbnailCache::retrieveImage(const QString& cacheKey) const
 {
+    EventTrace::Span span("retrieveImage", "cache");
     QWriteLocker locker(&m_imageLock);
     
     auto* nonConstThis = const_cast<ThumbnailCache*>(this);
@@ -52,13 +61,16 @@ const QImage* ThumbnailCache::retrieveImage(const QString& cacheKey) const
         nonConstThis->m_imageLRU.erase(it.value().second);
         nonConstThis->m_imageLRU.push_front(cacheKey);
         it.value().second = nonConstThis->m_imageLRU.begin();
+        PerfCounters::add(PerfCounters::ImageCacheHit);
         return &it.value().first;
     }
+    PerfCounters::add(PerfCounters::ImageCacheMiss);
     return nullptr;
 }
 
 void ThumbnailCache::putImage(const QString& cacheKey, const QImage& image)
 {
+    EventTrace::Span span("putImage", "cache");
     QWriteLocker locker(&m_imageLock);
     
     // Check if already exists
@@ -114,6 +126,7 @@ void ThumbnailCache::evictImagesIfNeeded()
 
 const QPixmap* ThumbnailCache::retrievePixmap(const QString& cacheKey) const
 {
+    EventTrace::Span span("retrievePixmap", "cache");
     Q_ASSERT(QThread::currentThread() == qApp->thread());
     
     QMutexLocker locker(&m_pixmapLock);
@@ -124,13 +137,16 @@ const QPixmap* ThumbnailCache::retrievePixmap(const QString& cacheKey) const
         nonConstThis->m_pixmapLRU.erase(it.value().second);
         nonConstThis->m_pixmapLRU.push_front(cacheKey);
         it.value().second = nonConstThis->m_pixmapLRU.begin();
+        PerfCounters::add(PerfCounters::PixmapCacheHit);
         return &it.value().first;
     }
+    PerfCounters::add(PerfCounters::PixmapCacheMiss);
     return nullptr;
 }
 
 void ThumbnailCache::putPixmap(const QString& cacheKey, const QPixmap& pixmap)
 {
+    EventTrace::Span span("putPixmap", "cache");
     Q_ASSERT(QThread::currentThread() == qApp->thread());
     
     QMutexLocker locker(&m_pixmapLock);
@@ -182,6 +198,34 @@ void ThumbnailCache::evictPixmapsIfNeeded()
     }
 }
 
+// ============== Preview Cache ==============
+
+bool ThumbnailCache::retrievePreview(const QString& filePath, QImage& preview) const
+{
+    EventTrace::Span span("retrievePreview", "cache");
+    QMutexLocker locker(&m_previewLock);
+    const QImage* cached = m_previewCache.object(filePath);
+    if (!cached) {
+        return false;
+    }
+    preview = *cached;
+    return true;
+}
+
+void ThumbnailCache::putPreview(const QString& filePath, const QImage& preview)
+{
+    EventTrace::Span span("putPreview", "cache");
+    const int cost = int(qMax<qint64>(1, preview.sizeInBytes() / 1024));
+    QMutexLocker locker(&m_previewLock);
+    m_previewCache.insert(filePath, new QImage(preview), cost);
+}
+
+bool ThumbnailCache::hasPreview(const QString& filePath) const
+{
+    QMutexLocker locker(&m_previewLock);
+    return m_previewCache.contains(filePath);
+}
+
 // ============== Cache Management ==============
 
 void ThumbnailCache::setImageCacheSize(int maxImages)
@@ -208,6 +252,10 @@ void ThumbnailCache::clearAll()
         m_pixmapCache.clear();
         m_pixmapLRU.clear();
     }
+    {
+        QMutexLocker locker(&m_previewLock);
+        m_previewCache.clear();
+    }
     Q_EMIT cacheCleared();
 }
 
@@ -233,6 +281,38 @@ quint64 ThumbnailCache::imageCacheBytes() const
     return bytes;
 }
 
+void ThumbnailCache::reportMemory(MemoryReport& report) const
+{
+    using ImageEntry = std::pair<QImage, std::list<QString>::iterator>;
+    using PixmapEntry = std::pair<QPixmap, std::list<QString>::iterator>;
+    // The LRU lists hold shared copies of the keys: one node each, no text
+    constexpr qint64 LruNodeBytes = sizeof(QString) + 2 * sizeof(void*);
+
+    {
+        QReadLocker locker(&m_imageLock);
+        qint64 bytes = MemoryReport::hashBytes(m_imageCache.size(), sizeof(QString) + sizeof(ImageEntry))
+                     + qint64(m_imageLRU.size()) * LruNodeBytes;
+        for (auto it = m_imageCache.cbegin(); it != m_imageCache.cend(); ++it) {
+            bytes += MemoryReport::stringBytes(it.key()) + report.imageBytes(it.value().first);
+        }
+        report.add("Thumbnail image cache", bytes, m_imageCache.size());
+    }
+    {
+        QMutexLocker locker(&m_pixmapLock);
+        qint64 bytes = MemoryReport::hashBytes(m_pixmapCache.size(), sizeof(QString) + sizeof(PixmapEntry))
+                     + qint64(m_pixmapLRU.size()) * LruNodeBytes;
+        for (auto it = m_pixmapCache.cbegin(); it != m_pixmapCache.cend(); ++it) {
+            bytes += MemoryReport::stringBytes(it.key()) + report.pixmapBytes(it.value().first);
+        }
+        report.add("Thumbnail pixmap cache", bytes, m_pixmapCache.size());
+    }
+    {
+        QMutexLocker locker(&m_previewLock);
+        report.add("Progressive preview cache", qint64(m_previewCache.totalCost()) * 1024,
+                   m_previewCache.size());
+    }
+}
+
 // ============== CacheLock ==============
 
 CacheLock::CacheLock(ThumbnailCache* cache)
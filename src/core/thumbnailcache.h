@@ -17,10 +17,13 @@
 #include <QHash>
 #include <QString>
 #include <QReadWriteLock>
+#include <QCache>
 #include <list>
 
 namespace FullFrame {
 
+class MemoryReport;
+
 /**
  * Thread-safe LRU cache for thumbnails
  * Similar to DigiKam's LoadingCache but simplified
@@ -45,6 +48,11 @@ public:
     void removePixmap(const QString& cacheKey);
     bool hasPixmap(const QString& cacheKey) const;
 
+    // Tiny progressive previews keyed by file path (thread-safe, byte-bounded)
+    bool retrievePreview(const QString& filePath, QImage& preview) const;
+    void putPreview(const QString& filePath, const QImage& preview);
+    bool hasPreview(const QString& filePath) const;
+
     // Cache management
     void setImageCacheSize(int maxImages);
     void setPixmapCacheSize(int maxPixmaps);
@@ -54,6 +62,9 @@ public:
     int imageCacheCount() const;
     int pixmapCacheCount() const;
     quint64 imageCacheBytes() const;
+    
+    // Image, pixmap and preview cache rows (GUI thread)
+    void reportMemory(MemoryReport& report) const;
 
 Q_SIGNALS:
     void cacheCleared();
@@ -83,6 +94,10 @@ private:
     std::list<QString> m_pixmapLRU;
     QHash<QString, std::pair<QPixmap, std::list<QString>::iterator>> m_pixmapCache;
     int m_maxPixmaps = 500;  // Increased for large collections
+
+    // Preview cache - cost in KiB, separate so previews never evict full thumbnails
+    mutable QMutex m_previewLock;
+    mutable QCache<QString, QImage> m_previewCache;
 };
 
 /**
@@ -10,6 +10,7 @@
  */
 
 #include "thumbnailcreator.h"
+#include "eventtrace.h"
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
@@ -75,8 +76,17 @@ QImage ThumbnailCreator::create(const ThumbnailInfo& info) const
 
     // 1. Try disk cache first
     if (m_useDiskCache) {
-        QImage cached = loadFromDiskCache(info.filePath);
+        QImage cached;
+        {
+            EventTrace::Span span("diskCacheLoad", "io");
+            cached = loadFromDiskCache(info.filePath);
+        }
         if (!cached.isNull()) {
+            // Every size in a "normal"/"large" class shares one disk entry
+            if (cached.width() > m_thumbnailSize || cached.height() > m_thumbnailSize) {
+                cached = cached.scaled(m_thumbnailSize, m_thumbnailSize,
+                                       Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            }
             return cached;
         }
     }
@@ -88,18 +98,21 @@ QImage ThumbnailCreator::create(const ThumbnailInfo& info) const
     }
 
     // 2. Create thumbnail based on media type
-    switch (mediaType) {
-        case MediaType::Image:
-            thumbnail = createImageThumbnail(info.filePath);
-            break;
-        case MediaType::Video:
-            thumbnail = createVideoThumbnail(info.filePath);
-            break;
-        case MediaType::Audio:
-            thumbnail = createAudioPlaceholder(info.filePath);
-            break;
-        default:
-            return QImage();
+    {
+        EventTrace::Span span("decode", "decode");
+        switch (mediaType) {
+            case MediaType::Image:
+                thumbnail = createImageThumbnail(info.filePath);
+                break;
+            case MediaType::Video:
+                thumbnail = createVideoThumbnail(info.filePath);
+                break;
+            case MediaType::Audio:
+                thumbnail = createAudioPlaceholder(info.filePath);
+                break;
+            default:
+                return QImage();
+        }
     }
 
     if (thumbnail.isNull()) {
@@ -108,6 +121,7 @@ QImage ThumbnailCreator::create(const ThumbnailInfo& info) const
 
     // 3. Final scale to exact size
     if (thumbnail.width() > m_thumbnailSize || thumbnail.height() > m_thumbnailSize) {
+        EventTrace::Span span("scale", "decode");
         thumbnail = thumbnail.scaled(
             m_thumbnailSize, m_thumbnailSize,
             Qt::KeepAspectRatio,
@@ -117,12 +131,50 @@ QImage ThumbnailCreator::create(const ThumbnailInfo& info) const
 
     // 4. Save to disk cache
     if (m_useDiskCache && !thumbnail.isNull()) {
+        EventTrace::Span span("diskCacheSave", "io");
         saveToDiskCache(info.filePath, thumbnail);
     }
 
     return thumbnail;
 }
 
+QImage ThumbnailCreator::createPreview(const QString& filePath) const
+{
+    EventTrace::Span span("decodePreview", "decode");
+    if (getMediaType(filePath) != MediaType::Image) {
+        return QImage();
+    }
+
+    // A disk-cached thumbnail loads about as fast as the preview would
+    if (m_useDiskCache) {
+        QString cachePath = diskCachePath(filePath);
+        if (!cachePath.isEmpty() && QFile::exists(cachePath)) {
+            return QImage();
+        }
+    }
+
+    QImageReader reader(filePath);
+    reader.setAutoTransform(true);
+
+    // Only JPEG has a genuinely cheap reduced decode: with a scaled size set,
+    // libjpeg decodes at 1/2, 1/4 or 1/8 scale in the DCT domain. Other
+    // formats would pay for a full decode twice.
+    if (reader.format() != "jpeg") {
+        return QImage();
+    }
+
+    QSize originalSize = reader.size();
+    if (!originalSize.isValid()) {
+        return QImage();
+    }
+    if (originalSize.width() > PreviewSize || originalSize.height() > PreviewSize) {
+        reader.setScaledSize(originalSize.scaled(PreviewSize, PreviewSize, Qt::KeepAspectRatio));
+    }
+    reader.setQuality(0);   // Favour speed over filtering quality
+
+    return reader.read();
+}
+
 QImage ThumbnailCreator::createImageThumbnail(const QString& filePath) const
 {
     // Try embedded EXIF thumbnail (fastest for JPEGs)
@@ -61,6 +61,12 @@ public:
     QImage create(const QString& filePath) const;
     QImage create(const ThumbnailInfo& info) const;
 
+    // Tiny preview for progressive display, decoded at reduced scale.
+    // Returns a null image when there is no cheap path (non-JPEG sources,
+    // or a full thumbnail already sitting in the disk cache).
+    QImage createPreview(const QString& filePath) const;
+    static constexpr int PreviewSize = 48;
+
     // Load from disk cache (FreeDesktop standard location)
     QImage loadFromDiskCache(const QString& filePath) const;
     
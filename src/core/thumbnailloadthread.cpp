@@ -10,6 +10,9 @@
 
 #include "thumbnailloadthread.h"
 #include "thumbnailcache.h"
+#include "perfcounters.h"
+#include "eventtrace.h"
+#include "memoryreport.h"
 #include <QApplication>
 #include <QDebug>
 
@@ -27,9 +30,30 @@ ThumbnailWorker::ThumbnailWorker(const ThumbnailTask& task)
 
 void ThumbnailWorker::run()
 {
+    EventTrace::Span span(m_task.preview ? "previewWorker" : "thumbnailWorker", "thumb");
     ThumbnailResult result;
     result.filePath = m_task.filePath;
     result.cacheKey = m_task.cacheKey;
+    result.size = m_task.size;
+    result.preview = m_task.preview;
+
+    if (m_task.preview) {
+        // m_task.size is the full thumbnail size; the creator needs it to
+        // find an existing disk-cached thumbnail, in which case it skips
+        ThumbnailCreator creator(m_task.size);
+        result.image = creator.createPreview(m_task.filePath);
+        result.success = !result.image.isNull();
+        if (result.success) {
+            ThumbnailCache::instance()->putPreview(m_task.filePath, result.image);
+        }
+        Q_EMIT finished(result);
+        return;
+    }
+
+    // Cancelled while queued (cancelSize); nobody is waiting for it
+    if (!ThumbnailLoadThread::instance()->isPending(m_task.cacheKey)) {
+        return;
+    }
 
     // Create thumbnail
     ThumbnailCreator creator(m_task.size);
@@ -92,7 +116,7 @@ void ThumbnailLoadThread::load(const ThumbnailTask& task)
         ThumbnailCache::instance()->hasPixmap(task.cacheKey)) {
         // Already cached — notify without creating a QPixmap.
         // The model's data() will convert from image cache lazily during paint.
-        Q_EMIT thumbnailAvailable(task.filePath);
+        Q_EMIT thumbnailAvailable(task.filePath, task.size);
         return;
     }
 
@@ -136,6 +160,27 @@ void ThumbnailLoadThread::cancelAll()
     m_threadPool->clear();
 }
 
+void ThumbnailLoadThread::cancelSize(int size)
+{
+    // Queued workers whose key is gone exit without decoding; the pool
+    // itself is shared with other size classes, so it isn't cleared
+    const QString suffix = QString("@%1").arg(size);
+    QMutexLocker locker(&m_pendingMutex);
+    for (auto it = m_pendingKeys.begin(); it != m_pendingKeys.end();) {
+        if (it->endsWith(suffix)) {
+            it = m_pendingKeys.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool ThumbnailLoadThread::isPending(const QString& cacheKey) const
+{
+    QMutexLocker locker(&m_pendingMutex);
+    return m_pendingKeys.contains(cacheKey);
+}
+
 bool ThumbnailLoadThread::find(const QString& filePath, int size, QPixmap& pixmap)
 {
     QString cacheKey = makeCacheKey(filePath, size);
@@ -151,6 +196,7 @@ bool ThumbnailLoadThread::find(const QString& filePath, int size, QPixmap& pixma
     const QImage* cachedImage = ThumbnailCache::instance()->retrieveImage(cacheKey);
     if (cachedImage && !cachedImage->isNull()) {
         pixmap = QPixmap::fromImage(*cachedImage);
+        PerfCounters::add(PerfCounters::PixmapFromImage);
         // Cache the pixmap for future use
         ThumbnailCache::instance()->putPixmap(cacheKey, pixmap);
         return true;
@@ -176,6 +222,24 @@ bool ThumbnailLoadThread::find(const QString& filePath, int size, QImage& image)
     return false;
 }
 
+int ThumbnailLoadThread::pendingCount() const
+{
+    QMutexLocker locker(&m_pendingMutex);
+    return m_pendingKeys.size();
+}
+
+void ThumbnailLoadThread::reportMemory(MemoryReport& report) const
+{
+    QMutexLocker locker(&m_pendingMutex);
+    // Each pending key is also a queued worker carrying the task's path and key
+    qint64 bytes = MemoryReport::hashBytes(m_pendingKeys.size(), sizeof(QString))
+                 + qint64(m_pendingKeys.size()) * qint64(sizeof(ThumbnailWorker));
+    for (const QString& key : m_pendingKeys) {
+        bytes += 2 * MemoryReport::stringBytes(key);
+    }
+    report.add("Thumbnail loader queue", bytes, m_pendingKeys.size());
+}
+
 void ThumbnailLoadThread::setMaxThreads(int threads)
 {
     m_threadPool->setMaxThreadCount(threads);
@@ -197,13 +261,11 @@ void ThumbnailLoadThread::scheduleTask(const ThumbnailTask& task)
         m_pendingKeys.insert(task.cacheKey);
     }
 
-    // Create worker
-    ThumbnailWorker* worker = new ThumbnailWorker(task);
-    
-    // Connect signal (Qt::QueuedConnection ensures delivery in main thread)
-    connect(worker, &ThumbnailWorker::finished,
-            this, &ThumbnailLoadThread::slotWorkerFinished,
-            Qt::QueuedConnection);
+    PerfCounters::add(PerfCounters::LoadsScheduled);
+
+    if (m_progressive) {
+        schedulePreview(task);
+    }
     
     // Set priority
     int queuePriority = 0;
@@ -213,18 +275,67 @@ void ThumbnailLoadThread::scheduleTask(const ThumbnailTask& task)
         case LoadPriority::High:   queuePriority = 1;  break;
     }
     
-    // Start worker
+    startWorker(task, queuePriority);
+}
+
+void ThumbnailLoadThread::schedulePreview(const ThumbnailTask& task)
+{
+    // Off-screen preloads are never seen half-loaded, and tiny thumbnails
+    // gain nothing from a preview pass
+    if (task.priority == LoadPriority::Low || task.size <= ThumbnailCreator::PreviewSize * 2) {
+        return;
+    }
+    if (!ThumbnailCreator::isImageFile(task.filePath) ||
+        ThumbnailCache::instance()->hasPreview(task.filePath)) {
+        return;
+    }
+
+    ThumbnailTask previewTask = task;
+    previewTask.preview = true;
+    previewTask.cacheKey = task.filePath + "@preview";
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        if (m_pendingKeys.contains(previewTask.cacheKey)) {
+            return;
+        }
+        m_pendingKeys.insert(previewTask.cacheKey);
+    }
+
+    // Previews jump every full decode, so a fast scroll through uncached
+    // rows fills in with recognisable images before any thumbnail lands
+    startWorker(previewTask, 2);
+}
+
+void ThumbnailLoadThread::startWorker(const ThumbnailTask& task, int queuePriority)
+{
+    ThumbnailWorker* worker = new ThumbnailWorker(task);
+    
+    // Connect signal (Qt::QueuedConnection ensures delivery in main thread)
+    connect(worker, &ThumbnailWorker::finished,
+            this, &ThumbnailLoadThread::slotWorkerFinished,
+            Qt::QueuedConnection);
+    
     m_threadPool->start(worker, queuePriority);
 }
 
 void ThumbnailLoadThread::slotWorkerFinished(const ThumbnailResult& result)
 {
+    EventTrace::Span span("slotWorkerFinished", "signal");
     // Remove from pending
     {
         QMutexLocker locker(&m_pendingMutex);
         m_pendingKeys.remove(result.cacheKey);
     }
 
+    if (result.preview) {
+        // A missing preview is not a failure; the thumbnail is still coming
+        if (result.success) {
+            Q_EMIT previewAvailable(result.filePath);
+        }
+        return;
+    }
+    PerfCounters::add(PerfCounters::LoadsCompleted);
+
     if (result.success) {
         Q_EMIT thumbnailLoaded(result.filePath, result.image);
         
@@ -238,9 +349,9 @@ void ThumbnailLoadThread::slotWorkerFinished(const ThumbnailResult& result)
         //
         // Instead, the model's data() converts lazily during paint — only for
         // the ~20-30 items actually visible on screen.
-        Q_EMIT thumbnailAvailable(result.filePath);
+        Q_EMIT thumbnailAvailable(result.filePath, result.size);
     } else {
-        Q_EMIT thumbnailFailed(result.filePath);
+        Q_EMIT thumbnailFailed(result.filePath, result.size);
     }
 }
 
@@ -24,6 +24,8 @@
 
 namespace FullFrame {
 
+class MemoryReport;
+
 /**
  * Priority levels for thumbnail loading
  */
@@ -43,6 +45,7 @@ struct ThumbnailTask
     QString cacheKey;
     int size = 256;
     LoadPriority priority = LoadPriority::Normal;
+    bool preview = false;       // Tiny progressive preview pass, not the thumbnail
     
     bool operator==(const ThumbnailTask& other) const {
         return cacheKey == other.cacheKey;
@@ -56,8 +59,10 @@ struct ThumbnailResult
 {
     QString filePath;
     QString cacheKey;
+    int size = 0;
     QImage image;
     bool success = false;
+    bool preview = false;
 };
 
 /**
@@ -104,14 +109,28 @@ public:
     void cancel(const QString& filePath);
     void cancelAll();
     
+    // Drop queued loads at one size (e.g. the grid's old zoom level);
+    // loads at other sizes keep their place in the queue
+    void cancelSize(int size);
+    
     // Check if thumbnail is ready in cache
     bool find(const QString& filePath, int size, QPixmap& pixmap);
     bool find(const QString& filePath, int size, QImage& image);
     
+    // Number of scheduled loads that have not reported back yet
+    int pendingCount() const;
+    
+    // Queued and running tasks
+    void reportMemory(MemoryReport& report) const;
+    
     // Configuration
     void setMaxThreads(int threads);
     void setThumbnailSize(int size);
     int thumbnailSize() const { return m_defaultSize; }
+    
+    // Progressive loading: decode a tiny preview ahead of each thumbnail
+    void setProgressive(bool enabled) { m_progressive = enabled; }
+    bool isProgressive() const { return m_progressive; }
 
 Q_SIGNALS:
     // Emitted when thumbnail is ready (image version - any thread)
@@ -123,10 +142,14 @@ Q_SIGNALS:
     // Lightweight notification that a thumbnail is now available in the image cache.
     // Unlike thumbnailReady, this does NOT create a QPixmap on the main thread,
     // so it avoids the expensive QPixmap::fromImage() burst during initial loading.
-    void thumbnailAvailable(const QString& filePath);
+    // `size` tells the grid's size class from others (the tagging strip).
+    void thumbnailAvailable(const QString& filePath, int size);
     
     // Emitted on load failure
-    void thumbnailFailed(const QString& filePath);
+    void thumbnailFailed(const QString& filePath, int size);
+    
+    // A tiny preview is in the preview cache; the thumbnail is still on its way
+    void previewAvailable(const QString& filePath);
 
 private Q_SLOTS:
     void slotWorkerFinished(const ThumbnailResult& result);
@@ -139,7 +162,11 @@ private:
     ThumbnailLoadThread(const ThumbnailLoadThread&) = delete;
     ThumbnailLoadThread& operator=(const ThumbnailLoadThread&) = delete;
 
+    friend class ThumbnailWorker;
+    bool isPending(const QString& cacheKey) const;
     void scheduleTask(const ThumbnailTask& task);
+    void schedulePreview(const ThumbnailTask& task);
+    void startWorker(const ThumbnailTask& task, int queuePriority);
     QString makeCacheKey(const QString& filePath, int size) const;
 
 private:
@@ -147,6 +174,7 @@ private:
 
     QThreadPool* m_threadPool;
     int m_defaultSize = 256;
+    bool m_progressive = true;
     
     // Track pending tasks to avoid duplicates
     mutable QMutex m_pendingMutex;
@@ -16,52 +16,32 @@
 #include <QDebug>
 #include <QTimer>
 #include <QIcon>
-#include <iostream>
-#include <fstream>
-#include <chrono>
 
 #include "mainwindow.h"
 #include "thumbnailcache.h"
 #include "thumbnailloadthread.h"
+#include "previewloader.h"
+#include "imagetileloader.h"
+#include "animationloader.h"
 #include "tagmanager.h"
-
-// #region agent log
-inline void agent_log(const std::string& message, const std::string& hypothesisId, const std::string& location, const std::string& data = "{}") {
-    std::ofstream logFile("c:\\code\\FullFrame\\.cursor\\debug.log", std::ios::app);
-    if (logFile.is_open()) {
-        auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
-        logFile << "{\"sessionId\":\"debug-session\",\"runId\":\"run1\",\"hypothesisId\":\"" << hypothesisId 
-                << "\",\"location\":\"" << location << "\",\"message\":\"" << message 
-                << "\",\"data\":" << data << ",\"timestamp\":" << now << "}" << std::endl;
-    } else {
-        std::cerr << "FAILED TO OPEN LOG FILE: c:\\code\\FullFrame\\.cursor\\debug.log" << std::endl;
-    }
-}
-// #endregion
+#include "fileoperationqueue.h"
+#include "startuptrace.h"
 
 using namespace FullFrame;
 
 int main(int argc, char *argv[])
 {
-    // #region agent log
-    agent_log("Main started", "A/D", "main.cpp:27");
-    // #endregion
-    std::cout << "Starting FullFrame..." << std::endl;
+    StartupTrace::begin();
     
     // Enable high DPI support
     QApplication::setHighDpiScaleFactorRoundingPolicy(
         Qt::HighDpiScaleFactorRoundingPolicy::PassThrough);
 
-    // #region agent log
-    agent_log("Creating QApplication", "A", "main.cpp:35");
-    // #endregion
     QApplication app(argc, argv);
-    // #region agent log
-    agent_log("QApplication created", "A", "main.cpp:37");
-    // #endregion
     
-    std::cout << "QApplication created" << std::endl;
+    // --trace-startup prints the per-phase startup times
+    StartupTrace::setVerbose(app.arguments().contains("--trace-startup"));
+    StartupTrace::mark("qapplication");
     
     // Application metadata
     app.setApplicationName("FullFrame");
@@ -94,58 +74,30 @@ int main(int argc, char *argv[])
     darkPalette.setColor(QPalette::Disabled, QPalette::ButtonText, QColor(128, 128, 128));
     app.setPalette(darkPalette);
 
-    std::cout << "Palette set" << std::endl;
-
-    // Initialize singletons
-    // #region agent log
-    agent_log("Initializing singletons", "B", "main.cpp:70");
-    // #endregion
-    ThumbnailCache::instance();
-    ThumbnailLoadThread::instance();
+    StartupTrace::mark("style");
 
-    // Configure cache sizes based on available memory
-    // Default: 500 images, 200 pixmaps
+    // The cache is created here because loader threads call instance() and
+    // must not race its construction. ThumbnailLoadThread, the tagging
+    // widgets (and with them multimedia) and ffmpeg discovery start on
+    // first use.
     ThumbnailCache::instance()->setImageCacheSize(500);
     ThumbnailCache::instance()->setPixmapCacheSize(200);
 
-    std::cout << "Creating MainWindow..." << std::endl;
-    
-    // Create and show main window
-    // #region agent log
-    agent_log("Creating MainWindow", "C", "main.cpp:81");
-    // #endregion
+    // The window is shown empty; the last folder is reopened after its
+    // first paint (MainWindow::restoreLastFolder), which ends the trace
     MainWindow mainWindow;
-    // #region agent log
-    agent_log("MainWindow created", "C", "main.cpp:83");
-    // #endregion
-    
-    std::cout << "MainWindow created, showing..." << std::endl;
+    StartupTrace::mark("window-style");
     
     mainWindow.show();
-    
-    // Stability monitor: prints heartbeat to terminal for the first 10 seconds
-    QTimer heartbeatTimer;
-    int elapsed = 0;
-    QObject::connect(&heartbeatTimer, &QTimer::timeout, [&elapsed]() {
-        elapsed++;
-        if (elapsed <= 10) {
-            std::cout << "FullFrame stability monitor: " << elapsed << "s (running)" << std::endl;
-        }
-        if (elapsed == 10) {
-            std::cout << "SUCCESS: Application has passed the 10-second stability test!" << std::endl;
-        }
-    });
-    heartbeatTimer.start(1000);
+    StartupTrace::mark("show");
 
-    // #region agent log
-    agent_log("Starting event loop", "A/E", "main.cpp:101");
-    // #endregion
     int result = app.exec();
-    // #region agent log
-    agent_log("Event loop finished", "A/E", "main.cpp:103", "{\"result\":" + std::to_string(result) + "}");
-    // #endregion
 
     // Cleanup singletons
+    FileOperationQueue::cleanup();   // Cancels queued jobs, waits for the file in flight
+    AnimationLoader::cleanup();
+    ImageTileLoader::cleanup();
+    PreviewLoader::cleanup();
     ThumbnailLoadThread::cleanup();
     ThumbnailCache::cleanup();
     TagManager::cleanup();
@@ -10,6 +10,16 @@
 #include "thumbnailcache.h"
 #include "thumbnailloadthread.h"
 #include "tagmanager.h"
+#include "framestatsoverlay.h"
+#include "hotkeylatency.h"
+#include "fileoperationqueue.h"
+#include "fileexporter.h"
+#include "startuptrace.h"
+#include "eventtrace.h"
+#include "memoryreport.h"
+#include "previewloader.h"
+#include "imagetileloader.h"
+#include "animationloader.h"
 
 #include <QApplication>
 #include <QMenuBar>
@@ -40,6 +50,10 @@
 #include <QDialog>
 #include <QPlainTextEdit>
 #include <QClipboard>
+#include <QJsonDocument>
+#include <QLocale>
+
+#include <utility>
 
 #ifdef Q_OS_WIN
 #include <Windows.h>
@@ -62,8 +76,10 @@ MainWindow::MainWindow(QWidget* parent)
     setupToolBar();
     setupStatusBar();
     setupShortcuts();
+    StartupTrace::mark("window-widgets");
     
     loadSettings();
+    StartupTrace::mark("settings");
 
     // Style the main window
     setStyleSheet(R"(
@@ -174,10 +190,8 @@ void MainWindow::setupUI()
     m_gridView->setImageModel(m_model);
     m_viewStack->addWidget(m_gridView);
     
-    // Tagging mode (index 1)
-    m_taggingMode = new TaggingModeWidget(this);
-    m_taggingMode->setModel(m_model);
-    m_viewStack->addWidget(m_taggingMode);
+    // Tagging mode (index 1) is created on first use; it owns the media
+    // preview and with it the multimedia backend
     
     m_splitter->addWidget(m_viewStack);
     m_splitter->setStretchFactor(0, 0);
@@ -220,7 +234,12 @@ void MainWindow::setupUI()
             this, &MainWindow::deleteSelectedImages);
     connect(m_gridView, &ImageGridView::hotkeyPressed,
             this, [this](const QString& key) {
-                m_tagSidebar->handleHotkey(key);
+                HotkeyLatency::begin(key);
+                if (m_tagSidebar->handleHotkey(key)) {
+                    HotkeyLatency::end();
+                } else {
+                    HotkeyLatency::cancel();
+                }
             });
     connect(m_tagSidebar, &TagSidebar::tagFilterChanged,
             this, &MainWindow::onTagFilterChanged);
@@ -233,16 +252,6 @@ void MainWindow::setupUI()
                 }
             });
     
-    // Tagging mode connections
-    connect(m_taggingMode, &TaggingModeWidget::selectionChanged,
-            this, [this](const QStringList& paths) {
-                m_tagSidebar->setSelectedImagePaths(paths);
-            });
-    connect(m_taggingMode, &TaggingModeWidget::openRequested,
-            this, &MainWindow::onImageActivated);
-    connect(m_taggingMode, &TaggingModeWidget::contextMenuRequested,
-            this, &MainWindow::onContextMenu);
-    
     // Sidebar tagging mode button
     connect(m_tagSidebar, &TagSidebar::taggingModeRequested,
             this, [this](bool enabled) {
@@ -279,6 +288,28 @@ void MainWindow::setupUI()
     qApp->installEventFilter(this);
 }
 
+TaggingModeWidget* MainWindow::ensureTaggingMode()
+{
+    if (m_taggingMode) {
+        return m_taggingMode;
+    }
+    
+    m_taggingMode = new TaggingModeWidget(this);
+    m_taggingMode->setModel(m_model);
+    m_taggingMode->setFrameStatsVisible(m_frameStatsAction->isChecked());
+    m_viewStack->addWidget(m_taggingMode);
+    
+    connect(m_taggingMode, &TaggingModeWidget::selectionChanged,
+            this, [this](const QStringList& paths) {
+                m_tagSidebar->setSelectedImagePaths(paths);
+            });
+    connect(m_taggingMode, &TaggingModeWidget::openRequested,
+            this, &MainWindow::onImageActivated);
+    connect(m_taggingMode, &TaggingModeWidget::contextMenuRequested,
+            this, &MainWindow::onContextMenu);
+    return m_taggingMode;
+}
+
 void MainWindow::setupMenuBar()
 {
     QMenuBar* menuBar = this->menuBar();
@@ -292,6 +323,16 @@ void MainWindow::setupMenuBar()
     
     fileMenu->addSeparator();
     
+    QAction* exportAction = fileMenu->addAction("&Export Selection...");
+    exportAction->setShortcut(QKeySequence("Ctrl+Shift+E"));
+    connect(exportAction, &QAction::triggered, this, &MainWindow::exportSelection);
+    
+    m_exportSidecarsAction = fileMenu->addAction("Write XMP &Sidecars on Export");
+    m_exportSidecarsAction->setCheckable(true);
+    m_exportSidecarsAction->setToolTip("Write tags and rating next to each exported file (photo.jpg.xmp)");
+    
+    fileMenu->addSeparator();
+    
     QAction* exitAction = fileMenu->addAction("E&xit");
     exitAction->setShortcut(QKeySequence::Quit);
     connect(exitAction, &QAction::triggered, this, &QWidget::close);
@@ -351,6 +392,23 @@ void MainWindow::setupMenuBar()
     m_toggleSidebarAction->setCheckable(true);
     m_toggleSidebarAction->setChecked(true);
     connect(m_toggleSidebarAction, &QAction::triggered, this, &MainWindow::toggleSidebar);
+    
+    viewMenu->addSeparator();
+    
+    m_frameStatsAction = viewMenu->addAction("Frame &Stats Overlay");
+    m_frameStatsAction->setShortcut(QKeySequence("Ctrl+Shift+P"));
+    m_frameStatsAction->setCheckable(true);
+    connect(m_frameStatsAction, &QAction::toggled, this, &MainWindow::setFrameStatsVisible);
+    
+    QAction* dumpFrameStatsAction = viewMenu->addAction("&Dump Frame Stats...");
+    connect(dumpFrameStatsAction, &QAction::triggered, this, &MainWindow::dumpFrameStats);
+    
+    m_traceAction = viewMenu->addAction("Record Performance &Trace");
+    m_traceAction->setCheckable(true);
+    connect(m_traceAction, &QAction::toggled, this, &MainWindow::setTraceRecording);
+    
+    QAction* memoryReportAction = viewMenu->addAction("&Memory Report...");
+    connect(memoryReportAction, &QAction::triggered, this, &MainWindow::showMemoryReport);
 
     // Preferences menu
     QMenu* prefsMenu = menuBar->addMenu("&Preferences");
@@ -652,6 +710,50 @@ void MainWindow::setupStatusBar()
     status->addWidget(m_loadingProgressBar);
     m_loadingProgressBar->hide();
 
+    // File operation progress (album moves, deletes)
+    m_fileOpLabel = new QLabel("", this);
+    m_fileOpLabel->setStyleSheet("color: #a0a0a0; margin-left: 8px;");
+    status->addWidget(m_fileOpLabel);
+    m_fileOpLabel->hide();
+
+    m_fileOpProgressBar = new QProgressBar(this);
+    m_fileOpProgressBar->setFixedWidth(120);
+    m_fileOpProgressBar->setFixedHeight(16);
+    m_fileOpProgressBar->setTextVisible(false);
+    m_fileOpProgressBar->setStyleSheet(m_loadingProgressBar->styleSheet());
+    status->addWidget(m_fileOpProgressBar);
+    m_fileOpProgressBar->hide();
+
+    m_fileOpCancelButton = new QPushButton("Cancel", this);
+    m_fileOpCancelButton->setFixedHeight(18);
+    m_fileOpCancelButton->setStyleSheet(R"(
+        QPushButton {
+            background-color: #3d3d3d;
+            color: #e0e0e0;
+            border: none;
+            border-radius: 3px;
+            padding: 0 8px;
+        }
+        QPushButton:hover {
+            background-color: #4d4d4d;
+        }
+    )");
+    connect(m_fileOpCancelButton, &QPushButton::clicked, this, [this]() {
+        FileOperationQueue::instance()->cancelAll();
+        m_exporter->cancel();
+    });
+    status->addWidget(m_fileOpCancelButton);
+    m_fileOpCancelButton->hide();
+
+    FileOperationQueue* fileOps = FileOperationQueue::instance();
+    connect(fileOps, &FileOperationQueue::batchFinished, this, &MainWindow::onFileBatchFinished);
+    connect(fileOps, &FileOperationQueue::progress, this, &MainWindow::onFileJobProgress);
+    connect(fileOps, &FileOperationQueue::jobFinished, this, &MainWindow::onFileJobFinished);
+
+    m_exporter = new FileExporter(this);
+    connect(m_exporter, &FileExporter::progress, this, &MainWindow::onExportProgress);
+    connect(m_exporter, &FileExporter::finished, this, &MainWindow::onExportFinished);
+
     m_selectionLabel = new QLabel("", this);
     status->addPermanentWidget(m_selectionLabel);
 
@@ -783,8 +885,8 @@ void MainWindow::openFolder(const QString& path)
     // Ratings are stored in the per-folder database
     loadRatingsFromDb();
 
+    // Reloads the sidebar's tags and counts for the new folder
     m_tagSidebar->setCurrentDirectoryPaths(m_model->allFilePaths());
-    m_tagSidebar->refresh();
 }
 
 // ============== Private Slots ==============
@@ -1134,10 +1236,12 @@ void MainWindow::showShortcutsDialog()
     html += row("F11", "Cycle fullscreen: Normal → Fullscreen → Immersive");
     html += row("Ctrl++ / Ctrl+-", "Zoom thumbnails in / out");
     html += row("F5 / Ctrl+R", "Refresh current folder");
+    html += row("Ctrl+Shift+P", "Frame stats overlay");
 
     html += header("SELECTION & FILES");
     html += row("Esc", "Clear selection");
     html += row("Delete", "Move selected to Recycle Bin");
+    html += row("Ctrl+Shift+E", "Export selected to a folder");
 
     html += header("RATINGS & FAVORITES");
     html += row("1 – 5", "Set star rating on selection (when Rating Hotkeys are on)");
@@ -1222,6 +1326,8 @@ void MainWindow::loadSettings()
         m_ratingHotkeysAction->setChecked(m_ratingHotkeysEnabled);
     }
     
+    m_exportSidecarsAction->setChecked(settings.value("exportSidecars", false).toBool());
+    
     // Load sort mode
     m_sortMode = settings.value("sortMode", "default").toString();
     if (m_sortCombo) {
@@ -1233,10 +1339,18 @@ void MainWindow::loadSettings()
         }
     }
     
-    QString lastFolder = settings.value("lastFolder").toString();
-    if (!lastFolder.isEmpty() && QDir(lastFolder).exists()) {
-        openFolder(lastFolder);
+    // Reopened once the window has painted (see restoreLastFolder)
+    m_folderToRestore = settings.value("lastFolder").toString();
+}
+
+void MainWindow::restoreLastFolder()
+{
+    const QString folder = std::exchange(m_folderToRestore, QString());
+    if (!folder.isEmpty() && QDir(folder).exists()) {
+        openFolder(folder);
+        StartupTrace::mark("restore-folder");
     }
+    StartupTrace::finish();
 }
 
 void MainWindow::saveSettings()
@@ -1255,6 +1369,8 @@ void MainWindow::saveSettings()
     
     // Save sort mode
     settings.setValue("sortMode", m_sortMode);
+    
+    settings.setValue("exportSidecars", m_exportSidecarsAction->isChecked());
 }
 
 void MainWindow::loadRatingsFromDb()
@@ -1343,6 +1459,13 @@ void MainWindow::keyPressEvent(QKeyEvent* event)
 
 bool MainWindow::eventFilter(QObject* obj, QEvent* event)
 {
+    // Startup: the folder scan waits until the empty window is on screen
+    if (!m_firstFramePainted && obj == this && event->type() == QEvent::Paint) {
+        m_firstFramePainted = true;
+        StartupTrace::mark("first-frame");
+        QTimer::singleShot(0, this, &MainWindow::restoreLastFolder);
+    }
+    
     if (event->type() == QEvent::KeyPress) {
         QKeyEvent* keyEvent = static_cast<QKeyEvent*>(event);
         
@@ -1399,25 +1522,37 @@ bool MainWindow::eventFilter(QObject* obj, QEvent* event)
         }
         
         if (!hotkeyText.isEmpty()) {
+            HotkeyLatency::begin(isCtrlPressed ? "Ctrl+" + hotkeyText : hotkeyText);
+            
             // Handle Ctrl+keybind for supertags
             if (isCtrlPressed) {
-                Tag tag = TagManager::instance()->tagByHotkey(hotkeyText);
+                Tag tag;
+                {
+                    HotkeyLatency::Scope lookup(HotkeyLatency::DbLookup);
+                    tag = TagManager::instance()->tagByHotkey(hotkeyText);
+                }
                 if (tag.isValid()) {
                     QStringList selectedPaths = m_gridView->selectedImagePaths();
                     if (!selectedPaths.isEmpty()) {
+                        HotkeyLatency::setImageCount(selectedPaths.size());
+                        
                         // Apply as supertag to all selected images
                         for (const QString& path : selectedPaths) {
+                            HotkeyLatency::Scope write(HotkeyLatency::DbWrite);
                             TagManager::instance()->setSupertag(path, tag.id, true);
                         }
+                        HotkeyLatency::end();
                         return true;
                     }
                 }
             } else {
                 // Regular tag hotkey handling
                 if (m_tagSidebar->handleHotkey(hotkeyText)) {
+                    HotkeyLatency::end();
                     return true;
                 }
             }
+            HotkeyLatency::cancel();
         }
     }
     
@@ -1610,46 +1745,13 @@ void MainWindow::deleteSelectedImages()
         }
     }
     
-    int successCount = 0;
-    int failCount = 0;
-    
-    for (const QString& path : selectedPaths) {
-        QFile file(path);
-        if (file.moveToTrash()) {
-            successCount++;
-            TagManager::instance()->removeFromSequence(path);
-        } else {
-            failCount++;
-        }
-    }
-    
-    // Refresh the view but maintain position
-    if (!m_currentFolder.isEmpty()) {
-        // Tell tagging mode to select the same row after model reset
-        if (m_isTaggingMode) {
-            m_taggingMode->setPendingSelectRow(currentRow);
-        }
-        
-        openFolder(m_currentFolder);
-        int totalAfter = m_model->rowCount();
-        
-        // Try to maintain selection at same row or closest (for gallery mode)
-        if (!m_isTaggingMode && totalAfter > 0) {
-            int newRow = qMin(currentRow, totalAfter - 1);
-            QModelIndex newIdx = m_model->index(newRow);
-            m_gridView->setCurrentIndex(newIdx);
-            m_gridView->scrollTo(newIdx);
-        }
-    }
-    
-    // Show result
-    if (failCount > 0) {
-        QMessageBox::warning(this, "Recycle Bin",
-            QString("Moved %1 file(s) to Recycle Bin. Failed for %2 file(s).")
-                .arg(successCount).arg(failCount));
-    } else {
-        m_statusLabel->setText(QString("Moved %1 file(s) to Recycle Bin").arg(successCount));
-    }
+    // The queue trashes in the background; each batch drops its rows from
+    // the model, and once the job is done the image now at the old row
+    // is selected
+    FileJob job;
+    job.kind = FileJob::Trash;
+    job.currentRow = qMax(0, currentRow);
+    m_fileJobs.insert(FileOperationQueue::instance()->moveToTrash(selectedPaths), job);
 }
 
 void MainWindow::exportDatabase()
@@ -1737,6 +1839,149 @@ void MainWindow::importDatabase()
     }
 }
 
+// ============== Frame Stats ==============
+
+void MainWindow::setFrameStatsVisible(bool visible)
+{
+    m_gridView->setFrameStatsVisible(visible);
+    if (m_taggingMode) {
+        m_taggingMode->setFrameStatsVisible(visible);
+    }
+}
+
+void MainWindow::dumpFrameStats()
+{
+    FrameStatsOverlay* overlays[] = { m_gridView->frameStats(),
+                                      m_taggingMode ? m_taggingMode->frameStats() : nullptr };
+    if (!overlays[0] && !overlays[1]) {
+        QMessageBox::information(this, "Dump Frame Stats",
+            "Turn on the frame stats overlay (Ctrl+Shift+P) and scroll around first.");
+        return;
+    }
+
+    bool ok = false;
+    int seconds = QInputDialog::getInt(this, "Dump Frame Stats", "Last N seconds:",
+                                       10, 1, FrameStatsOverlay::HistorySeconds, 1, &ok);
+    if (!ok) {
+        return;
+    }
+
+    QString savePath = QFileDialog::getSaveFileName(this, "Dump Frame Stats",
+        QDir::homePath() + "/fullframe_frames.json",
+        "JSON (*.json)");
+    if (savePath.isEmpty()) {
+        return;
+    }
+
+    QJsonObject root;
+    for (FrameStatsOverlay* overlay : overlays) {
+        if (overlay) {
+            root[overlay->name()] = overlay->toJson(seconds);
+        }
+    }
+    root["hotkeys"] = HotkeyLatency::toJson(seconds);
+
+    QFile file(savePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Indented)) < 0) {
+        QMessageBox::warning(this, "Dump Frame Stats",
+            QString("Failed to write %1:\n%2").arg(savePath, file.errorString()));
+        return;
+    }
+    m_statusLabel->setText(QString("Frame stats written to %1").arg(savePath));
+}
+
+void MainWindow::setTraceRecording(bool recording)
+{
+    if (recording) {
+        EventTrace::setEnabled(true);
+        m_statusLabel->setText("Recording performance trace - uncheck View > Record Performance Trace to save it");
+        return;
+    }
+
+    EventTrace::setEnabled(false);
+    QString savePath = QFileDialog::getSaveFileName(this, "Save Performance Trace",
+        QDir::homePath() + "/fullframe_trace.json",
+        "Chrome trace (*.json)");
+    if (savePath.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    if (!EventTrace::writeChromeTrace(savePath, &error)) {
+        QMessageBox::warning(this, "Save Performance Trace",
+            QString("Failed to write %1:\n%2").arg(savePath, error));
+        return;
+    }
+    m_statusLabel->setText(QString("Trace written to %1 (open in ui.perfetto.dev or chrome://tracing)").arg(savePath));
+}
+
+void MainWindow::showMemoryReport()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Memory Report");
+    dialog.resize(760, 520);
+    auto* layout = new QVBoxLayout(&dialog);
+
+    auto* reportEdit = new QPlainTextEdit;
+    reportEdit->setReadOnly(true);
+    reportEdit->setLineWrapMode(QPlainTextEdit::NoWrap);
+    reportEdit->setStyleSheet(
+        "QPlainTextEdit { background: #1a1a1a; color: #ddd; border: 1px solid #333; "
+        "border-radius: 4px; padding: 4px; font-family: Consolas, monospace; font-size: 12px; }"
+    );
+    layout->addWidget(reportEdit);
+
+    auto* buttonLayout = new QHBoxLayout;
+    auto* refreshBtn = new QPushButton("Refresh");
+    auto* copyBtn = new QPushButton("Copy JSON");
+    auto* closeBtn = new QPushButton("Close");
+    buttonLayout->addWidget(refreshBtn);
+    buttonLayout->addWidget(copyBtn);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(closeBtn);
+    layout->addLayout(buttonLayout);
+
+    QJsonObject lastJson;
+    auto refresh = [&]() {
+        // Owners before borrowers, so shared pixel data lands on the cache rows
+        MemoryReport report;
+        ThumbnailCache::instance()->reportMemory(report);
+        ThumbnailLoadThread::instance()->reportMemory(report);
+        m_model->reportMemory(report);
+        TagManager::instance()->reportMemory(report);
+        // The loaders start lazily; don't create them just to report nothing
+        if (PreviewLoader::hasInstance()) {
+            PreviewLoader::instance()->reportMemory(report);
+        }
+        if (ImageTileLoader::hasInstance()) {
+            ImageTileLoader::instance()->reportMemory(report);
+        }
+        if (AnimationLoader::hasInstance()) {
+            AnimationLoader::instance()->reportMemory(report);
+        }
+        if (m_taggingMode) {
+            m_taggingMode->reportMemory(report);
+        }
+
+        QString text = QString("%1 images shown, %2 loaded\n\n")
+                           .arg(m_model->rowCount()).arg(m_model->allFilePaths().size());
+        text += report.toText(m_lastMemoryReport);
+        reportEdit->setPlainText(text);
+        m_lastMemoryReport = report.bytesByRow();
+        lastJson = report.toJson();
+    };
+    refresh();
+
+    connect(refreshBtn, &QPushButton::clicked, &dialog, refresh);
+    connect(copyBtn, &QPushButton::clicked, &dialog, [&]() {
+        QApplication::clipboard()->setText(QString::fromUtf8(QJsonDocument(lastJson).toJson(QJsonDocument::Indented)));
+    });
+    connect(closeBtn, &QPushButton::clicked, &dialog, &QDialog::accept);
+
+    dialog.exec();
+}
+
 // ============== View Mode Switching ==============
 
 void MainWindow::toggleViewMode()
@@ -1751,7 +1996,7 @@ void MainWindow::toggleViewMode()
 void MainWindow::setGalleryMode()
 {
     // Get current image from tagging mode before switching
-    QString currentImage = m_taggingMode->currentImagePath();
+    QString currentImage = m_taggingMode ? m_taggingMode->currentImagePath() : QString();
     
     m_isTaggingMode = false;
     m_viewStack->setCurrentIndex(0);
@@ -1777,6 +2022,7 @@ void MainWindow::setTaggingMode()
         targetImage = selectedPaths.first();
     }
     
+    ensureTaggingMode();
     m_isTaggingMode = true;
     m_viewStack->setCurrentIndex(1);
     
@@ -1883,67 +2129,19 @@ void MainWindow::createAlbumFromSelection()
         return;
     }
     
-    // Move selected files into the album folder
-    int successCount = 0;
-    int failCount = 0;
-    QStringList movedNewPaths;
-    QStringList movedOldPaths;
-    
-    for (const QString& srcPath : selectedPaths) {
-        QFileInfo srcInfo(srcPath);
-        QString destPath = QDir(albumPath).filePath(srcInfo.fileName());
-        
-        // Handle filename conflicts
-        if (QFile::exists(destPath)) {
-            QString baseName = srcInfo.completeBaseName();
-            QString suffix = srcInfo.suffix();
-            int counter = 1;
-            do {
-                destPath = QDir(albumPath).filePath(
-                    QString("%1_%2.%3").arg(baseName).arg(counter).arg(suffix));
-                counter++;
-            } while (QFile::exists(destPath));
-        }
-        
-        if (QFile::rename(srcPath, destPath)) {
-            successCount++;
-            movedOldPaths << srcPath;
-            movedNewPaths << destPath;
-            
-            // Update the image path in the tag database
-            TagManager::instance()->updateImagePath(srcPath, destPath);
-        } else {
-            failCount++;
-        }
-    }
-    
-    // Create an album tag linked to this folder
-    if (successCount > 0) {
-        QString tagColor = "#5c6bc0";  // Indigo for album tags
-        qint64 tagId = TagManager::instance()->createTag(albumName, tagColor);
-        if (tagId >= 0) {
-            TagManager::instance()->setTagAlbumPath(tagId, albumPath);
-            
-            // Tag all moved images with the album tag
-            TagManager::instance()->tagImages(movedNewPaths, tagId);
-        }
-    }
-    
-    // Refresh the view
-    if (!m_currentFolder.isEmpty()) {
-        openFolder(m_currentFolder);
+    // Link the album tag first so moved files already count as album files;
+    // the moved files are tagged when the move finishes
+    QString tagColor = "#5c6bc0";  // Indigo for album tags
+    qint64 tagId = TagManager::instance()->createTag(albumName, tagColor);
+    if (tagId >= 0) {
+        TagManager::instance()->setTagAlbumPath(tagId, albumPath);
     }
     
-    // Show result
-    if (failCount > 0) {
-        QMessageBox::warning(this, "Create Album",
-            QString("Created album \"%1\". Moved %2 file(s), %3 failed.")
-                .arg(albumName).arg(successCount).arg(failCount));
-    } else {
-        m_statusLabel->setText(
-            QString("Created album \"%1\" with %2 images")
-                .arg(albumName).arg(successCount));
-    }
+    FileJob job;
+    job.kind = FileJob::CreateAlbum;
+    job.albumName = albumName;
+    job.albumTagId = tagId;
+    m_fileJobs.insert(FileOperationQueue::instance()->move(selectedPaths, albumPath), job);
 }
 
 void MainWindow::onImageTaggedForAlbum(const QString& imagePath, qint64 tagId)
@@ -1953,55 +2151,24 @@ void MainWindow::onImageTaggedForAlbum(const QString& imagePath, qint64 tagId)
         return;
     }
     
-    QFileInfo fileInfo(imagePath);
-    QDir albumDir(tag.albumPath);
-    
-    // Ensure album directory exists
-    if (!albumDir.exists()) {
-        QDir().mkpath(tag.albumPath);
-    }
-    
-    // Check if file is already in the album folder
-    if (fileInfo.absolutePath() == albumDir.absolutePath()) {
-        return;
-    }
-    
-    // Check if the source file still exists (might have been moved already)
-    if (!fileInfo.exists()) {
+    // Already in the album folder (e.g. tagged right after being moved there)
+    if (QFileInfo(imagePath).absolutePath() == QDir(tag.albumPath).absolutePath()) {
         return;
     }
     
-    // Determine destination path
-    QString destPath = albumDir.filePath(fileInfo.fileName());
-    
-    // Handle filename conflicts
-    if (QFile::exists(destPath)) {
-        QString baseName = fileInfo.completeBaseName();
-        QString suffix = fileInfo.suffix();
-        int counter = 1;
-        do {
-            destPath = albumDir.filePath(
-                QString("%1_%2.%3").arg(baseName).arg(counter).arg(suffix));
-            counter++;
-        } while (QFile::exists(destPath));
+    // Bulk tagging emits one imageTagged per file; collect them and queue
+    // one move per album once control returns to the event loop
+    if (m_pendingAlbumMoves.isEmpty()) {
+        QTimer::singleShot(0, this, &MainWindow::flushAlbumMoves);
     }
-    
-    // Move the file
-    if (QFile::rename(imagePath, destPath)) {
-        TagManager::instance()->updateImagePath(imagePath, destPath);
-        
-        // Schedule a batched view refresh (avoids refreshing per-file in bulk operations)
-        if (!m_albumRefreshTimer) {
-            m_albumRefreshTimer = new QTimer(this);
-            m_albumRefreshTimer->setSingleShot(true);
-            m_albumRefreshTimer->setInterval(300);
-            connect(m_albumRefreshTimer, &QTimer::timeout, this, [this]() {
-                if (!m_currentFolder.isEmpty()) {
-                    openFolder(m_currentFolder);
-                }
-            });
-        }
-        m_albumRefreshTimer->start();
+    m_pendingAlbumMoves[tag.albumPath].append(imagePath);
+}
+
+void MainWindow::flushAlbumMoves()
+{
+    const QHash<QString, QStringList> pending = std::exchange(m_pendingAlbumMoves, {});
+    for (auto it = pending.cbegin(); it != pending.cend(); ++it) {
+        startAlbumMove(it.value(), it.key(), QString());
     }
 }
 
@@ -2017,64 +2184,261 @@ void MainWindow::onTagLinkedToFolder(qint64 tagId, const QString& albumPath)
         return;
     }
     
-    QDir albumDir(albumPath);
-    if (!albumDir.exists()) {
-        QDir().mkpath(albumPath);
+    startAlbumMove(taggedImages, albumPath, TagManager::instance()->tag(tagId).name);
+}
+
+int MainWindow::startAlbumMove(const QStringList& imagePaths, const QString& albumPath, const QString& albumName)
+{
+    FileJob job;
+    job.kind = FileJob::AlbumMove;
+    job.albumName = albumName;
+    const int jobId = FileOperationQueue::instance()->move(imagePaths, albumPath);
+    m_fileJobs.insert(jobId, job);
+    return jobId;
+}
+
+void MainWindow::onFileBatchFinished(int jobId, const QVector<FileOperationResult>& results)
+{
+    auto job = m_fileJobs.find(jobId);
+    if (job == m_fileJobs.end()) {
+        return;
     }
     
-    int movedCount = 0;
+    if (job->kind == FileJob::Trash) {
+        QStringList removed;
+        removed.reserve(results.size());
+        for (const FileOperationResult& result : results) {
+            if (result.ok) {
+                removed.append(result.source);
+            }
+        }
+        TagManager::instance()->removeFromSequences(removed);
+        m_model->removeFiles(removed);
+        return;
+    }
     
-    for (const QString& imagePath : taggedImages) {
-        QFileInfo fileInfo(imagePath);
-        
-        // Skip if already in the album folder
-        if (fileInfo.absolutePath() == albumDir.absolutePath()) {
+    QHash<QString, QString> moves;
+    moves.reserve(results.size());
+    for (const FileOperationResult& result : results) {
+        if (!result.ok) {
             continue;
         }
+        moves.insert(result.source, result.destination);
         
-        // Skip if the source file doesn't exist
-        if (!fileInfo.exists()) {
-            continue;
+        if (m_favorites.remove(result.source)) {
+            m_favorites.insert(result.destination);
         }
+        auto rating = m_ratings.find(result.source);
+        if (rating != m_ratings.end()) {
+            const int value = rating.value();
+            m_ratings.erase(rating);
+            m_ratings.insert(result.destination, value);
+        }
+        if (job->kind == FileJob::CreateAlbum) {
+            job->movedPaths.append(result.destination);
+        }
+    }
+    
+    // One transaction for the batch, then rows are renamed/removed in place
+    TagManager::instance()->updateImagePaths(moves);
+    m_model->applyFileMoves(moves);
+}
+
+void MainWindow::onFileJobProgress(int jobId, int handled, int total)
+{
+    const FileJob job = m_fileJobs.value(jobId);
+    QString text;
+    if (job.kind == FileJob::Trash) {
+        text = QString("Moving to Recycle Bin... %1 of %2").arg(handled).arg(total);
+    } else if (!job.albumName.isEmpty()) {
+        text = QString("Moving to album \"%1\"... %2 of %3").arg(job.albumName).arg(handled).arg(total);
+    } else {
+        text = QString("Moving to album... %1 of %2").arg(handled).arg(total);
+    }
+    showFileOpProgress(text, handled, total);
+}
+
+void MainWindow::showFileOpProgress(const QString& text, int done, int total)
+{
+    m_fileOpLabel->setText(text);
+    m_fileOpProgressBar->setRange(0, qMax(total, 1));
+    m_fileOpProgressBar->setValue(done);
+    m_fileOpLabel->show();
+    m_fileOpProgressBar->show();
+    m_fileOpCancelButton->show();
+}
+
+void MainWindow::hideFileOpProgressIfIdle()
+{
+    if (FileOperationQueue::instance()->isBusy() || m_exporter->isRunning()) {
+        return;
+    }
+    m_fileOpLabel->hide();
+    m_fileOpProgressBar->hide();
+    m_fileOpCancelButton->hide();
+}
+
+void MainWindow::restoreSelectionAfterTrash(int row)
+{
+    // Row removal only moves the current index; the selection is gone.
+    // Leave it alone if something was selected while the job ran.
+    const int count = m_model->rowCount();
+    if (count == 0) {
+        return;
+    }
+    const int newRow = qMin(row, count - 1);
+    if (m_isTaggingMode) {
+        if (m_taggingMode->selectedImagePaths().isEmpty()) {
+            m_taggingMode->selectByRow(newRow);
+        }
+    } else if (m_gridView->selectedImagePaths().isEmpty()) {
+        QModelIndex newIdx = m_model->index(newRow);
+        m_gridView->selectionModel()->setCurrentIndex(newIdx, QItemSelectionModel::ClearAndSelect);
+        m_gridView->scrollTo(newIdx);
+    }
+}
+
+void MainWindow::onFileJobFinished(int jobId, int succeeded, int failed, bool cancelled)
+{
+    const FileJob job = m_fileJobs.take(jobId);
+    hideFileOpProgressIfIdle();
+    
+    // Counts and membership changed; one sidebar reload per job
+    if (succeeded > 0) {
+        m_tagSidebar->setCurrentDirectoryPaths(m_model->allFilePaths());
+    }
+    const QString suffix = cancelled ? QString(" (cancelled)") : QString();
+    
+    switch (job.kind) {
+    case FileJob::Trash:
+        if (failed > 0) {
+            QMessageBox::warning(this, "Recycle Bin",
+                QString("Moved %1 file(s) to Recycle Bin. Failed for %2 file(s).")
+                    .arg(succeeded).arg(failed));
+        } else {
+            m_statusLabel->setText(QString("Moved %1 file(s) to Recycle Bin%2").arg(succeeded).arg(suffix));
+        }
+        restoreSelectionAfterTrash(job.currentRow);
+        break;
         
-        QString destPath = albumDir.filePath(fileInfo.fileName());
-        
-        // Handle filename conflicts
-        if (QFile::exists(destPath)) {
-            QString baseName = fileInfo.completeBaseName();
-            QString suffix = fileInfo.suffix();
-            int counter = 1;
-            do {
-                destPath = albumDir.filePath(
-                    QString("%1_%2.%3").arg(baseName).arg(counter).arg(suffix));
-                counter++;
-            } while (QFile::exists(destPath));
+    case FileJob::CreateAlbum:
+        if (job.albumTagId >= 0) {
+            if (job.movedPaths.isEmpty()) {
+                TagManager::instance()->deleteTag(job.albumTagId);
+            } else {
+                // Tag all moved images with the album tag
+                TagManager::instance()->tagImages(job.movedPaths, job.albumTagId);
+            }
+        }
+        if (failed > 0) {
+            QMessageBox::warning(this, "Create Album",
+                QString("Created album \"%1\". Moved %2 file(s), %3 failed.")
+                    .arg(job.albumName).arg(succeeded).arg(failed));
+        } else {
+            m_statusLabel->setText(
+                QString("Created album \"%1\" with %2 images%3")
+                    .arg(job.albumName).arg(succeeded).arg(suffix));
         }
+        break;
         
-        if (QFile::rename(imagePath, destPath)) {
-            TagManager::instance()->updateImagePath(imagePath, destPath);
-            movedCount++;
+    case FileJob::AlbumMove:
+        if (failed > 0) {
+            QMessageBox::warning(this, "Move to Album",
+                QString("Moved %1 file(s). Failed for %2 file(s).").arg(succeeded).arg(failed));
+        } else if (succeeded > 0 && !job.albumName.isEmpty()) {
+            m_statusLabel->setText(
+                QString("Moved %1 existing image(s) to album \"%2\"%3")
+                    .arg(succeeded).arg(job.albumName).arg(suffix));
+        } else if (succeeded > 0) {
+            m_statusLabel->setText(QString("Moved %1 image(s) to album%2").arg(succeeded).arg(suffix));
         }
+        break;
+    }
+}
+
+// ============== Export ==============
+
+void MainWindow::exportSelection()
+{
+    const QStringList selectedPaths = m_isTaggingMode
+        ? m_taggingMode->selectedImagePaths() : m_gridView->selectedImagePaths();
+    if (selectedPaths.isEmpty()) {
+        QMessageBox::information(this, "Export Selection", "Select the images to export first.");
+        return;
+    }
+    if (m_exporter->isRunning()) {
+        QMessageBox::information(this, "Export Selection", "An export is already running.");
+        return;
     }
     
-    if (movedCount > 0) {
-        Tag tag = TagManager::instance()->tag(tagId);
-        m_statusLabel->setText(
-            QString("Moved %1 existing image(s) to album \"%2\"")
-                .arg(movedCount).arg(tag.name));
-        
-        // Refresh the view
-        if (!m_albumRefreshTimer) {
-            m_albumRefreshTimer = new QTimer(this);
-            m_albumRefreshTimer->setSingleShot(true);
-            m_albumRefreshTimer->setInterval(300);
-            connect(m_albumRefreshTimer, &QTimer::timeout, this, [this]() {
-                if (!m_currentFolder.isEmpty()) {
-                    openFolder(m_currentFolder);
+    QSettings settings("FullFrame", "FullFrame");
+    QString folder = QFileDialog::getExistingDirectory(this, "Export Selection",
+        settings.value("lastExportFolder", m_currentFolder).toString());
+    if (folder.isEmpty()) {
+        return;
+    }
+    settings.setValue("lastExportFolder", folder);
+    
+    // Sidecar data comes from the database, so it is gathered here on the
+    // GUI thread; the workers only copy and write
+    const bool writeSidecars = m_exportSidecarsAction->isChecked();
+    TagManager* tagManager = TagManager::instance();
+    QVector<ExportItem> items;
+    items.reserve(selectedPaths.size());
+    for (const QString& path : selectedPaths) {
+        ExportItem item;
+        item.source = path;
+        if (writeSidecars) {
+            if (tagManager->isInitialized()) {
+                for (qint64 tagId : tagManager->tagIdsForImage(path)) {
+                    item.tags.append(tagManager->tag(tagId).name);
                 }
-            });
+                item.tags.sort(Qt::CaseInsensitive);
+            }
+            item.rating = m_ratings.value(path, 0);
         }
-        m_albumRefreshTimer->start();
+        items.append(item);
+    }
+    
+    if (!m_exporter->start(items, folder, writeSidecars)) {
+        QMessageBox::warning(this, "Export Selection",
+            QString("Could not create \"%1\". Check permissions.").arg(folder));
+        return;
+    }
+    m_exportFolder = folder;
+    showFileOpProgress(QString("Exporting %1 file(s)...").arg(items.size()), 0, items.size());
+}
+
+void MainWindow::onExportProgress(int done, int total, qint64 bytes)
+{
+    showFileOpProgress(QString("Exporting... %1 of %2 (%3)")
+                           .arg(done).arg(total).arg(QLocale().formattedDataSize(bytes)),
+                       done, total);
+}
+
+void MainWindow::onExportFinished(int exported, int failed, int reflinked, qint64 bytes, bool cancelled,
+                                  const QStringList& errors)
+{
+    hideFileOpProgressIfIdle();
+    
+    QString summary = QString("Exported %1 file(s), %2, to \"%3\"")
+        .arg(exported).arg(QLocale().formattedDataSize(bytes)).arg(QDir::toNativeSeparators(m_exportFolder));
+    if (reflinked > 0) {
+        summary += QString(" (%1 reflinked)").arg(reflinked);
+    }
+    if (cancelled) {
+        summary += " (cancelled)";
+    }
+    
+    if (failed > 0) {
+        QStringList shown = errors.mid(0, 10);
+        if (errors.size() > shown.size()) {
+            shown.append(QString("... and %1 more").arg(errors.size() - shown.size()));
+        }
+        QMessageBox::warning(this, "Export Selection",
+            QString("%1. Failed for %2 file(s):\n\n%3").arg(summary).arg(failed).arg(shown.join('\n')));
+    } else {
+        m_statusLabel->setText(summary);
     }
 }
 
@@ -20,10 +20,14 @@
 #include <QAction>
 #include <QHBoxLayout>
 
+#include "fileoperationqueue.h"
+
 class QSplitter;
+class QPushButton;
 
 namespace FullFrame {
 
+class FileExporter;
 class ImageGridView;
 class ImageThumbnailModel;
 class TagSidebar;
@@ -65,12 +69,26 @@ private Q_SLOTS:
     void createAlbumFromSelection();
     void onImageTaggedForAlbum(const QString& imagePath, qint64 tagId);
     void onTagLinkedToFolder(qint64 tagId, const QString& albumPath);
+    void flushAlbumMoves();
+    void onFileBatchFinished(int jobId, const QVector<FileOperationResult>& results);
+    void onFileJobProgress(int jobId, int handled, int total);
+    void onFileJobFinished(int jobId, int succeeded, int failed, bool cancelled);
+    void exportSelection();
+    void onExportProgress(int done, int total, qint64 bytes);
+    void onExportFinished(int exported, int failed, int reflinked, qint64 bytes, bool cancelled,
+                          const QStringList& errors);
     void toggleFavoriteSelected();
     void setRatingSelected(int rating);
     void showCombineTagsDialog();
+    void setFrameStatsVisible(bool visible);
+    void dumpFrameStats();
+    void setTraceRecording(bool recording);
+    void showMemoryReport();
+    void restoreLastFolder();
 
 private:
     void setupUI();
+    TaggingModeWidget* ensureTaggingMode();
     void setupMenuBar();
     void setupToolBar();
     void setupStatusBar();
@@ -81,6 +99,10 @@ private:
     void saveSettings();
     void loadRatingsFromDb();
     void reapplySort();
+    int startAlbumMove(const QStringList& imagePaths, const QString& albumPath, const QString& albumName);
+    void showFileOpProgress(const QString& text, int done, int total);
+    void hideFileOpProgressIfIdle();
+    void restoreSelectionAfterTrash(int row);
 
     // Fullscreen / immersive display modes
     void cycleDisplayMode();
@@ -107,6 +129,9 @@ private:
     QAction* m_taggingModeAction = nullptr;
     QAction* m_toggleSidebarAction = nullptr;
     QAction* m_showAlbumFilesAction = nullptr;
+    QAction* m_frameStatsAction = nullptr;
+    QAction* m_traceAction = nullptr;
+    QHash<QString, qint64> m_lastMemoryReport;   // Row sizes at the last memory report
     bool m_isTaggingMode = false;
     bool m_showAlbumFiles = true;
 
@@ -126,6 +151,8 @@ private:
 
     // Current state
     QString m_currentFolder;
+    QString m_folderToRestore;        // Last session's folder, reopened after the first paint
+    bool m_firstFramePainted = false;
     int m_pendingThumbnails = 0;
     int m_totalThumbnails = 0;
     
@@ -140,8 +167,26 @@ private:
     // Sort mode
     QString m_sortMode = "default";
     
-    // Album auto-move batching
-    QTimer* m_albumRefreshTimer = nullptr;
+    // Background file operations (album moves, deletes)
+    struct FileJob
+    {
+        enum Kind { CreateAlbum, AlbumMove, Trash };
+        Kind kind = AlbumMove;
+        QString albumName;
+        qint64 albumTagId = -1;    // CreateAlbum: tag applied to the moved files
+        QStringList movedPaths;    // CreateAlbum: destinations so far
+        int currentRow = 0;        // Trash: row to select again when done
+    };
+    QHash<int, FileJob> m_fileJobs;
+    QHash<QString, QStringList> m_pendingAlbumMoves;   // Album path → images tagged since the last flush
+    QLabel* m_fileOpLabel = nullptr;
+    QProgressBar* m_fileOpProgressBar = nullptr;
+    QPushButton* m_fileOpCancelButton = nullptr;
+    
+    // Export of selections to a delivery folder
+    FileExporter* m_exporter = nullptr;
+    QString m_exportFolder;
+    QAction* m_exportSidecarsAction = nullptr;
 
     // Display mode (fullscreen / immersive)
     enum DisplayMode { DisplayNormal, DisplayFullscreen, DisplayImmersive };
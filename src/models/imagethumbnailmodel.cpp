@@ -11,13 +11,19 @@
 #include "thumbnailloadthread.h"
 #include "thumbnailcache.h"
 #include "thumbnailcreator.h"
+#include "perfcounters.h"
 #include "tagmanager.h"
+#include "hotkeylatency.h"
+#include "mediascanner.h"
+#include "eventtrace.h"
+#include "memoryreport.h"
 
-#include <QDirIterator>
+#include <QDir>
 #include <QPainter>
 #include <QLocale>
 #include <QDebug>
 #include <algorithm>
+#include <functional>
 
 namespace FullFrame {
 
@@ -58,6 +64,8 @@ void ImageThumbnailModel::connectThumbnailThread()
             this, &ImageThumbnailModel::onThumbnailAvailable);
     connect(ThumbnailLoadThread::instance(), &ThumbnailLoadThread::thumbnailFailed,
             this, &ImageThumbnailModel::onThumbnailFailed);
+    connect(ThumbnailLoadThread::instance(), &ThumbnailLoadThread::previewAvailable,
+            this, &ImageThumbnailModel::onPreviewAvailable);
 }
 
 void ImageThumbnailModel::connectTagManager()
@@ -84,6 +92,8 @@ int ImageThumbnailModel::rowCount(const QModelIndex& parent) const
 
 QVariant ImageThumbnailModel::data(const QModelIndex& index, int role) const
 {
+    EventTrace::Span span("data", "model");
+    span.setArg(role);
     if (!index.isValid() || index.row() < 0 || index.row() >= m_items.size()) {
         return QVariant();
     }
@@ -96,40 +106,8 @@ QVariant ImageThumbnailModel::data(const QModelIndex& index, int role) const
             return item.fileName;
             
         case Qt::DecorationRole:
-        case ThumbnailRole: {
-            // Fast path: Return cached pixmap if already loaded
-            if (item.thumbnailLoaded && !item.cachedPixmap.isNull()) {
-                return item.cachedPixmap;
-            }
-            
-            // Generate cache key once
-            QString cacheKey = ThumbnailInfo::makeCacheKey(item.filePath, m_thumbnailSize);
-            
-            // Try pixmap cache first (most common case)
-            const QPixmap* cached = ThumbnailCache::instance()->retrievePixmap(cacheKey);
-            if (cached && !cached->isNull()) {
-                item.cachedPixmap = *cached;
-                item.thumbnailLoaded = true;
-                return item.cachedPixmap;
-            }
-            
-            // Try image cache as fallback
-            const QImage* cachedImage = ThumbnailCache::instance()->retrieveImage(cacheKey);
-            if (cachedImage && !cachedImage->isNull()) {
-                item.cachedPixmap = QPixmap::fromImage(*cachedImage);
-                item.thumbnailLoaded = true;
-                ThumbnailCache::instance()->putPixmap(cacheKey, item.cachedPixmap);
-                return item.cachedPixmap;
-            }
-            
-            // Request thumbnail load if not already pending
-            if (!m_pendingThumbnails.contains(item.filePath)) {
-                m_pendingThumbnails.insert(item.filePath);
-                ThumbnailLoadThread::instance()->load(item.filePath, m_thumbnailSize);
-            }
-            
-            return m_loadingPixmap;
-        }
+        case ThumbnailRole:
+            return thumbnailFor(item);
             
         case FilePathRole:
             return item.filePath;
@@ -155,26 +133,18 @@ QVariant ImageThumbnailModel::data(const QModelIndex& index, int role) const
                 return QVariant();
             }
             
-            // Return cached tag list if still valid (avoids per-paint heap allocations)
-            if (!item.tagListDirty) {
-                return item.cachedTagList;
-            }
-            
-            // Rebuild and cache - get tags with supertag info from TagManager
-            QList<Tag> tags = TagManager::instance()->tagsForImage(item.filePath);
-            
+            // Generic (QVariant) view of the cached badges — the delegate
+            // reads them directly through paintRecord() instead
+            const TagBadgeList& badges = badgesFor(item);
             QVariantList tagList;
-            tagList.reserve(tags.size());
-            
-            for (const Tag& tag : tags) {
+            tagList.reserve(badges.size());
+            for (const TagBadgeInfo& badge : badges) {
                 QVariantMap tagInfo;
-                tagInfo.insert(QStringLiteral("name"), tag.name);
-                tagInfo.insert(QStringLiteral("color"), tag.color);
-                tagInfo.insert(QStringLiteral("isSupertag"), tag.isSupertag);
+                tagInfo.insert(QStringLiteral("name"), badge.name);
+                tagInfo.insert(QStringLiteral("color"), badge.color.name());
+                tagInfo.insert(QStringLiteral("isSupertag"), badge.isSupertag);
                 tagList.append(tagInfo);
             }
-            item.cachedTagList = tagList;
-            item.tagListDirty = false;
             return tagList;
         }
         
@@ -208,6 +178,172 @@ QVariant ImageThumbnailModel::data(const QModelIndex& index, int role) const
     return QVariant();
 }
 
+// ============== Paint Records ==============
+
+const QPixmap& ImageThumbnailModel::thumbnailFor(const ImageItem& item) const
+{
+    // Fast path: Return cached pixmap if already loaded
+    if (item.thumbnailLoaded && !item.cachedPixmap.isNull()) {
+        return item.cachedPixmap;
+    }
+    
+    // Generate cache key once
+    QString cacheKey = ThumbnailInfo::makeCacheKey(item.filePath, m_thumbnailSize);
+    
+    // Try pixmap cache first (most common case)
+    const QPixmap* cached = ThumbnailCache::instance()->retrievePixmap(cacheKey);
+    if (cached && !cached->isNull()) {
+        item.cachedPixmap = *cached;
+        item.thumbnailLoaded = true;
+        return item.cachedPixmap;
+    }
+    
+    // Try image cache as fallback
+    const QImage* cachedImage = ThumbnailCache::instance()->retrieveImage(cacheKey);
+    if (cachedImage && !cachedImage->isNull()) {
+        item.cachedPixmap = QPixmap::fromImage(*cachedImage);
+        PerfCounters::add(PerfCounters::PixmapFromImage);
+        item.thumbnailLoaded = true;
+        ThumbnailCache::instance()->putPixmap(cacheKey, item.cachedPixmap);
+        return item.cachedPixmap;
+    }
+    
+    // Progressive loading: show the tiny preview, upscaled once, until the
+    // real thumbnail arrives
+    if (item.cachedPixmap.isNull()) {
+        QImage preview;
+        if (ThumbnailCache::instance()->retrievePreview(item.filePath, preview)) {
+            item.cachedPixmap = QPixmap::fromImage(
+                preview.scaled(m_thumbnailSize, m_thumbnailSize, Qt::KeepAspectRatio,
+                               Qt::SmoothTransformation));
+            PerfCounters::add(PerfCounters::PixmapFromImage);
+        }
+    }
+    
+    // Request thumbnail load if not already pending
+    if (!m_deferThumbnailRequests && !m_pendingThumbnails.contains(item.filePath)) {
+        m_pendingThumbnails.insert(item.filePath);
+        ThumbnailLoadThread::instance()->load(item.filePath, m_thumbnailSize);
+    }
+    
+    return item.cachedPixmap.isNull() ? m_loadingPixmap : item.cachedPixmap;
+}
+
+const QPixmap& ImageThumbnailModel::thumbnailFor(const ImageItem& item, int size) const
+{
+    if (size <= 0 || size == m_thumbnailSize) {
+        return thumbnailFor(item);
+    }
+    
+    if (item.sizedPixmapSize == size && !item.sizedPixmap.isNull()) {
+        return item.sizedPixmap;
+    }
+    
+    // Same shared caches and loader as the main size class, under its own key
+    QString cacheKey = ThumbnailInfo::makeCacheKey(item.filePath, size);
+    
+    const QPixmap* cached = ThumbnailCache::instance()->retrievePixmap(cacheKey);
+    if (cached && !cached->isNull()) {
+        item.sizedPixmap = *cached;
+        item.sizedPixmapSize = size;
+        return item.sizedPixmap;
+    }
+    
+    const QImage* cachedImage = ThumbnailCache::instance()->retrieveImage(cacheKey);
+    if (cachedImage && !cachedImage->isNull()) {
+        item.sizedPixmap = QPixmap::fromImage(*cachedImage);
+        item.sizedPixmapSize = size;
+        PerfCounters::add(PerfCounters::PixmapFromImage);
+        ThumbnailCache::instance()->putPixmap(cacheKey, item.sizedPixmap);
+        return item.sizedPixmap;
+    }
+    
+    // Tracked apart from the grid's loads, so neither size class's
+    // completions clear the other's pending state
+    if (!m_deferThumbnailRequests && !m_pendingSizedThumbnails.contains(cacheKey)) {
+        m_pendingSizedThumbnails.insert(cacheKey);
+        ThumbnailLoadThread::instance()->load(item.filePath, size, LoadPriority::High);
+    }
+    
+    // Stand-in until it lands: whatever the main size class already holds
+    return item.cachedPixmap.isNull() ? m_loadingPixmap : item.cachedPixmap;
+}
+
+const TagBadgeList& ImageThumbnailModel::badgesFor(const ImageItem& item) const
+{
+    if (!item.tagListDirty) {
+        return item.cachedBadges;
+    }
+    
+    // Rebuild once per tag change — supertags first, then regular tags, so
+    // the delegate can lay badges out in a single pass
+    QList<Tag> tags = TagManager::instance()->tagsForImage(item.filePath);
+    
+    TagBadgeList badges;
+    badges.reserve(tags.size());
+    for (const Tag& tag : tags) {
+        if (tag.isSupertag) {
+            badges.append({tag.name, tag.color.isEmpty() ? QColor(100, 100, 100) : QColor(tag.color), true});
+        }
+    }
+    for (const Tag& tag : tags) {
+        if (!tag.isSupertag) {
+            badges.append({tag.name, tag.color.isEmpty() ? QColor(100, 100, 100) : QColor(tag.color), false});
+        }
+    }
+    
+    item.cachedBadges = badges;
+    item.tagListDirty = false;
+    return item.cachedBadges;
+}
+
+ThumbnailPaintRecord ImageThumbnailModel::paintRecord(int row, int thumbnailSize) const
+{
+    ThumbnailPaintRecord record;
+    if (row < 0 || row >= m_items.size()) {
+        return record;
+    }
+    
+    const ImageItem& item = m_items.at(row);
+    
+    // Resolve the favorite/rating/sequence hash lookups once per epoch;
+    // every later repaint of this tile reads the denormalized copy
+    if (item.paintEpoch != m_paintEpoch) {
+        quint8 flags = 0;
+        if (isFavorited(item.filePath)) {
+            flags |= ThumbnailPaintRecord::Favorited;
+        }
+        const int seqCount = m_sequenceCovers.value(item.filePath, 0);
+        if (seqCount > 0) {
+            flags |= ThumbnailPaintRecord::SequenceCover;
+            const qint64 seqId = m_pathToSequenceId.value(item.filePath, -1);
+            if (seqId >= 0 && m_expandedSequences.contains(seqId)) {
+                flags |= ThumbnailPaintRecord::SequenceExpanded;
+            }
+        }
+        item.paintFlags = flags;
+        item.paintRating = static_cast<quint8>(qBound(0, m_ratings.value(item.filePath, 0), 5));
+        item.paintSequenceCount = seqCount;
+        item.paintEpoch = m_paintEpoch;
+    }
+    
+    record.pixmap = &thumbnailFor(item, thumbnailSize);
+    record.fileName = &item.fileName;
+    record.flags = item.paintFlags;
+    record.rating = item.paintRating;
+    record.sequenceCount = item.paintSequenceCount;
+    
+    if (!item.tagIds.isEmpty()) {
+        record.flags |= ThumbnailPaintRecord::HasTags;
+        record.badges = &badgesFor(item);
+    }
+    if (record.pixmap == &m_loadingPixmap) {
+        record.flags |= ThumbnailPaintRecord::Placeholder;
+    }
+    
+    return record;
+}
+
 bool ImageThumbnailModel::setData(const QModelIndex& index, const QVariant& value, int role)
 {
     if (!index.isValid() || index.row() < 0 || index.row() >= m_items.size()) {
@@ -263,6 +399,7 @@ void ImageThumbnailModel::loadDirectory(const QString& path, bool recursive)
     beginResetModel();
     m_allItems.clear();
     m_pendingThumbnails.clear();
+    m_pendingSizedThumbnails.clear();
     m_currentDir = path;
     m_expandedSequences.clear();
     
@@ -272,6 +409,7 @@ void ImageThumbnailModel::loadDirectory(const QString& path, bool recursive)
     m_sequenceCovers = TagManager::instance()->allSequenceCovers();
     m_hiddenSequenceMembers = TagManager::instance()->hiddenSequenceMembers();
     m_pathToSequenceId = TagManager::instance()->allImageSequenceIds();
+    invalidatePaintRecords();
     
     rebuildFilteredItems();
     
@@ -281,36 +419,13 @@ void ImageThumbnailModel::loadDirectory(const QString& path, bool recursive)
 
 void ImageThumbnailModel::scanDirectory(const QString& path, bool recursive)
 {
-    QDir rootDir(path);
-    QDir::Filters filters = QDir::Files | QDir::Readable;
-    QDirIterator::IteratorFlags flags = recursive ? 
-        QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags;
+    EventTrace::Span span("scanDirectory", "scan");
+    const QFileInfoList files = MediaScanner::scan(path, recursive);
+    m_allItems.reserve(files.size());
+    span.setArg(files.size());
     
-    QDirIterator it(path, filters, flags);
-    
-    while (it.hasNext()) {
-        it.next();
-        QFileInfo info = it.fileInfo();
-        
-        if (!ThumbnailCreator::isMediaFile(info.filePath())) {
-            continue;
-        }
-        
-        ImageItem item;
-        item.filePath = info.filePath();
-        // Show relative path (e.g. "album/photo.jpg") so subfolder files
-        // are distinguishable from files in the root folder.
-        item.fileName = rootDir.relativeFilePath(info.filePath());
-        item.fileSize = info.size();
-        item.modifiedDate = info.lastModified();
-        // Use birthTime (creation date) if available, otherwise fall back to modified date
-        item.creationDate = info.birthTime().isValid() ? info.birthTime() : info.lastModified();
-        item.mediaType = ThumbnailCreator::getMediaType(info.filePath());
-        
-        // Load tags if TagManager is initialized
-        if (TagManager::instance()->isInitialized()) {
-            item.tagIds = TagManager::instance()->tagIdsForImage(item.filePath);
-        }
+    for (const QFileInfo& info : files) {
+        ImageItem item = itemForFile(info);
         
         // Apply tag filter only - add all matching items to m_allItems
         // Album file filtering will be applied later in loadDirectory/applyFilenameFilter
@@ -325,6 +440,26 @@ void ImageThumbnailModel::scanDirectory(const QString& path, bool recursive)
     });
 }
 
+ImageItem ImageThumbnailModel::itemForFile(const QFileInfo& info) const
+{
+    ImageItem item;
+    item.filePath = info.filePath();
+    // Show relative path (e.g. "album/photo.jpg") so subfolder files
+    // are distinguishable from files in the root folder.
+    item.fileName = QDir(m_currentDir).relativeFilePath(info.filePath());
+    item.fileSize = info.size();
+    item.modifiedDate = info.lastModified();
+    // Use birthTime (creation date) if available, otherwise fall back to modified date
+    item.creationDate = info.birthTime().isValid() ? info.birthTime() : info.lastModified();
+    item.mediaType = ThumbnailCreator::getMediaType(info.filePath());
+    
+    // Load tags if TagManager is initialized
+    if (TagManager::instance()->isInitialized()) {
+        item.tagIds = TagManager::instance()->tagIdsForImage(item.filePath);
+    }
+    return item;
+}
+
 void ImageThumbnailModel::loadFiles(const QStringList& filePaths)
 {
     Q_EMIT loadingStarted();
@@ -334,6 +469,7 @@ void ImageThumbnailModel::loadFiles(const QStringList& filePaths)
     m_allItems.clear();
     m_pathToRow.clear();
     m_pendingThumbnails.clear();
+    m_pendingSizedThumbnails.clear();
     m_thumbDirtyRows.clear();
     m_currentDir.clear();
     
@@ -374,11 +510,75 @@ void ImageThumbnailModel::clear()
     m_allItems.clear();
     m_pathToRow.clear();
     m_pendingThumbnails.clear();
+    m_pendingSizedThumbnails.clear();
     m_thumbDirtyRows.clear();
     m_currentDir.clear();
     endResetModel();
 }
 
+void ImageThumbnailModel::reportMemory(MemoryReport& report) const
+{
+    // m_items holds copies of m_allItems entries; their strings and tag sets
+    // are shared, so only the list slots count twice
+    qint64 itemBytes = qint64(m_items.size() + m_allItems.size()) * qint64(sizeof(ImageItem))
+                     + MemoryReport::hashBytes(m_pathToRow.size(), sizeof(QString) + sizeof(int));
+    for (const ImageItem& item : m_allItems) {
+        itemBytes += MemoryReport::stringBytes(item.filePath) + MemoryReport::stringBytes(item.fileName)
+                   + MemoryReport::hashBytes(item.tagIds.size(), sizeof(qint64));
+    }
+    report.add("Model items", itemBytes, m_allItems.size());
+
+    qint64 pixmapBytes = 0;
+    qint64 pixmapCount = 0;
+    qint64 badgeBytes = 0;
+    qint64 badgeCount = 0;
+    QSet<const void*> seenBadges;
+    auto addItemCaches = [&](const ImageItem& item) {
+        const qint64 cached = report.pixmapBytes(item.cachedPixmap) + report.pixmapBytes(item.sizedPixmap);
+        if (cached > 0) {
+            pixmapBytes += cached;
+            ++pixmapCount;
+        }
+        if (!item.cachedBadges.isEmpty() && !seenBadges.contains(item.cachedBadges.constData())) {
+            seenBadges.insert(item.cachedBadges.constData());
+            badgeBytes += qint64(item.cachedBadges.capacity()) * qint64(sizeof(TagBadgeInfo));
+            for (const TagBadgeInfo& badge : item.cachedBadges) {
+                badgeBytes += MemoryReport::stringBytes(badge.name);
+            }
+            ++badgeCount;
+        }
+    };
+    for (const ImageItem& item : m_items) {
+        addItemCaches(item);
+    }
+    for (const ImageItem& item : m_allItems) {
+        addItemCaches(item);
+    }
+    report.add("Model item pixmaps (not in pixmap cache)", pixmapBytes, pixmapCount);
+    report.add("Model item tag badges", badgeBytes, badgeCount);
+
+    qint64 tableBytes = MemoryReport::hashBytes(m_favorites.size() + m_hiddenSequenceMembers.size()
+                                                + m_pendingThumbnails.size() + m_pendingSizedThumbnails.size(),
+                                                sizeof(QString))
+                      + MemoryReport::hashBytes(m_ratings.size() + m_sequenceCovers.size(), sizeof(QString) + sizeof(int))
+                      + MemoryReport::hashBytes(m_pathToSequenceId.size(), sizeof(QString) + sizeof(qint64));
+    auto addKeys = [&](const auto& keys) {
+        for (const QString& key : keys) {
+            tableBytes += MemoryReport::stringBytes(key);
+        }
+    };
+    addKeys(m_favorites);
+    addKeys(m_hiddenSequenceMembers);
+    addKeys(m_pendingThumbnails);
+    addKeys(m_pendingSizedThumbnails);
+    addKeys(m_ratings.keys());
+    addKeys(m_sequenceCovers.keys());
+    addKeys(m_pathToSequenceId.keys());
+    report.add("Model lookup tables", tableBytes,
+               m_favorites.size() + m_hiddenSequenceMembers.size() + m_pendingThumbnails.size()
+               + m_pendingSizedThumbnails.size() + m_ratings.size() + m_sequenceCovers.size() + m_pathToSequenceId.size());
+}
+
 QStringList ImageThumbnailModel::allFilePaths() const
 {
     QStringList paths;
@@ -488,16 +688,22 @@ int ImageThumbnailModel::selectedCount() const
 void ImageThumbnailModel::setThumbnailSize(int size)
 {
     if (m_thumbnailSize != size) {
+        const int oldSize = m_thumbnailSize;
         m_thumbnailSize = size;
         
         // Update placeholder
         m_loadingPixmap = QPixmap(size, size);
         m_loadingPixmap.fill(QColor(40, 40, 40));
         
-        // Clear pending thumbnails and cached pixmaps - they'll be re-requested at new size
+        // Loads queued at the old size are now wasted work; the strip's
+        // loads at its own size share the loader and stay queued
+        ThumbnailLoadThread::instance()->cancelSize(oldSize);
         m_pendingThumbnails.clear();
+        
+        // Keep each cached pixmap as a stand-in — the delegate scales it to
+        // the new cell — and only mark it stale, so zooming never flashes
+        // placeholders. Exact-size thumbnails replace them as they arrive.
         for (ImageItem& item : m_items) {
-            item.cachedPixmap = QPixmap();
             item.thumbnailLoaded = false;
         }
         
@@ -556,6 +762,7 @@ void ImageThumbnailModel::refreshSequenceData()
     m_sequenceCovers = TagManager::instance()->allSequenceCovers();
     m_hiddenSequenceMembers = TagManager::instance()->hiddenSequenceMembers();
     m_pathToSequenceId = TagManager::instance()->allImageSequenceIds();
+    invalidatePaintRecords();
     applyFilenameFilter();
 }
 
@@ -569,6 +776,7 @@ void ImageThumbnailModel::toggleSequenceExpanded(const QString& coverPath)
     else
         m_expandedSequences.insert(seqId);
 
+    invalidatePaintRecords();
     applyFilenameFilter();
 }
 
@@ -604,6 +812,7 @@ bool ImageThumbnailModel::isFavorited(const QString& filePath) const
 void ImageThumbnailModel::setFavorites(const QSet<QString>& favorites)
 {
     m_favorites = favorites;
+    invalidatePaintRecords();
     // Refresh the view to update filtering (this will also update star icons via endResetModel)
     applyFilenameFilter();
     // After filtering, trigger dataChanged for visible items to update star icons
@@ -619,6 +828,7 @@ void ImageThumbnailModel::setFavorites(const QSet<QString>& favorites)
 void ImageThumbnailModel::setRatings(const QHash<QString, int>& ratings)
 {
     m_ratings = ratings;
+    invalidatePaintRecords();
     // Notify view to repaint rating indicators
     if (rowCount() > 0) {
         QModelIndex topLeft = index(0, 0);
@@ -637,6 +847,7 @@ void ImageThumbnailModel::setRating(const QString& filePath, int rating)
     
     int row = indexOf(filePath);
     if (row >= 0) {
+        m_items[row].paintEpoch = 0;  // Re-resolve this tile's paint data only
         QModelIndex idx = index(row);
         Q_EMIT dataChanged(idx, idx, {RatingRole});
     }
@@ -670,12 +881,7 @@ void ImageThumbnailModel::rebuildFilteredItems()
     QList<ImageItem> baseItems;
 
     for (const ImageItem& item : m_allItems) {
-        // Album filter
-        if (!(m_showAlbumFiles || !isInAlbumFolder(item.filePath) || isFavorited(item.filePath)))
-            continue;
-        // Filename filter
-        if (!m_filenameFilter.isEmpty()
-            && !item.fileName.contains(m_filenameFilter, Qt::CaseInsensitive))
+        if (!matchesViewFilters(item))
             continue;
 
         if (m_hiddenSequenceMembers.contains(item.filePath)) {
@@ -701,6 +907,25 @@ void ImageThumbnailModel::rebuildFilteredItems()
         }
     }
 
+    rebuildPathIndex();
+}
+
+bool ImageThumbnailModel::matchesViewFilters(const ImageItem& item) const
+{
+    // Album filter
+    if (!(m_showAlbumFiles || !isInAlbumFolder(item.filePath) || isFavorited(item.filePath)))
+        return false;
+    // Filename filter
+    if (!m_filenameFilter.isEmpty()
+        && !item.fileName.contains(m_filenameFilter, Qt::CaseInsensitive))
+        return false;
+    return true;
+}
+
+void ImageThumbnailModel::rebuildPathIndex()
+{
+    m_pathToRow.clear();
+    m_pathToRow.reserve(m_items.size());
     for (int i = 0; i < m_items.size(); ++i) {
         m_pathToRow.insert(m_items[i].filePath, i);
     }
@@ -710,11 +935,207 @@ void ImageThumbnailModel::applyFilenameFilter()
 {
     beginResetModel();
     m_pendingThumbnails.clear();
+    m_pendingSizedThumbnails.clear();
     rebuildFilteredItems();
     endResetModel();
     Q_EMIT loadingFinished(m_items.size());
 }
 
+// ============== File Operations ==============
+
+void ImageThumbnailModel::applyFileMoves(const QHash<QString, QString>& moves)
+{
+    if (moves.isEmpty()) {
+        return;
+    }
+    flushThumbnailUpdates();   // Dirty rows are about to shift
+    
+    const QString rootPrefix = m_currentDir.isEmpty()
+        ? QString() : QDir(m_currentDir).absolutePath() + QLatin1Char('/');
+    auto inTree = [&rootPrefix](const QString& path) {
+        return !rootPrefix.isEmpty() && QFileInfo(path).absoluteFilePath().startsWith(rootPrefix);
+    };
+    
+    QHash<QString, int> allIndex;
+    allIndex.reserve(m_allItems.size());
+    for (int i = 0; i < m_allItems.size(); ++i) {
+        allIndex.insert(m_allItems[i].filePath, i);
+    }
+    
+    QSet<QString> leftTree;          // Old paths of items moved out of the folder
+    QVector<int> changedRows;        // Visible rows renamed in place
+    QVector<int> leavingRows;        // Visible rows that no longer pass the filters
+    QList<ImageItem> appearing;      // Items that become visible
+    
+    for (auto it = moves.cbegin(); it != moves.cend(); ++it) {
+        const QString& oldPath = it.key();
+        const QString& newPath = it.value();
+        renamePathKeys(oldPath, newPath);
+        
+        const int all = allIndex.value(oldPath, -1);
+        const int row = m_pathToRow.value(oldPath, -1);
+        if (!inTree(newPath)) {
+            if (all >= 0) {
+                leftTree.insert(oldPath);
+            }
+            if (row >= 0) {
+                leavingRows.append(row);
+            }
+            continue;
+        }
+        
+        if (all < 0) {
+            // Moved in from elsewhere (or previously hidden by the tag filter)
+            ImageItem item = itemForFile(QFileInfo(newPath));
+            if (matchesTagFilter(item)) {
+                m_allItems.append(item);
+                if (matchesViewFilters(item) && !m_hiddenSequenceMembers.contains(newPath)) {
+                    appearing.append(item);
+                }
+            }
+            continue;
+        }
+        
+        ImageItem& item = m_allItems[all];
+        item.filePath = newPath;
+        item.fileName = QDir(m_currentDir).relativeFilePath(newPath);
+        item.paintEpoch = 0;
+        const bool visible = matchesViewFilters(item);
+        
+        if (row >= 0) {
+            if (visible) {
+                ImageItem& shown = m_items[row];
+                shown.filePath = item.filePath;
+                shown.fileName = item.fileName;
+                shown.paintEpoch = 0;
+                changedRows.append(row);
+            } else {
+                leavingRows.append(row);
+            }
+        } else if (visible && !m_hiddenSequenceMembers.contains(newPath)) {
+            appearing.append(item);
+        }
+    }
+    
+    if (!leftTree.isEmpty()) {
+        m_allItems.erase(std::remove_if(m_allItems.begin(), m_allItems.end(),
+                                        [&leftTree](const ImageItem& item) {
+                                            return leftTree.contains(item.filePath);
+                                        }),
+                         m_allItems.end());
+    }
+    
+    if (!changedRows.isEmpty()) {
+        const auto range = std::minmax_element(changedRows.cbegin(), changedRows.cend());
+        Q_EMIT dataChanged(index(*range.first), index(*range.second));
+    }
+    
+    if (!leavingRows.isEmpty()) {
+        removeVisibleRows(leavingRows);
+    } else if (!changedRows.isEmpty()) {
+        rebuildPathIndex();
+    }
+    
+    if (!appearing.isEmpty()) {
+        const int first = m_items.size();
+        beginInsertRows(QModelIndex(), first, first + appearing.size() - 1);
+        m_items.append(appearing);
+        for (int row = first; row < m_items.size(); ++row) {
+            m_pathToRow.insert(m_items[row].filePath, row);
+        }
+        endInsertRows();
+    }
+}
+
+void ImageThumbnailModel::removeFiles(const QStringList& filePaths)
+{
+    if (filePaths.isEmpty()) {
+        return;
+    }
+    flushThumbnailUpdates();   // Dirty rows are about to shift
+    
+    QSet<QString> removed;
+    removed.reserve(filePaths.size());
+    QVector<int> rows;
+    for (const QString& path : filePaths) {
+        removed.insert(path);
+        renamePathKeys(path, QString());
+        const int row = m_pathToRow.value(path, -1);
+        if (row >= 0) {
+            rows.append(row);
+        }
+    }
+    
+    m_allItems.erase(std::remove_if(m_allItems.begin(), m_allItems.end(),
+                                    [&removed](const ImageItem& item) {
+                                        return removed.contains(item.filePath);
+                                    }),
+                     m_allItems.end());
+    
+    if (!rows.isEmpty()) {
+        removeVisibleRows(rows);
+    }
+}
+
+void ImageThumbnailModel::removeVisibleRows(QVector<int> rows)
+{
+    // Remove contiguous runs from the bottom up so earlier rows keep their
+    // numbers; views only address rows while this runs, so the path index
+    // is rebuilt once at the end
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    
+    for (int i = 0; i < rows.size();) {
+        const int last = rows[i];
+        int first = last;
+        for (++i; i < rows.size() && rows[i] == first - 1; ++i) {
+            first = rows[i];
+        }
+        beginRemoveRows(QModelIndex(), first, last);
+        m_items.erase(m_items.begin() + first, m_items.begin() + last + 1);
+        endRemoveRows();
+    }
+    rebuildPathIndex();
+}
+
+void ImageThumbnailModel::renamePathKeys(const QString& oldPath, const QString& newPath)
+{
+    // Path-keyed side tables; an empty newPath just drops the entries
+    m_pendingThumbnails.remove(oldPath);
+    
+    if (m_favorites.remove(oldPath) && !newPath.isEmpty()) {
+        m_favorites.insert(newPath);
+    }
+    if (m_hiddenSequenceMembers.remove(oldPath) && !newPath.isEmpty()) {
+        m_hiddenSequenceMembers.insert(newPath);
+    }
+    
+    auto rating = m_ratings.find(oldPath);
+    if (rating != m_ratings.end()) {
+        const int value = rating.value();
+        m_ratings.erase(rating);
+        if (!newPath.isEmpty()) {
+            m_ratings.insert(newPath, value);
+        }
+    }
+    auto cover = m_sequenceCovers.find(oldPath);
+    if (cover != m_sequenceCovers.end()) {
+        const int count = cover.value();
+        m_sequenceCovers.erase(cover);
+        if (!newPath.isEmpty()) {
+            m_sequenceCovers.insert(newPath, count);
+        }
+    }
+    auto sequence = m_pathToSequenceId.find(oldPath);
+    if (sequence != m_pathToSequenceId.end()) {
+        const qint64 seqId = sequence.value();
+        m_pathToSequenceId.erase(sequence);
+        if (!newPath.isEmpty()) {
+            m_pathToSequenceId.insert(newPath, seqId);
+        }
+    }
+}
+
 // ============== Sorting ==============
 
 void ImageThumbnailModel::sortByRanking(const QSet<QString>& favorites, const QHash<QString, int>& ratings)
@@ -867,20 +1288,37 @@ bool ImageThumbnailModel::matchesTagFilter(const ImageItem& item) const
 
 // ============== Thumbnail Slots ==============
 
-void ImageThumbnailModel::onThumbnailAvailable(const QString& filePath)
+void ImageThumbnailModel::onThumbnailAvailable(const QString& filePath, int size)
 {
+    if (size != m_thumbnailSize) {
+        // Another size class; repaint the row only if it asked for this
+        if (m_pendingSizedThumbnails.remove(ThumbnailInfo::makeCacheKey(filePath, size))) {
+            markThumbnailDirty(indexOf(filePath));
+        }
+        return;
+    }
     m_pendingThumbnails.remove(filePath);
     
-    int row = indexOf(filePath);
+    // DON'T store a pixmap here — the QImage is already in the image cache
+    // (put there by the worker thread).  When the view repaints, data()
+    // will find it in the image cache and do a lazy QPixmap::fromImage()
+    // only for the ~20-30 items actually visible on screen.
+    //
+    // Eagerly converting every completed thumbnail to a QPixmap would
+    // monopolise the main thread during the initial loading burst,
+    // starving wheel-event processing and causing scroll lag at the top.
+    markThumbnailDirty(indexOf(filePath));
+}
+
+void ImageThumbnailModel::onPreviewAvailable(const QString& filePath)
+{
+    // Same lazy path as full thumbnails; the load stays pending
+    markThumbnailDirty(indexOf(filePath));
+}
+
+void ImageThumbnailModel::markThumbnailDirty(int row)
+{
     if (row >= 0 && row < m_items.size()) {
-        // DON'T store a pixmap here — the QImage is already in the image cache
-        // (put there by the worker thread).  When the view repaints, data()
-        // will find it in the image cache and do a lazy QPixmap::fromImage()
-        // only for the ~20-30 items actually visible on screen.
-        //
-        // Eagerly converting every completed thumbnail to a QPixmap would
-        // monopolise the main thread during the initial loading burst,
-        // starving wheel-event processing and causing scroll lag at the top.
         m_thumbDirtyRows.append(row);
         if (!m_thumbBatchTimer->isActive()) {
             m_thumbBatchTimer->start();
@@ -888,8 +1326,12 @@ void ImageThumbnailModel::onThumbnailAvailable(const QString& filePath)
     }
 }
 
-void ImageThumbnailModel::onThumbnailFailed(const QString& filePath)
+void ImageThumbnailModel::onThumbnailFailed(const QString& filePath, int size)
 {
+    if (size != m_thumbnailSize) {
+        m_pendingSizedThumbnails.remove(ThumbnailInfo::makeCacheKey(filePath, size));
+        return;
+    }
     m_pendingThumbnails.remove(filePath);
     // Don't emit dataChanged for failures — the placeholder doesn't change,
     // so repainting would just redraw the same loading placeholder.
@@ -937,6 +1379,7 @@ void ImageThumbnailModel::refreshThumbnail(const QString& filePath)
 
 void ImageThumbnailModel::onImageTagged(const QString& imagePath, qint64 tagId)
 {
+    HotkeyLatency::Scope update(HotkeyLatency::ModelUpdate);
     int row = indexOf(imagePath);
     if (row >= 0 && row < m_items.size()) {
         m_items[row].tagIds.insert(tagId);
@@ -949,6 +1392,7 @@ void ImageThumbnailModel::onImageTagged(const QString& imagePath, qint64 tagId)
 
 void ImageThumbnailModel::onImageUntagged(const QString& imagePath, qint64 tagId)
 {
+    HotkeyLatency::Scope update(HotkeyLatency::ModelUpdate);
     int row = indexOf(imagePath);
     if (row >= 0 && row < m_items.size()) {
         m_items[row].tagIds.remove(tagId);
@@ -16,11 +16,53 @@
 #include <QSet>
 #include <QDir>
 #include <QTimer>
+#include <QColor>
+#include <QVector>
 
 #include "thumbnailcreator.h"
 
 namespace FullFrame {
 
+class MemoryReport;
+
+/**
+ * Display data for one tag badge, prebuilt once per item (supertags first)
+ */
+struct TagBadgeInfo
+{
+    QString name;
+    QColor color;
+    bool isSupertag = false;
+};
+
+using TagBadgeList = QVector<TagBadgeInfo>;
+
+/**
+ * Everything the delegate needs to paint one tile, fetched in a single call.
+ *
+ * Pointers reference model-owned data and are only valid for the duration
+ * of the paint call that requested the record.
+ */
+struct ThumbnailPaintRecord
+{
+    enum Flag : quint8 {
+        Favorited        = 0x01,
+        HasTags          = 0x02,
+        SequenceCover    = 0x04,
+        SequenceExpanded = 0x08,
+        Placeholder      = 0x10   // pixmap is the loading placeholder
+    };
+
+    const QPixmap* pixmap = nullptr;
+    const QString* fileName = nullptr;
+    const TagBadgeList* badges = nullptr;   // null when the item has no tags
+    quint8 flags = 0;
+    quint8 rating = 0;
+    int sequenceCount = 0;
+
+    bool has(Flag flag) const { return (flags & flag) != 0; }
+};
+
 /**
  * Data for a single media item (image, video, or audio)
  */
@@ -35,14 +77,26 @@ struct ImageItem
     bool selected = false;
     MediaType mediaType = MediaType::Unknown;
     
-    // Cached thumbnail to avoid repeated lookups
+    // Cached thumbnail to avoid repeated lookups. Until thumbnailLoaded is
+    // set, cachedPixmap may hold a stand-in (the upscaled progressive preview)
     mutable QPixmap cachedPixmap;
     mutable bool thumbnailLoaded = false;
     
+    // Same for one secondary size class (see ImageThumbnailModel::paintRecord)
+    mutable QPixmap sizedPixmap;
+    mutable int sizedPixmapSize = 0;
+    
     // Cached tag display data to avoid QVariantList/QVariantMap allocations per paint
-    mutable QVariantList cachedTagList;
+    mutable TagBadgeList cachedBadges;
     mutable bool tagListDirty = true;
     
+    // Denormalized paint flags/rating/sequence count, valid while
+    // paintEpoch matches the model's epoch (see ImageThumbnailModel::paintRecord)
+    mutable quint32 paintEpoch = 0;
+    mutable quint8 paintFlags = 0;
+    mutable quint8 paintRating = 0;
+    mutable int paintSequenceCount = 0;
+    
     bool isValid() const { return !filePath.isEmpty(); }
     bool isImage() const { return mediaType == MediaType::Image; }
     bool isVideo() const { return mediaType == MediaType::Video; }
@@ -103,6 +157,12 @@ public:
     // Access items
     ImageItem itemAt(int row) const;
     ImageItem itemAt(const QModelIndex& index) const;
+    
+    // Direct paint accessor for the delegate — one call per tile instead of
+    // one QVariant-boxed data() call per role. A non-zero thumbnailSize
+    // selects a secondary size class (the tagging strip) instead of the
+    // gallery's thumbnailSize().
+    ThumbnailPaintRecord paintRecord(int row, int thumbnailSize = 0) const;
     int indexOf(const QString& filePath) const;
     QModelIndex indexForPath(const QString& filePath) const;
     
@@ -119,6 +179,14 @@ public:
     void setThumbnailSize(int size);
     int thumbnailSize() const { return m_thumbnailSize; }
     
+    // Item list, per-item pixmap/badge caches and lookup table rows.
+    // Report after ThumbnailCache so pixmaps shared with it aren't counted twice
+    void reportMemory(MemoryReport& report) const;
+    
+    // While deferred, paint-time lookups never queue loads (used during zoom
+    // gestures so every intermediate size doesn't trigger a re-decode)
+    void setThumbnailRequestsDeferred(bool deferred) { m_deferThumbnailRequests = deferred; }
+    
     // Tag filtering
     void setTagFilter(const QSet<qint64>& tagIds, bool requireAll = false);
     void setShowUntagged(bool showUntagged);
@@ -148,6 +216,11 @@ public:
     // Sequences
     void refreshSequenceData();
     void toggleSequenceExpanded(const QString& coverPath);
+    
+    // Apply finished file operations without a reload: moved items keep
+    // their row (or leave/enter the view), removed items drop their rows
+    void applyFileMoves(const QHash<QString, QString>& moves);   // old → new path
+    void removeFiles(const QStringList& filePaths);
 
 Q_SIGNALS:
     void loadingStarted();
@@ -159,8 +232,9 @@ public Q_SLOTS:
     void refreshThumbnail(const QString& filePath);
 
 private Q_SLOTS:
-    void onThumbnailAvailable(const QString& filePath);
-    void onThumbnailFailed(const QString& filePath);
+    void onThumbnailAvailable(const QString& filePath, int size);
+    void onPreviewAvailable(const QString& filePath);
+    void onThumbnailFailed(const QString& filePath, int size);
     void flushThumbnailUpdates();
     void onImageTagged(const QString& imagePath, qint64 tagId);
     void onImageUntagged(const QString& imagePath, qint64 tagId);
@@ -171,11 +245,21 @@ private:
     void connectTagManager();
     void requestThumbnail(int row) const;
     void scanDirectory(const QString& path, bool recursive);
+    ImageItem itemForFile(const QFileInfo& info) const;
     bool matchesTagFilter(const ImageItem& item) const;
+    bool matchesViewFilters(const ImageItem& item) const;
     void rebuildFilteredItems();
     void applyFilenameFilter();
+    void rebuildPathIndex();
+    void removeVisibleRows(QVector<int> rows);
+    void renamePathKeys(const QString& oldPath, const QString& newPath);
     bool isInAlbumFolder(const QString& filePath) const;
     bool isFavorited(const QString& filePath) const;
+    const QPixmap& thumbnailFor(const ImageItem& item) const;
+    const QPixmap& thumbnailFor(const ImageItem& item, int size) const;
+    void markThumbnailDirty(int row);
+    const TagBadgeList& badgesFor(const ImageItem& item) const;
+    void invalidatePaintRecords() { ++m_paintEpoch; }
 
 private:
     QList<ImageItem> m_items;         // Currently visible items (after all filters)
@@ -185,6 +269,8 @@ private:
     
     int m_thumbnailSize = 256;
     mutable QSet<QString> m_pendingThumbnails;
+    mutable QSet<QString> m_pendingSizedThumbnails;   // Cache keys of loads at other sizes (strip)
+    bool m_deferThumbnailRequests = false;
     
     // Tag filter
     QSet<qint64> m_tagFilter;
@@ -209,6 +295,10 @@ private:
     QHash<QString, qint64> m_pathToSequenceId;   // any member path → seqId
     QSet<qint64> m_expandedSequences;            // currently expanded sequences
     
+    // Bumped whenever favorites/ratings/sequences change wholesale, which
+    // lazily invalidates every item's denormalized paint data
+    quint32 m_paintEpoch = 1;
+    
     // Thumbnail update batching — reduces UI thread pressure during active loading
     QTimer* m_thumbBatchTimer = nullptr;
     QVector<int> m_thumbDirtyRows;
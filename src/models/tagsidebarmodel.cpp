@@ -0,0 +1,488 @@
+/**
+ * TagSidebarModel implementation
+ */
+
+#include "tagsidebarmodel.h"
+
+#include <QColor>
+#include <QSet>
+#include <QStringMatcher>
+#include <QTimer>
+#include <QTimeZone>
+#include <utility>
+
+namespace FullFrame {
+
+namespace {
+// tagged_at is stored by SQLite as UTC without a zone
+qint64 toUtcMs(const QDateTime& stamp)
+{
+    if (!stamp.isValid()) {
+        return 0;
+    }
+    return QDateTime(stamp.date(), stamp.time(), QTimeZone::utc()).toMSecsSinceEpoch();
+}
+
+bool sameItem(const TagSidebarItem& a, const TagSidebarItem& b)
+{
+    return a.tag.name == b.tag.name
+        && a.tag.color == b.tag.color
+        && a.tag.hotkey == b.tag.hotkey
+        && a.tag.albumPath == b.tag.albumPath
+        && a.tag.parentId == b.tag.parentId
+        && a.count == b.count
+        && a.lastUsedMs == b.lastUsedMs
+        && a.childIds == b.childIds
+        && a.selectionState == b.selectionState;
+}
+}
+
+// ============== TagSidebarModel ==============
+
+TagSidebarModel::TagSidebarModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    connect(TagManager::instance(), &TagManager::tagUsageChanged,
+            this, &TagSidebarModel::applyUsage);
+}
+
+int TagSidebarModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_items.size();
+}
+
+QVariant TagSidebarModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_items.size()) {
+        return QVariant();
+    }
+
+    const TagSidebarItem& item = m_items[index.row()];
+    switch (role) {
+        case Qt::DisplayRole:
+            return item.tag.name;
+        case TagIdRole:
+            return item.tag.id;
+        case TagColorRole:
+            return item.tag.color.isEmpty() ? QColor(100, 100, 100) : QColor(item.tag.color);
+        case HotkeyRole:
+            return item.tag.hotkey;
+        case CountRole:
+            return item.count;
+        case IsAlbumTagRole:
+            return item.tag.isAlbumTag();
+        case IsGroupParentRole:
+            // The sidebar nests one level deep
+            return item.isGroupParent() && parentRow(index.row()) < 0;
+        case IsExpandedRole:
+            return item.expanded;
+        case IsIndentedRole:
+            return parentRow(index.row()) >= 0;
+        case IsFilterSelectedRole:
+            return item.filterSelected;
+        case AwaitingHotkeyRole:
+            return item.awaitingHotkey;
+        case SelectionStateRole:
+            return item.selectionState;
+        default:
+            return QVariant();
+    }
+}
+
+void TagSidebarModel::rebuildIndex()
+{
+    const int count = m_items.size();
+    m_rowById.clear();
+    m_rowById.reserve(count);
+    for (int row = 0; row < count; ++row) {
+        m_rowById.insert(m_items[row].tag.id, row);
+    }
+
+    m_parentRows.fill(-1, count);
+    m_childRows.fill(QVector<int>(), count);
+    for (int row = 0; row < count; ++row) {
+        const qint64 parentId = m_items[row].tag.parentId;
+        const int parent = parentId >= 0 ? rowForId(parentId) : -1;
+        if (parent >= 0) {
+            m_parentRows[row] = parent;
+            m_childRows[parent].append(row);
+        }
+    }
+}
+
+void TagSidebarModel::emitRowChanged(int row)
+{
+    const QModelIndex idx = index(row);
+    Q_EMIT dataChanged(idx, idx);
+
+    for (int childRow : m_childRows[row]) {
+        const QModelIndex childIdx = index(childRow);
+        Q_EMIT dataChanged(childIdx, childIdx);
+    }
+}
+
+// ============== Filtering ==============
+
+void TagSidebarModel::setFilterText(const QString& text)
+{
+    const QString filter = text.trimmed().toLower();
+    if (filter == m_filter) {
+        return;
+    }
+    m_filter = filter;
+    applyFilter();
+    Q_EMIT filterChanged();
+}
+
+void TagSidebarModel::applyFilter()
+{
+    const int count = m_items.size();
+    m_filterVisible.fill(m_filter.isEmpty(), count);
+    if (m_filter.isEmpty()) {
+        return;
+    }
+
+    // One pass over the names. A match shows its ancestors and its whole
+    // subtree; each walk stops at rows an earlier match already marked, so
+    // every row and edge is visited a bounded number of times.
+    QBitArray subtreeShown(count);
+    QVector<int> pending;
+    const QStringMatcher matcher(m_filter, Qt::CaseSensitive);
+    for (int row = 0; row < count; ++row) {
+        if (matcher.indexIn(m_items[row].lowerName) < 0) {
+            continue;
+        }
+
+        // The row and its ancestors; anything already visible has its
+        // ancestors marked
+        for (int up = row; up >= 0 && !m_filterVisible.testBit(up); up = m_parentRows[up]) {
+            m_filterVisible.setBit(up);
+        }
+
+        pending.append(row);
+        while (!pending.isEmpty()) {
+            const int next = pending.takeLast();
+            if (subtreeShown.testBit(next)) {
+                continue;
+            }
+            subtreeShown.setBit(next);
+            m_filterVisible.setBit(next);
+            pending.append(m_childRows[next]);
+        }
+    }
+}
+
+void TagSidebarModel::reload(const QStringList& countPaths)
+{
+    TagManager* manager = TagManager::instance();
+    QList<Tag> tags;
+    QHash<qint64, int> counts;
+    QHash<qint64, QDateTime> lastUsed;
+    QVector<QPair<QString, qint64>> imageTags;
+    m_countAll = countPaths.isEmpty();
+    if (manager->isInitialized()) {
+        tags = manager->allTags();
+        lastUsed = manager->tagLastUsedTimes();
+        if (m_countAll) {
+            counts = manager->tagImageCounts();
+        } else {
+            imageTags = manager->imageTagsFor(countPaths);
+        }
+    }
+
+    // The database already includes anything still pending
+    m_pendingUsage.clear();
+    m_bitmaps.reset(countPaths);
+    for (const auto& imageTag : imageTags) {
+        m_bitmaps.setTagged(imageTag.first, imageTag.second, true);
+    }
+    m_unindexedSelection = m_bitmaps.setSelection(m_selectionPaths);
+
+    QSet<qint64> ids;
+    QHash<qint64, QVector<qint64>> children;
+    ids.reserve(tags.size());
+    for (const Tag& tag : tags) {
+        ids.insert(tag.id);
+        if (tag.parentId >= 0) {
+            children[tag.parentId].append(tag.id);
+        }
+    }
+
+    // Tags that are gone, highest row first so the others stay valid
+    bool removed = false;
+    for (int row = m_items.size() - 1; row >= 0; --row) {
+        if (!ids.contains(m_items[row].tag.id)) {
+            beginRemoveRows(QModelIndex(), row, row);
+            m_items.removeAt(row);
+            endRemoveRows();
+            removed = true;
+        }
+    }
+    if (removed) {
+        rebuildIndex();
+        applyFilter();
+    }
+
+    // Changed tags in place, new ones collected for one insert. The proxies
+    // hear about the changes once the tree and filter are up to date.
+    QVector<int> changedRows;
+    QVector<TagSidebarItem> added;
+    for (const Tag& tag : tags) {
+        TagSidebarItem fresh;
+        fresh.tag = tag;
+        fresh.lowerName = tag.name.toLower();
+        fresh.count = m_countAll ? counts.value(tag.id, 0) : m_bitmaps.count(tag.id);
+        fresh.lastUsedMs = toUtcMs(lastUsed.value(tag.id));
+        fresh.childIds = children.value(tag.id);
+        fresh.selectionState = selectionStateFor(tag.id);
+
+        const int row = rowForId(tag.id);
+        if (row < 0) {
+            added.append(fresh);
+            continue;
+        }
+
+        TagSidebarItem& item = m_items[row];
+        if (!sameItem(item, fresh)) {
+            fresh.expanded = item.expanded && fresh.isGroupParent();
+            fresh.filterSelected = item.filterSelected;
+            fresh.awaitingHotkey = item.awaitingHotkey;
+            item = fresh;
+            changedRows.append(row);
+        }
+    }
+
+    if (!added.isEmpty()) {
+        const int first = m_items.size();
+        beginInsertRows(QModelIndex(), first, first + added.size() - 1);
+        m_items.append(added);
+        rebuildIndex();
+        applyFilter();
+        endInsertRows();
+    } else if (!changedRows.isEmpty()) {
+        rebuildIndex();
+        applyFilter();
+    }
+
+    for (int row : changedRows) {
+        emitRowChanged(row);
+    }
+
+    // A rename or move can show or hide rows that did not change themselves
+    if (!m_filter.isEmpty() && (removed || !added.isEmpty() || !changedRows.isEmpty())) {
+        Q_EMIT filterChanged();
+    }
+}
+
+// ============== Incremental Usage ==============
+
+void TagSidebarModel::applyUsage(const QString& imagePath, qint64 tagId, int delta)
+{
+    if (m_pendingUsage.isEmpty()) {
+        // One flush per burst, e.g. a hotkey over the whole selection
+        QTimer::singleShot(0, this, &TagSidebarModel::flushUsage);
+    }
+
+    // The bitmap is updated right away so selectionHasTag() stays exact
+    m_bitmaps.setTagged(imagePath, tagId, delta >= 0);
+
+    PendingUsage& usage = m_pendingUsage[tagId];
+    usage.delta += delta;
+    if (delta >= 0) {
+        // tagged_at is rewritten on every tagImage
+        usage.usedAtMs = QDateTime::currentMSecsSinceEpoch();
+    }
+}
+
+void TagSidebarModel::flushUsage()
+{
+    const QHash<qint64, PendingUsage> pending = std::exchange(m_pendingUsage, {});
+    for (auto it = pending.constBegin(); it != pending.constEnd(); ++it) {
+        const int row = rowForId(it.key());
+        if (row < 0) {
+            continue;
+        }
+
+        TagSidebarItem& item = m_items[row];
+        // Database-wide counts have no index behind them; apply the deltas
+        const int count = m_countAll ? qMax(0, item.count + it->delta) : m_bitmaps.count(item.tag.id);
+        const qint64 lastUsedMs = qMax(item.lastUsedMs, it->usedAtMs);
+        const Qt::CheckState selectionState = selectionStateFor(item.tag.id);
+        if (count != item.count || lastUsedMs != item.lastUsedMs) {
+            item.count = count;
+            item.lastUsedMs = lastUsedMs;
+            item.selectionState = selectionState;
+            emitRowChanged(row);
+        } else if (selectionState != item.selectionState) {
+            item.selectionState = selectionState;
+            const QModelIndex idx = index(row);
+            Q_EMIT dataChanged(idx, idx, {SelectionStateRole});
+        }
+    }
+}
+
+// ============== Selection State ==============
+
+Qt::CheckState TagSidebarModel::selectionStateFor(qint64 tagId) const
+{
+    const int selected = m_bitmaps.selectedCount(tagId);
+    if (selected == 0) {
+        return Qt::Unchecked;
+    }
+    return selected == m_bitmaps.selectionSize() && m_unindexedSelection.isEmpty()
+        ? Qt::Checked : Qt::PartiallyChecked;
+}
+
+void TagSidebarModel::setSelection(const QStringList& imagePaths)
+{
+    m_selectionPaths = imagePaths;
+    m_unindexedSelection = m_bitmaps.setSelection(imagePaths);
+
+    for (int row = 0; row < m_items.size(); ++row) {
+        TagSidebarItem& item = m_items[row];
+        const Qt::CheckState state = selectionStateFor(item.tag.id);
+        if (state != item.selectionState) {
+            item.selectionState = state;
+            const QModelIndex idx = index(row);
+            Q_EMIT dataChanged(idx, idx, {SelectionStateRole});
+        }
+    }
+}
+
+bool TagSidebarModel::selectionHasTag(qint64 tagId) const
+{
+    if (m_bitmaps.selectedCount(tagId) != m_bitmaps.selectionSize()) {
+        return false;
+    }
+    // Images outside the folder (or no folder at all) are asked directly
+    for (const QString& path : m_unindexedSelection) {
+        if (!TagManager::instance()->hasTag(path, tagId)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TagSidebarModel::setExpanded(qint64 tagId, bool expanded)
+{
+    const int row = rowForId(tagId);
+    if (row < 0 || m_items[row].expanded == expanded) {
+        return;
+    }
+    m_items[row].expanded = expanded;
+    emitRowChanged(row);
+}
+
+void TagSidebarModel::toggleExpanded(qint64 tagId)
+{
+    const int row = rowForId(tagId);
+    if (row >= 0) {
+        setExpanded(tagId, !m_items[row].expanded);
+    }
+}
+
+void TagSidebarModel::setFilterSelected(qint64 tagId, bool selected)
+{
+    const int row = rowForId(tagId);
+    if (row < 0 || m_items[row].filterSelected == selected) {
+        return;
+    }
+    m_items[row].filterSelected = selected;
+    emitRowChanged(row);
+}
+
+void TagSidebarModel::clearFilterSelection()
+{
+    for (int row = 0; row < m_items.size(); ++row) {
+        if (m_items[row].filterSelected) {
+            m_items[row].filterSelected = false;
+            emitRowChanged(row);
+        }
+    }
+}
+
+void TagSidebarModel::setAwaitingHotkey(qint64 tagId)
+{
+    for (int row = 0; row < m_items.size(); ++row) {
+        TagSidebarItem& item = m_items[row];
+        const bool awaiting = item.tag.id == tagId;
+        if (item.awaitingHotkey != awaiting) {
+            item.awaitingHotkey = awaiting;
+            const QModelIndex idx = index(row);
+            Q_EMIT dataChanged(idx, idx, {AwaitingHotkeyRole});
+        }
+    }
+}
+
+// ============== TagSidebarProxyModel ==============
+
+TagSidebarProxyModel::TagSidebarProxyModel(TagSidebarModel* source, SortOrder order, QObject* parent)
+    : QSortFilterProxyModel(parent)
+    , m_source(source)
+    , m_order(order)
+{
+    setDynamicSortFilter(true);
+    setSourceModel(source);
+    sort(0);
+
+    connect(source, &TagSidebarModel::filterChanged, this, [this]() {
+        invalidateFilter();
+    });
+}
+
+bool TagSidebarProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+{
+    Q_UNUSED(sourceParent)
+
+    // Children are listed only under an expanded top-level group
+    const int parentRow = m_source->parentRow(sourceRow);
+    if (parentRow >= 0 && (!m_source->item(parentRow).expanded || m_source->parentRow(parentRow) >= 0)) {
+        return false;
+    }
+    return m_source->filterAccepts(sourceRow);
+}
+
+bool TagSidebarProxyModel::before(const TagSidebarItem& a, const TagSidebarItem& b) const
+{
+    // Tags selected as filters stay on top
+    if (a.filterSelected != b.filterSelected) {
+        return a.filterSelected;
+    }
+
+    if (m_order == RecentFirst) {
+        if (a.lastUsedMs != b.lastUsedMs) {
+            return a.lastUsedMs > b.lastUsedMs;
+        }
+    } else if (a.count != b.count) {
+        return a.count > b.count;
+    }
+
+    if (a.lowerName != b.lowerName) {
+        return a.lowerName < b.lowerName;
+    }
+    return a.tag.id < b.tag.id;
+}
+
+bool TagSidebarProxyModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
+{
+    const int leftRow = left.row();
+    const int rightRow = right.row();
+    const int leftParent = m_source->parentRow(leftRow);
+    const int rightParent = m_source->parentRow(rightRow);
+
+    // Groups are ordered by their parent; children follow it
+    const int leftGroup = leftParent >= 0 ? leftParent : leftRow;
+    const int rightGroup = rightParent >= 0 ? rightParent : rightRow;
+    if (leftGroup != rightGroup) {
+        return before(m_source->item(leftGroup), m_source->item(rightGroup));
+    }
+    if (leftParent < 0) {
+        return rightParent >= 0;
+    }
+    if (rightParent < 0) {
+        return false;
+    }
+    return before(m_source->item(leftRow), m_source->item(rightRow));
+}
+
+} // namespace FullFrame
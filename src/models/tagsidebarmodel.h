@@ -0,0 +1,171 @@
+/**
+ * TagSidebarModel - Flat item model of every tag for the tag sidebar
+ *
+ * One row per tag, in no particular order; TagSidebarProxyModel turns it
+ * into a section of the sidebar (Recent or Popular) by sorting parents
+ * with their children grouped beneath them and hiding the children of
+ * collapsed groups. Both sections share this model, so:
+ * - reload() diffs the database against the rows it already has and only
+ *   emits dataChanged / row inserts / row removals for what differs
+ * - expanding a group, selecting a tag for filtering or waiting for a
+ *   hotkey are dataChanged on the affected rows; the proxies move or show
+ *   just those rows
+ * - tagging and untagging images adjusts counts and last-used times in
+ *   memory, batched until the event loop is idle, without re-running the
+ *   aggregate queries
+ * - counts and each tag's state over the grid selection (all / some /
+ *   none) come from a TagBitmapIndex of the folder
+ * - the search filter is evaluated once here, over a row-indexed tag tree
+ *   and the lower-cased names, and both proxies read the result
+ */
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QBitArray>
+#include <QHash>
+#include <QSortFilterProxyModel>
+#include <QStringList>
+#include <QVector>
+
+#include "tagbitmapindex.h"
+#include "tagmanager.h"
+
+namespace FullFrame {
+
+struct TagSidebarItem
+{
+    Tag tag;
+    QString lowerName;
+    int count = 0;              // Images with the tag in the current folder
+    qint64 lastUsedMs = 0;      // Most recent tagged_at, 0 if never used
+    QVector<qint64> childIds;
+    Qt::CheckState selectionState = Qt::Unchecked;   // Applied to all / some / none of the selection
+    bool expanded = false;
+    bool filterSelected = false;   // Selected in the sidebar to filter the grid
+    bool awaitingHotkey = false;
+
+    bool isGroupParent() const { return !childIds.isEmpty(); }
+};
+
+class TagSidebarModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        TagIdRole = Qt::UserRole + 1,
+        TagColorRole,
+        HotkeyRole,
+        CountRole,
+        IsAlbumTagRole,
+        IsGroupParentRole,
+        IsExpandedRole,
+        IsIndentedRole,
+        IsFilterSelectedRole,
+        AwaitingHotkeyRole,
+        SelectionStateRole      // Qt::CheckState
+    };
+
+    explicit TagSidebarModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    // Re-read tags, counts over countPaths and last-used times, applying
+    // only the differences
+    void reload(const QStringList& countPaths);
+
+    const TagSidebarItem& item(int row) const { return m_items[row]; }
+    int rowForId(qint64 tagId) const { return m_rowById.value(tagId, -1); }
+    // Row of the group a child is shown under, or -1 for top-level tags
+    int parentRow(int row) const { return m_parentRows[row]; }
+
+    // Search text; a tag is shown if its name contains it, or an ancestor's
+    // or descendant's name does
+    void setFilterText(const QString& text);
+    bool filterAccepts(int row) const { return m_filterVisible.testBit(row); }
+
+    void setExpanded(qint64 tagId, bool expanded);
+    void toggleExpanded(qint64 tagId);
+    void setFilterSelected(qint64 tagId, bool selected);
+    void clearFilterSelection();
+    void setAwaitingHotkey(qint64 tagId);   // -1 clears
+
+    // The grid selection, for SelectionStateRole
+    void setSelection(const QStringList& imagePaths);
+    // True if every selected image has the tag; current even while usage
+    // is waiting to be flushed
+    bool selectionHasTag(qint64 tagId) const;
+
+public Q_SLOTS:
+    // TagManager::tagUsageChanged; applied at the next flushUsage()
+    void applyUsage(const QString& imagePath, qint64 tagId, int delta);
+
+Q_SIGNALS:
+    // Rows that did not change may have been shown or hidden by the filter
+    void filterChanged();
+
+private:
+    // dataChanged for row, and for its children since their place in the
+    // sections follows their parent
+    void emitRowChanged(int row);
+    // Id -> row lookup and the parent/children adjacency, by row
+    void rebuildIndex();
+    // Recompute m_filterVisible in one pass over the rows
+    void applyFilter();
+    // Apply the usage collected since the last flush, one dataChanged per tag
+    void flushUsage();
+    Qt::CheckState selectionStateFor(qint64 tagId) const;
+
+private:
+    // Usage changes of one tag since the last flush
+    struct PendingUsage
+    {
+        qint64 usedAtMs = 0;   // Time tagged, 0 if only untagged
+        int delta = 0;         // Net change in tagged images
+    };
+
+    QVector<TagSidebarItem> m_items;
+    QHash<qint64, int> m_rowById;
+    QVector<int> m_parentRows;
+    QVector<QVector<int>> m_childRows;
+
+    QString m_filter;            // Lower-case
+    QBitArray m_filterVisible;   // By row
+
+    TagBitmapIndex m_bitmaps;               // Over the counted images
+    bool m_countAll = false;                // No folder: counts are database-wide
+    QStringList m_selectionPaths;
+    QStringList m_unindexedSelection;       // Selected but not in m_bitmaps
+    QHash<qint64, PendingUsage> m_pendingUsage;
+};
+
+/**
+ * One sidebar section over TagSidebarModel
+ */
+class TagSidebarProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    enum SortOrder {
+        RecentFirst,    // Most recently used first
+        PopularFirst    // Most images in the folder first
+    };
+
+    TagSidebarProxyModel(TagSidebarModel* source, SortOrder order, QObject* parent = nullptr);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+
+private:
+    bool before(const TagSidebarItem& a, const TagSidebarItem& b) const;
+
+private:
+    TagSidebarModel* m_source;
+    SortOrder m_order;
+};
+
+} // namespace FullFrame
@@ -0,0 +1,307 @@
+/**
+ * BadgeCache implementation
+ *
+ * All antialiased drawing for the grid overlays happens here, once per
+ * distinct sprite; the delegate only calls drawPixmap/drawStaticText.
+ */
+
+#include "badgecache.h"
+#include "imagethumbnailmodel.h"
+
+#include <QPainter>
+#include <QPainterPath>
+#include <QtMath>
+#include <cmath>
+
+namespace FullFrame {
+
+namespace {
+constexpr int SpriteBudgetKiB = 24 * 1024;   // 24 MB of overlay pixmaps
+constexpr int TextCacheEntries = 4096;
+}
+
+BadgeCache::BadgeCache(const QFont& badgeFont, const QFont& textFont)
+    : m_badgeFont(badgeFont)
+    , m_textFont(textFont)
+    , m_badgeFM(badgeFont)
+    , m_textFM(textFont)
+    , m_sprites(SpriteBudgetKiB)
+    , m_texts(TextCacheEntries)
+{
+}
+
+BadgeCache::~BadgeCache() = default;
+
+void BadgeCache::clear()
+{
+    m_sprites.clear();
+    m_texts.clear();
+}
+
+qint64 BadgeCache::bytes() const
+{
+    return qint64(m_sprites.totalCost()) * 1024;
+}
+
+QPixmap BadgeCache::createCanvas(const QSize& logicalSize, qreal dpr)
+{
+    QPixmap pixmap(qCeil(logicalSize.width() * dpr), qCeil(logicalSize.height() * dpr));
+    pixmap.setDevicePixelRatio(dpr);
+    pixmap.fill(Qt::transparent);
+    return pixmap;
+}
+
+const BadgeSprite* BadgeCache::insert(const SpriteKey& key, BadgeSprite* sprite)
+{
+    const qint64 bytes = qint64(sprite->pixmap.width()) * sprite->pixmap.height() *
+                         qMax(1, sprite->pixmap.depth() / 8);
+    const int cost = int(qMax<qint64>(1, bytes / 1024));
+    // QCache takes ownership; an oversize sprite is deleted and we fall
+    // back to a miss on every paint, which is still correct.
+    if (!m_sprites.insert(key, sprite, cost)) {
+        return nullptr;
+    }
+    return m_sprites.object(key);
+}
+
+// ============== Tag Badges ==============
+
+const BadgeSprite* BadgeCache::tagBadge(const TagBadgeInfo& tag, int maxWidth, qreal dpr)
+{
+    const SpriteKey key{TagBadge, tag.name, tag.color.rgba(), maxWidth, tag.isSupertag ? 1 : 0, dpr};
+    if (const BadgeSprite* cached = m_sprites.object(key)) {
+        return cached;
+    }
+
+    const int height = tag.isSupertag ? SupertagHeight : BadgeHeight;
+    const int padding = tag.isSupertag ? SupertagPadding : BadgePadding;
+    int width = m_badgeFM.horizontalAdvance(tag.name) + padding * 2;
+    if (maxWidth > 0 && width > maxWidth) {
+        width = maxWidth;
+    }
+
+    const int radius = 3;
+    const int shadow = tag.isSupertag ? 2 : 0;
+
+    auto* sprite = new BadgeSprite;
+    sprite->size = QSize(width, height);
+    sprite->pixmap = createCanvas(QSize(width + shadow, height + shadow), dpr);
+
+    QPainter painter(&sprite->pixmap);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(Qt::NoPen);
+    const QRect badgeRect(0, 0, width, height);
+
+    // Drop shadow for supertags
+    if (shadow > 0) {
+        painter.setBrush(QColor(0, 0, 0, 100));
+        painter.drawRoundedRect(badgeRect.translated(shadow, shadow), radius, radius);
+    }
+
+    // Badge background with slight transparency
+    QColor fillColor = tag.color;
+    fillColor.setAlpha(220);
+    painter.setBrush(fillColor);
+    painter.drawRoundedRect(badgeRect, radius, radius);
+
+    // Text - white or black depending on background brightness
+    const QColor& bg = tag.color;
+    const int brightness = (bg.red() * 299 + bg.green() * 587 + bg.blue() * 114) / 1000;
+    painter.setPen(brightness > 128 ? Qt::black : Qt::white);
+    painter.setFont(m_badgeFont);
+    const QString displayName = m_badgeFM.elidedText(tag.name, Qt::ElideRight, width - padding * 2);
+    painter.drawText(badgeRect, Qt::AlignCenter, displayName);
+    painter.end();
+
+    return insert(key, sprite);
+}
+
+// ============== Rating / Favorite ==============
+
+const BadgeSprite* BadgeCache::ratingPill(int rating, qreal dpr)
+{
+    rating = qBound(1, rating, 5);
+    const SpriteKey key{RatingPill, QString(), 0, rating, 0, dpr};
+    if (const BadgeSprite* cached = m_sprites.object(key)) {
+        return cached;
+    }
+
+    // Each dot is colored based on the overall rating level
+    static const QColor ratingColors[] = {
+        QColor(0, 0, 0, 0),     // 0 - unused
+        QColor(244, 67, 54),     // 1 - red (reject/poor)
+        QColor(255, 152, 0),     // 2 - orange (below average)
+        QColor(255, 235, 59),    // 3 - yellow (average)
+        QColor(139, 195, 74),    // 4 - light green (good)
+        QColor(76, 175, 80)      // 5 - green (excellent)
+    };
+
+    const int totalWidth = rating * RatingDotSize + (rating - 1) * RatingDotSpacing;
+    const QSize pillSize(totalWidth + 6, RatingDotSize + 4);
+
+    auto* sprite = new BadgeSprite;
+    sprite->size = pillSize;
+    sprite->pixmap = createCanvas(pillSize, dpr);
+
+    QPainter painter(&sprite->pixmap);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(Qt::NoPen);
+
+    // Shadow/background pill behind dots for visibility
+    painter.setBrush(QColor(0, 0, 0, 160));
+    painter.drawRoundedRect(QRect(QPoint(0, 0), pillSize), pillSize.height() / 2.0, pillSize.height() / 2.0);
+
+    painter.setBrush(ratingColors[rating]);
+    for (int i = 0; i < rating; ++i) {
+        painter.drawEllipse(3 + i * (RatingDotSize + RatingDotSpacing), 2, RatingDotSize, RatingDotSize);
+    }
+    painter.end();
+
+    return insert(key, sprite);
+}
+
+const BadgeSprite* BadgeCache::favoriteStar(qreal dpr)
+{
+    const SpriteKey key{FavoriteStar, QString(), 0, 0, 0, dpr};
+    if (const BadgeSprite* cached = m_sprites.object(key)) {
+        return cached;
+    }
+
+    // 1px of room on each side for the outline pen
+    auto* sprite = new BadgeSprite;
+    sprite->size = QSize(StarSize, StarSize);
+    sprite->offset = QPoint(-1, -1);
+    sprite->pixmap = createCanvas(QSize(StarSize + 2, StarSize + 2), dpr);
+
+    QPainterPath starPath;
+    const QPointF center(1 + StarSize / 2.0, 1 + StarSize / 2.0);
+    const double outerRadius = StarSize / 2.0;
+    const double innerRadius = outerRadius * 0.4;
+    for (int i = 0; i < 10; ++i) {
+        const double angle = (i * M_PI) / 5.0;
+        const double radius = (i % 2 == 0) ? outerRadius : innerRadius;
+        const double px = center.x() + radius * cos(angle - M_PI / 2.0);
+        const double py = center.y() + radius * sin(angle - M_PI / 2.0);
+        if (i == 0) starPath.moveTo(px, py);
+        else        starPath.lineTo(px, py);
+    }
+    starPath.closeSubpath();
+
+    QPainter painter(&sprite->pixmap);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(QPen(QColor(0, 0, 0, 100), 1));
+    painter.setBrush(QColor(255, 215, 0));
+    painter.drawPath(starPath);
+    painter.end();
+
+    return insert(key, sprite);
+}
+
+// ============== Sequence Badge ==============
+
+const BadgeSprite* BadgeCache::sequenceBadge(int count, bool expanded, qreal dpr)
+{
+    const SpriteKey key{SequenceBadge, QString(), 0, count, expanded ? 1 : 0, dpr};
+    if (const BadgeSprite* cached = m_sprites.object(key)) {
+        return cached;
+    }
+
+    const QRect badge(0, 0, SequenceBadgeWidth, SequenceBadgeHeight);
+
+    auto* sprite = new BadgeSprite;
+    sprite->size = badge.size();
+    sprite->pixmap = createCanvas(badge.size(), dpr);
+
+    QPainter painter(&sprite->pixmap);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+
+    // Background pill
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 180));
+    painter.drawRoundedRect(badge, badge.height() / 2.0, badge.height() / 2.0);
+
+    // Stack icon (two tiny offset rectangles)
+    const int iconX = badge.left() + 6;
+    const int iconY = badge.top() + 4;
+    const int cw = 10, ch = 8;
+    painter.setPen(QPen(QColor(180, 180, 180), 1));
+    painter.setBrush(QColor(100, 100, 100, 180));
+    painter.drawRoundedRect(iconX + 2, iconY, cw, ch, 1, 1);
+    painter.setBrush(QColor(70, 70, 70, 220));
+    painter.drawRoundedRect(iconX, iconY + 2, cw, ch, 1, 1);
+
+    // Count text
+    painter.setFont(m_badgeFont);
+    painter.setPen(Qt::white);
+    const QRect textArea(iconX + cw + 4, badge.top(), 20, badge.height());
+    painter.drawText(textArea, Qt::AlignVCenter | Qt::AlignLeft, QString::number(count));
+
+    // Chevron arrow (▼ or ▲)
+    const int chevX = textArea.right() + 2;
+    const int chevY = badge.top() + badge.height() / 2;
+    QPainterPath chevron;
+    if (expanded) {
+        chevron.moveTo(chevX, chevY + 2);
+        chevron.lineTo(chevX + 4, chevY - 3);
+        chevron.lineTo(chevX + 8, chevY + 2);
+    } else {
+        chevron.moveTo(chevX, chevY - 2);
+        chevron.lineTo(chevX + 4, chevY + 3);
+        chevron.lineTo(chevX + 8, chevY - 2);
+    }
+    chevron.closeSubpath();
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(Qt::white);
+    painter.drawPath(chevron);
+    painter.end();
+
+    return insert(key, sprite);
+}
+
+// ============== Selection Frame ==============
+
+const BadgeSprite* BadgeCache::selectionFrame(const QSize& thumbSize, const QColor& color, qreal dpr)
+{
+    const SpriteKey key{SelectionFrame, QString(), color.rgba(), thumbSize.width(), thumbSize.height(), dpr};
+    if (const BadgeSprite* cached = m_sprites.object(key)) {
+        return cached;
+    }
+
+    // The 3px pen straddles a rect grown by 2px, so the stroke reaches 4px
+    // (rounded up) outside the thumbnail on every side
+    const int outset = 4;
+
+    auto* sprite = new BadgeSprite;
+    sprite->size = thumbSize;
+    sprite->offset = QPoint(-outset, -outset);
+    sprite->pixmap = createCanvas(thumbSize + QSize(outset * 2, outset * 2), dpr);
+
+    QPainter painter(&sprite->pixmap);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(QPen(color, 3));
+    painter.setBrush(Qt::NoBrush);
+    const QRect frame(outset, outset, thumbSize.width(), thumbSize.height());
+    painter.drawRoundedRect(frame.adjusted(-2, -2, 2, 2), 6, 6);
+    painter.end();
+
+    return insert(key, sprite);
+}
+
+// ============== Text ==============
+
+const QStaticText* BadgeCache::elidedText(const QString& text, int width)
+{
+    const TextKey key{text, width};
+    if (const QStaticText* cached = m_texts.object(key)) {
+        return cached;
+    }
+
+    auto* staticText = new QStaticText(m_textFM.elidedText(text, Qt::ElideMiddle, width));
+    staticText->setTextFormat(Qt::PlainText);
+    staticText->setPerformanceHint(QStaticText::AggressiveCaching);
+    staticText->prepare(QTransform(), m_textFont);
+    m_texts.insert(key, staticText);
+    return m_texts.object(key);
+}
+
+} // namespace FullFrame
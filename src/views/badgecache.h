@@ -0,0 +1,124 @@
+/**
+ * BadgeCache - Pre-rendered overlay sprites for ThumbnailDelegate
+ *
+ * Tag badges, rating pills, the favorite star, sequence badges and the
+ * selection frame are rendered once (antialiased, at the device pixel
+ * ratio of the target) and afterwards only blitted. Elided filenames are
+ * kept as prepared QStaticText keyed by (name, width), so a repaint does
+ * no text layout at all.
+ */
+
+#pragma once
+
+#include <QCache>
+#include <QColor>
+#include <QFont>
+#include <QFontMetrics>
+#include <QPixmap>
+#include <QStaticText>
+
+namespace FullFrame {
+
+struct TagBadgeInfo;
+
+/**
+ * One cached overlay. `size` is the logical footprint used for layout;
+ * the pixmap may extend past it by `offset` (shadows, outer strokes).
+ */
+struct BadgeSprite
+{
+    QPixmap pixmap;
+    QPoint offset;
+    QSize size;
+};
+
+class BadgeCache
+{
+public:
+    BadgeCache(const QFont& badgeFont, const QFont& textFont);
+    ~BadgeCache();
+
+    // maxWidth == 0 means natural width; otherwise the badge is clamped
+    // (and its text elided) to maxWidth logical pixels
+    const BadgeSprite* tagBadge(const TagBadgeInfo& tag, int maxWidth, qreal dpr);
+    const BadgeSprite* ratingPill(int rating, qreal dpr);
+    const BadgeSprite* favoriteStar(qreal dpr);
+    const BadgeSprite* sequenceBadge(int count, bool expanded, qreal dpr);
+    const BadgeSprite* selectionFrame(const QSize& thumbSize, const QColor& color, qreal dpr);
+
+    // Elided (ElideMiddle) filename prepared for drawStaticText()
+    const QStaticText* elidedText(const QString& text, int width);
+
+    void clear();
+    qint64 bytes() const;
+
+    // Badge geometry shared with the delegate's layout code
+    static constexpr int BadgeHeight = 16;
+    static constexpr int SupertagHeight = 20;
+    static constexpr int BadgePadding = 6;
+    static constexpr int SupertagPadding = 8;
+    static constexpr int SequenceBadgeWidth = 68;
+    static constexpr int SequenceBadgeHeight = 22;
+    static constexpr int StarSize = 16;
+    static constexpr int RatingDotSize = 6;
+    static constexpr int RatingDotSpacing = 3;
+
+private:
+    enum SpriteKind : quint8 {
+        TagBadge,
+        RatingPill,
+        FavoriteStar,
+        SequenceBadge,
+        SelectionFrame
+    };
+
+    struct SpriteKey
+    {
+        SpriteKind kind;
+        QString text;
+        QRgb color = 0;
+        int a = 0;
+        int b = 0;
+        qreal dpr = 1.0;
+
+        bool operator==(const SpriteKey& other) const
+        {
+            return kind == other.kind && a == other.a && b == other.b &&
+                   color == other.color && dpr == other.dpr && text == other.text;
+        }
+        friend size_t qHash(const SpriteKey& key, size_t seed = 0)
+        {
+            return qHashMulti(seed, int(key.kind), key.text, key.color, key.a, key.b, key.dpr);
+        }
+    };
+
+    struct TextKey
+    {
+        QString text;
+        int width = 0;
+
+        bool operator==(const TextKey& other) const
+        {
+            return width == other.width && text == other.text;
+        }
+        friend size_t qHash(const TextKey& key, size_t seed = 0)
+        {
+            return qHashMulti(seed, key.text, key.width);
+        }
+    };
+
+    const BadgeSprite* insert(const SpriteKey& key, BadgeSprite* sprite);
+    static QPixmap createCanvas(const QSize& logicalSize, qreal dpr);
+
+private:
+    QFont m_badgeFont;
+    QFont m_textFont;
+    QFontMetrics m_badgeFM;
+    QFontMetrics m_textFM;
+
+    // Cost is in KiB of pixmap memory
+    QCache<SpriteKey, BadgeSprite> m_sprites;
+    QCache<TextKey, QStaticText> m_texts;
+};
+
+} // namespace FullFrame
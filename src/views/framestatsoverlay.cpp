@@ -0,0 +1,335 @@
+/**
+ * FrameStatsOverlay implementation
+ */
+
+#include "framestatsoverlay.h"
+#include "thumbnailloadthread.h"
+#include "hotkeylatency.h"
+
+#include <QFontDatabase>
+#include <QJsonArray>
+#include <QPainter>
+#include <QTimer>
+#include <QWidget>
+#include <algorithm>
+
+namespace FullFrame {
+
+namespace {
+constexpr double FrameBudgetMs = 1000.0 / 60.0;
+constexpr double GraphCeilingMs = FrameBudgetMs * 2.0;
+
+QColor frameColor(double paintMs)
+{
+    if (paintMs < FrameBudgetMs / 2.0) return QColor(76, 175, 80);
+    if (paintMs < FrameBudgetMs)       return QColor(255, 193, 7);
+    return QColor(244, 67, 54);
+}
+}
+
+FrameStatsOverlay::FrameStatsOverlay(QWidget* viewport, const QString& name)
+    : QObject(viewport)
+    , m_viewport(viewport)
+    , m_name(name)
+    , m_history(HistoryCapacity)
+    , m_refreshTimer(new QTimer(this))
+{
+    PerfCounters::acquire();
+    m_clock.start();
+
+    m_font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    m_font.setPointSize(8);
+
+    // The HUD is only repainted as part of a frame; refresh it on its own
+    // a few times a second so it stays current when nothing else paints
+    m_refreshTimer->setInterval(250);
+    connect(m_refreshTimer, &QTimer::timeout, this, &FrameStatsOverlay::invalidate);
+    m_refreshTimer->start();
+
+    invalidate();
+}
+
+FrameStatsOverlay::~FrameStatsOverlay()
+{
+    PerfCounters::release();
+}
+
+QRect FrameStatsOverlay::hudRect() const
+{
+    const int wanted = HudHeight + (HotkeyLatency::count() > 0 ? LatencyPanelHeight : 0);
+    const int height = qMin(wanted, m_viewport->height() - 16);
+    return QRect(m_viewport->width() - HudWidth - 8, 8, HudWidth, qMax(0, height));
+}
+
+void FrameStatsOverlay::invalidate()
+{
+    m_viewport->update(hudRect());
+}
+
+// ============== Recording ==============
+
+void FrameStatsOverlay::beginFrame(const QRect& dirtyRect)
+{
+    // Repaints of only the HUD itself are not frames of the view
+    m_recording = !hudRect().contains(dirtyRect);
+    if (!m_recording) {
+        return;
+    }
+    m_frameDirtyArea = dirtyRect.width() * dirtyRect.height();
+    m_frameStart = PerfCounters::snapshot();
+    m_frameTimer.start();
+}
+
+void FrameStatsOverlay::endFrame()
+{
+    if (!m_recording) {
+        return;
+    }
+    m_recording = false;
+
+    const qint64 elapsedNs = m_frameTimer.nsecsElapsed();
+    const PerfCounters::Snapshot delta = PerfCounters::snapshot() - m_frameStart;
+
+    FrameRecord& record = m_history[m_head];
+    record.timestampMs = m_clock.elapsed();
+    record.paintMs = elapsedNs / 1.0e6;
+    record.dirtyArea = m_frameDirtyArea;
+    record.tiles = int(delta[PerfCounters::TilesPainted]);
+    record.pixmapHits = int(delta[PerfCounters::PixmapCacheHit]);
+    record.pixmapMisses = int(delta[PerfCounters::PixmapCacheMiss]);
+    record.imageHits = int(delta[PerfCounters::ImageCacheHit]);
+    record.imageMisses = int(delta[PerfCounters::ImageCacheMiss]);
+    record.fromImage = int(delta[PerfCounters::PixmapFromImage]);
+    record.loadsCompleted = int(delta[PerfCounters::LoadsCompleted]);
+    record.queueDepth = ThumbnailLoadThread::instance()->pendingCount();
+
+    m_head = (m_head + 1) % HistoryCapacity;
+    m_count = qMin(m_count + 1, int(HistoryCapacity));
+
+    HotkeyLatency::framePainted();
+}
+
+const FrameStatsOverlay::FrameRecord& FrameStatsOverlay::recordAt(int age) const
+{
+    return m_history[(m_head - 1 - age + HistoryCapacity) % HistoryCapacity];
+}
+
+// ============== HUD ==============
+
+void FrameStatsOverlay::paint(QPainter* painter) const
+{
+    const QRect fullHud = hudRect();
+    if (fullHud.height() < 24) {
+        return;
+    }
+    const QRect hud(fullHud.topLeft(), QSize(fullHud.width(), qMin(fullHud.height(), int(HudHeight))));
+
+    painter->save();
+    painter->setClipRect(fullHud, Qt::IntersectClip);
+    painter->fillRect(fullHud, QColor(0, 0, 0, 190));
+    painter->setFont(m_font);
+    painter->setPen(QColor(220, 220, 220));
+
+    // Latest frame, plus average/worst over the last second
+    FrameRecord latest;
+    double sumMs = 0.0;
+    double maxMs = 0.0;
+    int frames = 0;
+    if (m_count > 0) {
+        latest = recordAt(0);
+        for (int age = 0; age < m_count; ++age) {
+            const FrameRecord& record = recordAt(age);
+            if (latest.timestampMs - record.timestampMs > 1000) {
+                break;
+            }
+            sumMs += record.paintMs;
+            maxMs = qMax(maxMs, record.paintMs);
+            ++frames;
+        }
+    }
+
+    const QStringList lines = {
+        QString("%1 %2 ms  avg %3 max %4")
+            .arg(m_name, -6)
+            .arg(latest.paintMs, 5, 'f', 2)
+            .arg(frames ? sumMs / frames : 0.0, 0, 'f', 2)
+            .arg(maxMs, 0, 'f', 1),
+        QString("tiles %1  fromImage %2  fps %3")
+            .arg(latest.tiles, 3)
+            .arg(latest.fromImage, 2)
+            .arg(frames),
+        QString("pix %1/%2  img %3/%4 hit/miss")
+            .arg(latest.pixmapHits).arg(latest.pixmapMisses)
+            .arg(latest.imageHits).arg(latest.imageMisses),
+        QString("queue %1  loaded %2")
+            .arg(latest.queueDepth)
+            .arg(latest.loadsCompleted)
+    };
+
+    const int lineHeight = painter->fontMetrics().height();
+    int y = hud.top() + 4;
+    for (const QString& line : lines) {
+        painter->drawText(QRect(hud.left() + 6, y, hud.width() - 12, lineHeight),
+                          Qt::AlignLeft | Qt::AlignVCenter, line);
+        y += lineHeight;
+    }
+
+    // Rolling frame-time graph, newest frame on the right
+    const QRect graph(hud.left() + 6, y + 2, hud.width() - 12, hud.bottom() - y - 5);
+    if (graph.height() > 4) {
+        const int barCount = qMin(m_count, int(GraphFrames));
+        const double barWidth = double(graph.width()) / GraphFrames;
+        for (int age = 0; age < barCount; ++age) {
+            const FrameRecord& record = recordAt(age);
+            const int barHeight = qMax(1, int(qMin(record.paintMs / GraphCeilingMs, 1.0) * graph.height()));
+            const int x = graph.right() - int((age + 1) * barWidth) + 1;
+            painter->fillRect(QRect(x, graph.bottom() - barHeight + 1, qMax(1, int(barWidth)), barHeight),
+                              frameColor(record.paintMs));
+        }
+
+        // 60 fps budget line sits halfway up the graph
+        painter->setPen(QColor(255, 255, 255, 90));
+        const int budgetY = graph.bottom() - graph.height() / 2;
+        painter->drawLine(graph.left(), budgetY, graph.right(), budgetY);
+    }
+
+    if (fullHud.height() > HudHeight + 24) {
+        paintHotkeyLatency(painter, fullHud.adjusted(0, HudHeight, 0, 0));
+    }
+
+    painter->restore();
+}
+
+void FrameStatsOverlay::paintHotkeyLatency(QPainter* painter, const QRect& panel) const
+{
+    const HotkeyLatency::Record& latest = HotkeyLatency::recordAt(0);
+    auto ms = [](qint64 us) { return QString::number(us / 1000.0, 'f', 1); };
+
+    painter->setPen(QColor(255, 255, 255, 60));
+    painter->drawLine(panel.left() + 6, panel.top(), panel.right() - 6, panel.top());
+    painter->setPen(QColor(220, 220, 220));
+
+    const QStringList lines = {
+        QString("hotkey %1 %2 ms%3  x%4")
+            .arg(latest.key, -3)
+            .arg(ms(latest.totalUs))
+            .arg(latest.painted ? "" : " (no paint)")
+            .arg(latest.imageCount),
+        QString("db %1 wr %2 sig %3 mdl %4 pt %5")
+            .arg(ms(latest.phaseUs[HotkeyLatency::DbLookup]))
+            .arg(ms(latest.phaseUs[HotkeyLatency::DbWrite]))
+            .arg(ms(latest.phaseUs[HotkeyLatency::SignalFanOut]))
+            .arg(ms(latest.phaseUs[HotkeyLatency::ModelUpdate]))
+            .arg(ms(latest.phaseUs[HotkeyLatency::Repaint]))
+    };
+
+    const int lineHeight = painter->fontMetrics().height();
+    int y = panel.top() + 4;
+    for (const QString& line : lines) {
+        painter->drawText(QRect(panel.left() + 6, y, panel.width() - 12, lineHeight),
+                          Qt::AlignLeft | Qt::AlignVCenter, line);
+        y += lineHeight;
+    }
+
+    // Histogram of total latency over the kept traces, labelled with each
+    // bucket's upper bound in ms
+    const QRect graph(panel.left() + 6, y + 2, panel.width() - 12, panel.bottom() - y - 5 - lineHeight);
+    if (graph.height() <= 4) {
+        return;
+    }
+    int tallest = 1;
+    for (int bucket = 0; bucket < HotkeyLatency::BucketCount; ++bucket) {
+        tallest = qMax(tallest, HotkeyLatency::bucketCount(bucket));
+    }
+    const int slotWidth = graph.width() / HotkeyLatency::BucketCount;
+    for (int bucket = 0; bucket < HotkeyLatency::BucketCount; ++bucket) {
+        const int x = graph.left() + bucket * slotWidth;
+        const int count = HotkeyLatency::bucketCount(bucket);
+        const double limitMs = HotkeyLatency::bucketLimitMs(bucket);
+        if (count > 0) {
+            // Green within one frame, amber within two, red beyond
+            const int barHeight = qMax(1, count * graph.height() / tallest);
+            painter->fillRect(QRect(x + 1, graph.bottom() - barHeight + 1, slotWidth - 2, barHeight),
+                              frameColor(qMin(limitMs, GraphCeilingMs * 2.0) / 2.0));
+        }
+
+        const QString label = bucket == HotkeyLatency::BucketCount - 1 ? QString("+")
+                            : limitMs < 1.0 ? QString(".5") : QString::number(int(limitMs));
+        painter->setPen(QColor(160, 160, 160));
+        painter->drawText(QRect(x, graph.bottom() + 1, slotWidth, lineHeight), Qt::AlignCenter, label);
+    }
+}
+
+// ============== Export ==============
+
+QJsonObject FrameStatsOverlay::toJson(int seconds) const
+{
+    QJsonObject result;
+    result["view"] = m_name;
+    result["seconds"] = seconds;
+
+    if (m_count == 0) {
+        result["frames"] = QJsonArray();
+        return result;
+    }
+
+    const qint64 newest = recordAt(0).timestampMs;
+    const qint64 cutoff = newest - qint64(seconds) * 1000;
+
+    // Walk back to the oldest frame inside the window, then emit in order
+    int oldestAge = -1;
+    while (oldestAge + 1 < m_count && recordAt(oldestAge + 1).timestampMs >= cutoff) {
+        ++oldestAge;
+    }
+
+    QJsonArray frames;
+    QVector<double> times;
+    times.reserve(oldestAge + 1);
+    for (int age = oldestAge; age >= 0; --age) {
+        const FrameRecord& record = recordAt(age);
+        QJsonObject frame;
+        frame["tMs"] = double(record.timestampMs);
+        frame["paintMs"] = record.paintMs;
+        frame["dirtyArea"] = record.dirtyArea;
+        frame["tiles"] = record.tiles;
+        frame["pixmapCacheHits"] = record.pixmapHits;
+        frame["pixmapCacheMisses"] = record.pixmapMisses;
+        frame["imageCacheHits"] = record.imageHits;
+        frame["imageCacheMisses"] = record.imageMisses;
+        frame["fromImageConversions"] = record.fromImage;
+        frame["loadsCompleted"] = record.loadsCompleted;
+        frame["queueDepth"] = record.queueDepth;
+        frames.append(frame);
+        times.append(record.paintMs);
+    }
+    result["frames"] = frames;
+
+    if (!times.isEmpty()) {
+        std::sort(times.begin(), times.end());
+        double sum = 0.0;
+        int overBudget = 0;
+        for (double t : times) {
+            sum += t;
+            if (t > FrameBudgetMs) {
+                ++overBudget;
+            }
+        }
+        auto percentile = [&times](double p) {
+            return times[qMin(times.size() - 1, qsizetype(p * times.size()))];
+        };
+
+        QJsonObject summary;
+        summary["frameCount"] = int(times.size());
+        summary["avgMs"] = sum / times.size();
+        summary["p50Ms"] = percentile(0.50);
+        summary["p95Ms"] = percentile(0.95);
+        summary["p99Ms"] = percentile(0.99);
+        summary["maxMs"] = times.last();
+        summary["overBudget"] = overBudget;
+        result["summary"] = summary;
+    }
+
+    return result;
+}
+
+} // namespace FullFrame
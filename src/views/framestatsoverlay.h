@@ -0,0 +1,106 @@
+/**
+ * FrameStatsOverlay - Frame-time and paint-cost HUD for item views
+ *
+ * A view that owns one brackets its paintEvent with beginFrame()/endFrame()
+ * and then calls paint(). Each frame records the paint time and the deltas
+ * of the shared PerfCounters (tiles painted, cache hits/misses, fromImage
+ * conversions) plus the loader queue depth. The HUD shows the latest frame
+ * and a rolling frame-time graph; toJson() exports the last N seconds.
+ *
+ * Views only create an overlay while the HUD is switched on, so with the
+ * HUD off the paint path pays one null-pointer test.
+ *
+ * Once tag hotkeys have been traced (see HotkeyLatency) the HUD grows a
+ * second panel with the latest keystroke-to-paint breakdown and a latency
+ * histogram.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QFont>
+#include <QJsonObject>
+#include <QRect>
+#include <QVector>
+
+#include "perfcounters.h"
+
+class QPainter;
+class QTimer;
+class QWidget;
+
+namespace FullFrame {
+
+class FrameStatsOverlay : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct FrameRecord
+    {
+        qint64 timestampMs = 0;   // Since the overlay was created
+        double paintMs = 0.0;
+        int dirtyArea = 0;        // Pixels covered by the dirty rect
+        int tiles = 0;
+        int pixmapHits = 0;
+        int pixmapMisses = 0;
+        int imageHits = 0;
+        int imageMisses = 0;
+        int fromImage = 0;
+        int loadsCompleted = 0;
+        int queueDepth = 0;
+    };
+
+    // Seconds of history kept for toJson(); at 60 fps this is ~7000 frames
+    static constexpr int HistorySeconds = 120;
+
+    FrameStatsOverlay(QWidget* viewport, const QString& name);
+    ~FrameStatsOverlay() override;
+
+    QString name() const { return m_name; }
+
+    // Bracket the view's own painting (not the HUD) with these
+    void beginFrame(const QRect& dirtyRect);
+    void endFrame();
+
+    // Draw the HUD in viewport coordinates
+    void paint(QPainter* painter) const;
+    QRect hudRect() const;
+
+    // Schedule a repaint of just the HUD area (e.g. after a scroll blit)
+    void invalidate();
+
+    // Frames recorded within the last `seconds`, plus a summary
+    QJsonObject toJson(int seconds) const;
+
+private:
+    const FrameRecord& recordAt(int age) const;   // 0 = newest
+    void paintHotkeyLatency(QPainter* painter, const QRect& panel) const;
+
+private:
+    QWidget* m_viewport;
+    QString m_name;
+    QFont m_font;
+
+    QElapsedTimer m_clock;
+    QElapsedTimer m_frameTimer;
+    PerfCounters::Snapshot m_frameStart;
+    int m_frameDirtyArea = 0;
+    bool m_recording = false;
+
+    // Ring buffer of recorded frames
+    QVector<FrameRecord> m_history;
+    int m_head = 0;
+    int m_count = 0;
+
+    QTimer* m_refreshTimer;
+
+    static constexpr int HistoryCapacity = HistorySeconds * 60;
+    static constexpr int GraphFrames = 120;
+    static constexpr int HudWidth = 236;
+    static constexpr int HudHeight = 96;
+    static constexpr int LatencyPanelHeight = 76;
+};
+
+} // namespace FullFrame
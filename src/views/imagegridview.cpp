@@ -5,7 +5,8 @@
  * - Only request thumbnails for visible items
  * - Preload thumbnails just outside visible area
  * - Debounce preload requests during fast scrolling
- * - Efficient grid layout using QListView IconMode
+ * - Arithmetic grid layout: cell(row) = (row % columns, row / columns),
+ *   so nothing here ever iterates the whole model
  */
 
 #include "imagegridview.h"
@@ -14,20 +15,29 @@
 #include "thumbnailloadthread.h"
 #include "thumbnailcache.h"
 #include "thumbnailcreator.h"
+#include "framestatsoverlay.h"
+#include "eventtrace.h"
 
 #include <QScrollBar>
 #include <QWheelEvent>
 #include <QContextMenuEvent>
 #include <QPainter>
 #include <QPaintEvent>
+#include <QStyleOptionRubberBand>
+#include <QRubberBand>
 #include <QApplication>
+#include <QLocale>
 #include <QDebug>
 
+#include <climits>
+
 namespace FullFrame {
 
 ImageGridView::ImageGridView(QWidget* parent)
-    : QListView(parent)
+    : QAbstractItemView(parent)
     , m_preloadTimer(new QTimer(this))
+    , m_zoomSettleTimer(new QTimer(this))
+    , m_scrollSettleTimer(new QTimer(this))
 {
     // Create delegate first - setupView calls updateGridSize which uses m_delegate
     m_delegate = new ThumbnailDelegate(this);
@@ -43,6 +53,17 @@ ImageGridView::ImageGridView(QWidget* parent)
     m_preloadTimer->setInterval(50);  // 50ms debounce
     connect(m_preloadTimer, &QTimer::timeout, this, &ImageGridView::preloadVisibleThumbnails);
 
+    // Zoom settle timer - a slider drag steps through many sizes; only the
+    // one it comes to rest on is worth decoding
+    m_zoomSettleTimer->setSingleShot(true);
+    m_zoomSettleTimer->setInterval(250);
+    connect(m_zoomSettleTimer, &QTimer::timeout, this, &ImageGridView::onZoomSettled);
+
+    // Scroll settle timer - ends fast-scroll mode once movement stops
+    m_scrollSettleTimer->setSingleShot(true);
+    m_scrollSettleTimer->setInterval(60);
+    connect(m_scrollSettleTimer, &QTimer::timeout, this, &ImageGridView::onScrollSettled);
+
     // Note: Selection model connection is done in setImageModel() after model is set
 }
 
@@ -50,16 +71,6 @@ ImageGridView::~ImageGridView() = default;
 
 void ImageGridView::setupView()
 {
-    // Use ListMode + wrapping instead of IconMode.
-    // IconMode builds a BSP tree for spatial queries — its cost is position-dependent
-    // (slower near the top where the tree is denser), causing scroll lag.
-    // ListMode uses simple row-based math: O(1) per visible item, position-independent.
-    setViewMode(QListView::ListMode);
-    setFlow(QListView::LeftToRight);
-    setWrapping(true);
-    setResizeMode(QListView::Adjust);
-    setLayoutMode(QListView::SinglePass);
-
     // Selection
     setSelectionMode(QAbstractItemView::ExtendedSelection);
     setSelectionBehavior(QAbstractItemView::SelectItems);
@@ -70,10 +81,6 @@ void ImageGridView::setupView()
     setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
     verticalScrollBar()->setSingleStep(20);
 
-    // Appearance
-    setUniformItemSizes(true);  // Important for performance!
-    setSpacing(m_spacing);
-    
     // Disable mouse tracking to prevent flickering on hover
     setMouseTracking(false);
     viewport()->setMouseTracking(false);
@@ -85,13 +92,13 @@ void ImageGridView::setupView()
     // Tell Qt we paint the entire area — skip redundant background fill before each paint
     viewport()->setAttribute(Qt::WA_OpaquePaintEvent, true);
     
-    // Style — ONLY QListView and QScrollBar rules.
-    // Per-item rules (QListView::item, ::item:selected, ::item:hover) are intentionally
+    // Style — ONLY the view and QScrollBar rules.
+    // Per-item rules (::item, ::item:selected, ::item:hover) are intentionally
     // omitted because our delegate paints its own background. Stylesheet per-item rules
     // force Qt's QStyleSheetStyle to match CSS selectors for every visible item on every
     // repaint, which is measurable overhead during scroll.
     setStyleSheet(R"(
-        QListView {
+        QAbstractItemView {
             background-color: #1e1e1e;
             border: none;
             outline: none;
@@ -159,18 +166,44 @@ void ImageGridView::setThumbnailSize(int size)
         m_thumbnailSize = size;
         m_delegate->setThumbnailSize(size);
         
+        // Existing pixmaps are scaled at paint time until the gesture ends
+        m_preloadTimer->stop();
+        m_zoomSettleTimer->start();
+        updateRequestDeferral();
+
         if (m_model) {
             m_model->setThumbnailSize(size);
         }
         
         updateGridSize();
         Q_EMIT thumbnailSizeChanged(size);
-        
-        // Trigger preload at new size
-        m_preloadTimer->start();
     }
 }
 
+void ImageGridView::updateRequestDeferral()
+{
+    if (m_model) {
+        m_model->setThumbnailRequestsDeferred(m_fastScrolling || m_zoomSettleTimer->isActive());
+    }
+}
+
+void ImageGridView::onZoomSettled()
+{
+    updateRequestDeferral();
+    if (!m_model || m_fastScrolling) {
+        return;
+    }
+
+    // Exact-size thumbnails for what is on screen first, as one batch;
+    // the regular preload pass picks up the margin rows afterwards
+    int firstRow = 0;
+    int lastRow = -1;
+    if (visibleRowRange(firstRow, lastRow)) {
+        preloadThumbnails(firstRow, lastRow, LoadPriority::High);
+    }
+    m_preloadTimer->start();
+}
+
 int ImageGridView::thumbnailSize() const
 {
     return m_thumbnailSize;
@@ -180,7 +213,6 @@ void ImageGridView::setItemSpacing(int spacing)
 {
     m_spacing = spacing;
     m_delegate->setSpacing(spacing);
-    setSpacing(spacing);
     updateGridSize();
 }
 
@@ -201,10 +233,364 @@ bool ImageGridView::showFilenames() const
     return m_showFilenames;
 }
 
+void ImageGridView::setFrameStatsVisible(bool visible)
+{
+    if (visible == (m_frameStats != nullptr)) {
+        return;
+    }
+    if (visible) {
+        m_frameStats = new FrameStatsOverlay(viewport(), "grid");
+    } else {
+        delete m_frameStats;
+        m_frameStats = nullptr;
+        viewport()->update();
+    }
+}
+
 void ImageGridView::updateGridSize()
 {
-    QSize itemSize = m_delegate->sizeHint(QStyleOptionViewItem(), QModelIndex());
-    setGridSize(itemSize);
+    // Cell size is read from the delegate inside updateGeometries(), which
+    // also keeps the first visible item anchored across the change.
+    updateGeometries();
+    viewport()->update();
+}
+
+// ============== Arithmetic Layout ==============
+
+int ImageGridView::itemCount() const
+{
+    return model() ? model()->rowCount(rootIndex()) : 0;
+}
+
+QRect ImageGridView::cellRect(int row) const
+{
+    // Content coordinates (scroll offset not applied)
+    return QRect((row % m_columns) * m_cellSize.width(),
+                 (row / m_columns) * m_cellSize.height(),
+                 m_cellSize.width(), m_cellSize.height());
+}
+
+bool ImageGridView::visibleRowRange(int& firstRow, int& lastRow, int marginLines) const
+{
+    const int count = itemCount();
+    if (count == 0 || m_gridLines == 0) {
+        return false;
+    }
+
+    const int cellHeight = m_cellSize.height();
+    const int offset = verticalOffset();
+    const int firstLine = qMax(0, offset / cellHeight - marginLines);
+    const int lastLine = qMin(m_gridLines - 1,
+                              (offset + viewport()->height() - 1) / cellHeight + marginLines);
+
+    firstRow = firstLine * m_columns;
+    lastRow = qMin(count - 1, (lastLine + 1) * m_columns - 1);
+    return firstRow <= lastRow;
+}
+
+void ImageGridView::updateGeometries()
+{
+    QSize cell = m_delegate->sizeHint(QStyleOptionViewItem(), QModelIndex());
+    cell = cell.expandedTo(QSize(1, 1));
+
+    const int count = itemCount();
+    const int columns = qMax(1, viewport()->width() / cell.width());
+
+    // When the cell size or column count changes (zoom, resize) keep the item
+    // at the top of the viewport in place instead of the raw pixel offset.
+    int anchorRow = -1;
+    if (count == m_layoutCount && m_gridLines > 0 &&
+        (cell != m_cellSize || columns != m_columns)) {
+        anchorRow = (verticalOffset() / m_cellSize.height()) * m_columns;
+    }
+
+    m_cellSize = cell;
+    m_columns = columns;
+    m_gridLines = (count + columns - 1) / columns;
+    m_layoutCount = count;
+
+    QScrollBar* bar = verticalScrollBar();
+    const int viewportHeight = viewport()->height();
+    const qint64 contentHeight = qint64(m_gridLines) * cell.height();
+    bar->setPageStep(viewportHeight);
+    bar->setRange(0, int(qBound<qint64>(0, contentHeight - viewportHeight, INT_MAX)));
+    horizontalScrollBar()->setRange(0, 0);
+
+    if (anchorRow > 0) {
+        bar->setValue((anchorRow / columns) * cell.height());
+    }
+
+    QAbstractItemView::updateGeometries();
+}
+
+// ============== QAbstractItemView Interface ==============
+
+QRect ImageGridView::visualRect(const QModelIndex& index) const
+{
+    if (!index.isValid() || index.row() >= m_layoutCount) {
+        return QRect();
+    }
+    return cellRect(index.row()).translated(-horizontalOffset(), -verticalOffset());
+}
+
+QModelIndex ImageGridView::indexAt(const QPoint& point) const
+{
+    if (!model()) {
+        return QModelIndex();
+    }
+
+    const int x = point.x() + horizontalOffset();
+    const int y = point.y() + verticalOffset();
+    if (x < 0 || y < 0) {
+        return QModelIndex();
+    }
+
+    const int column = x / m_cellSize.width();
+    if (column >= m_columns) {
+        return QModelIndex();
+    }
+
+    const qint64 row = qint64(y / m_cellSize.height()) * m_columns + column;
+    if (row >= itemCount()) {
+        return QModelIndex();
+    }
+    return model()->index(int(row), 0, rootIndex());
+}
+
+void ImageGridView::scrollTo(const QModelIndex& index, ScrollHint hint)
+{
+    if (!index.isValid()) {
+        return;
+    }
+
+    // A model reset may still have its relayout queued — settle it first so
+    // the arithmetic below uses the current column count.
+    executeDelayedItemsLayout();
+
+    const QRect rect = cellRect(index.row());
+    const int offset = verticalOffset();
+    const int viewportHeight = viewport()->height();
+    int value = offset;
+
+    switch (hint) {
+    case PositionAtTop:
+        value = rect.top();
+        break;
+    case PositionAtBottom:
+        value = rect.bottom() + 1 - viewportHeight;
+        break;
+    case PositionAtCenter:
+        value = rect.center().y() - viewportHeight / 2;
+        break;
+    case EnsureVisible:
+    default:
+        if (rect.top() < offset) {
+            value = rect.top();
+        } else if (rect.bottom() + 1 > offset + viewportHeight) {
+            value = rect.bottom() + 1 - viewportHeight;
+        }
+        break;
+    }
+
+    verticalScrollBar()->setValue(value);
+}
+
+QModelIndex ImageGridView::moveCursor(CursorAction cursorAction, Qt::KeyboardModifiers modifiers)
+{
+    Q_UNUSED(modifiers)
+
+    const int count = itemCount();
+    if (count == 0) {
+        return QModelIndex();
+    }
+
+    const QModelIndex current = currentIndex();
+    if (!current.isValid()) {
+        return model()->index(0, 0, rootIndex());
+    }
+
+    int row = current.row();
+    const int pageItems = qMax(1, viewport()->height() / m_cellSize.height()) * m_columns;
+
+    switch (cursorAction) {
+    case MoveLeft:
+    case MovePrevious:
+        row -= 1;
+        break;
+    case MoveRight:
+    case MoveNext:
+        row += 1;
+        break;
+    case MoveUp:
+        if (row - m_columns >= 0) {
+            row -= m_columns;
+        }
+        break;
+    case MoveDown:
+        if (row + m_columns < count) {
+            row += m_columns;
+        } else if (row / m_columns < m_gridLines - 1) {
+            row = count - 1;  // Partial last line: land on the final item
+        }
+        break;
+    case MovePageUp:
+        row -= pageItems;
+        break;
+    case MovePageDown:
+        row += pageItems;
+        break;
+    case MoveHome:
+        row = 0;
+        break;
+    case MoveEnd:
+        row = count - 1;
+        break;
+    }
+
+    return model()->index(qBound(0, row, count - 1), 0, rootIndex());
+}
+
+int ImageGridView::horizontalOffset() const
+{
+    return horizontalScrollBar()->value();
+}
+
+int ImageGridView::verticalOffset() const
+{
+    return verticalScrollBar()->value();
+}
+
+bool ImageGridView::isIndexHidden(const QModelIndex& index) const
+{
+    Q_UNUSED(index)
+    return false;
+}
+
+void ImageGridView::selectRange(const QRect& contentRect, QItemSelection& selection) const
+{
+    const int count = itemCount();
+    if (count == 0) {
+        return;
+    }
+
+    const int cellWidth = m_cellSize.width();
+    const int cellHeight = m_cellSize.height();
+
+    const int firstColumn = qMax(0, contentRect.left() / cellWidth);
+    const int lastColumn = qMin(m_columns - 1, contentRect.right() / cellWidth);
+    const int firstLine = qMax(0, contentRect.top() / cellHeight);
+    const int lastLine = qMin(m_gridLines - 1, contentRect.bottom() / cellHeight);
+    if (contentRect.right() < 0 || contentRect.bottom() < 0 ||
+        firstColumn > lastColumn || firstLine > lastLine) {
+        return;
+    }
+
+    QAbstractItemModel* itemModel = model();
+    const QModelIndex root = rootIndex();
+
+    // Full-width bands are one contiguous row range — a single selection
+    // range no matter how many lines the rubber band covers.
+    if (firstColumn == 0 && lastColumn == m_columns - 1) {
+        const int first = firstLine * m_columns;
+        const int last = qMin(count - 1, (lastLine + 1) * m_columns - 1);
+        selection.select(itemModel->index(first, 0, root), itemModel->index(last, 0, root));
+        return;
+    }
+
+    for (int line = firstLine; line <= lastLine; ++line) {
+        const int first = line * m_columns + firstColumn;
+        const int last = qMin(count - 1, line * m_columns + lastColumn);
+        if (first > last) {
+            break;
+        }
+        selection.select(itemModel->index(first, 0, root), itemModel->index(last, 0, root));
+    }
+}
+
+void ImageGridView::setSelection(const QRect& rect, QItemSelectionModel::SelectionFlags command)
+{
+    if (!selectionModel()) {
+        return;
+    }
+
+    QItemSelection selection;
+    selectRange(rect.normalized().translated(horizontalOffset(), verticalOffset()), selection);
+    selectionModel()->select(selection, command);
+}
+
+QRegion ImageGridView::visualRegionForSelection(const QItemSelection& selection) const
+{
+    QRegion region;
+    int firstVisible = 0;
+    int lastVisible = -1;
+    if (!visibleRowRange(firstVisible, lastVisible)) {
+        return region;
+    }
+
+    const int viewportWidth = m_columns * m_cellSize.width();
+    for (const QItemSelectionRange& range : selection) {
+        const int top = qMax(range.top(), firstVisible);
+        const int bottom = qMin(range.bottom(), lastVisible);
+        if (top > bottom) {
+            continue;  // Entirely off-screen
+        }
+
+        const QRect first = visualRect(model()->index(top, 0, rootIndex()));
+        const QRect last = visualRect(model()->index(bottom, 0, rootIndex()));
+        if (first.top() == last.top()) {
+            region += first.united(last);
+        } else {
+            region += QRect(0, first.top(), viewportWidth, last.bottom() - first.top() + 1);
+        }
+    }
+    return region;
+}
+
+void ImageGridView::dataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
+                                const QList<int>& roles)
+{
+    Q_UNUSED(roles)
+
+    // Only repaint the part of the range that is actually on screen;
+    // off-screen changes (e.g. a thumbnail batch for rows scrolled past)
+    // cost nothing.
+    if (!topLeft.isValid() || !bottomRight.isValid()) {
+        viewport()->update();
+        return;
+    }
+
+    int firstVisible = 0;
+    int lastVisible = -1;
+    if (!visibleRowRange(firstVisible, lastVisible)) {
+        return;
+    }
+
+    const int top = qMax(topLeft.row(), firstVisible);
+    const int bottom = qMin(bottomRight.row(), lastVisible);
+    if (top > bottom) {
+        return;
+    }
+
+    if (top == bottom) {
+        viewport()->update(visualRect(model()->index(top, 0, rootIndex())));
+        return;
+    }
+
+    const QRect first = visualRect(model()->index(top, 0, rootIndex()));
+    const QRect last = visualRect(model()->index(bottom, 0, rootIndex()));
+    viewport()->update(QRect(0, first.top(), viewport()->width(), last.bottom() - first.top() + 1));
+}
+
+void ImageGridView::rowsInserted(const QModelIndex& parent, int start, int end)
+{
+    QAbstractItemView::rowsInserted(parent, start, end);
+    scheduleDelayedItemsLayout();
+}
+
+void ImageGridView::rowsAboutToBeRemoved(const QModelIndex& parent, int start, int end)
+{
+    QAbstractItemView::rowsAboutToBeRemoved(parent, start, end);
+    scheduleDelayedItemsLayout();
 }
 
 // ============== Selection ==============
@@ -234,12 +620,12 @@ void ImageGridView::scrollToImage(const QString& filePath)
 
 void ImageGridView::selectAll()
 {
-    QListView::selectAll();
+    QAbstractItemView::selectAll();
 }
 
 void ImageGridView::clearSelection()
 {
-    QListView::clearSelection();
+    QAbstractItemView::clearSelection();
 }
 
 // ============== Zoom ==============
@@ -258,39 +644,177 @@ void ImageGridView::zoomOut()
 
 void ImageGridView::paintEvent(QPaintEvent* event)
 {
+    EventTrace::Span span("gridPaint", "paint");
     // WA_OpaquePaintEvent is set for scroll performance (skips the system
-    // background erase, avoiding a redundant fill + the flicker it can cause
-    // on some compositors).  The trade-off is that areas not covered by any
-    // item — e.g. the region below the last row after filtering reduces the
-    // item count — retain stale pixel data from the previous paint.
-    //
-    // Fix: fill the dirty region ourselves with the correct background color
-    // before letting QListView paint the items on top.  This is cheaper than
-    // removing WA_OpaquePaintEvent (which would use the wrong palette color
-    // and potentially flicker).
-    QPainter bgPainter(viewport());
-    bgPainter.fillRect(event->rect(), QColor(30, 30, 30));
-    bgPainter.end();
-
-    QListView::paintEvent(event);
-    // Don't trigger preload on paint - only on scroll/resize
-    // This prevents constant re-requests that cause flickering
+    // background erase), so fill the dirty region ourselves — this also
+    // clears the area below the last row after filtering shrinks the model.
+    const QRect dirty = event->rect();
+    if (m_frameStats) {
+        m_frameStats->beginFrame(dirty);
+    }
+
+    QPainter painter(viewport());
+    painter.fillRect(dirty, QColor(30, 30, 30));
+
+    const int count = itemCount();
+    if (count > 0 && m_gridLines > 0) {
+        // Visible cells are derived from the dirty rect alone — O(visible)
+        const int cellWidth = m_cellSize.width();
+        const int cellHeight = m_cellSize.height();
+        const int offset = verticalOffset();
+        const int firstLine = qMax(0, (dirty.top() + offset) / cellHeight);
+        const int lastLine = qMin(m_gridLines - 1, (dirty.bottom() + offset) / cellHeight);
+        const int firstColumn = qMax(0, dirty.left() / cellWidth);
+        const int lastColumn = qMin(m_columns - 1, dirty.right() / cellWidth);
+
+        QStyleOptionViewItem option;
+        initViewItemOption(&option);
+        const QStyle::State baseState = option.state & ~(QStyle::State_Selected | QStyle::State_HasFocus);
+
+        QAbstractItemModel* itemModel = model();
+        const QModelIndex root = rootIndex();
+        const QItemSelectionModel* selection = selectionModel();
+        const QModelIndex current = currentIndex();
+        const bool focused = hasFocus();
+
+        for (int line = firstLine; line <= lastLine; ++line) {
+            for (int column = firstColumn; column <= lastColumn; ++column) {
+                const int row = line * m_columns + column;
+                if (row >= count) {
+                    break;
+                }
+
+                const QModelIndex index = itemModel->index(row, 0, root);
+                option.rect = QRect(column * cellWidth, line * cellHeight - offset,
+                                    cellWidth, cellHeight);
+                option.state = baseState;
+                if (selection && selection->isSelected(index)) {
+                    option.state |= QStyle::State_Selected;
+                }
+                if (focused && index == current) {
+                    option.state |= QStyle::State_HasFocus;
+                }
+                m_delegate->paint(&painter, option, index);
+            }
+        }
+    }
+
+    if (m_rubberBand.isValid()) {
+        QStyleOptionRubberBand band;
+        band.initFrom(this);
+        band.shape = QRubberBand::Rectangle;
+        band.opaque = false;
+        band.rect = m_rubberBand.translated(-horizontalOffset(), -verticalOffset())
+                        .intersected(viewport()->rect().adjusted(-16, -16, 16, 16));
+        painter.save();
+        style()->drawControl(QStyle::CE_RubberBand, &band, &painter);
+        painter.restore();
+    }
+
+    if (m_fastScrolling) {
+        paintPositionIndicator(&painter);
+        m_indicatorRect = positionIndicatorRect();
+    }
+
+    if (m_frameStats) {
+        m_frameStats->endFrame();
+        m_frameStats->paint(&painter);
+    }
 }
 
 void ImageGridView::resizeEvent(QResizeEvent* event)
 {
-    QListView::resizeEvent(event);
+    QAbstractItemView::resizeEvent(event);
     m_preloadTimer->start();
 }
 
 void ImageGridView::scrollContentsBy(int dx, int dy)
 {
-    QListView::scrollContentsBy(dx, dy);
+    QAbstractItemView::scrollContentsBy(dx, dy);
     
+    // The scroll blit moved the HUD along with the content
+    if (m_frameStats) {
+        m_frameStats->invalidate();
+    }
+
+    // Dragging the thumb, or a step of more than half a screen (fling,
+    // page jumps), passes over rows nobody will look at: stop queueing
+    // loads for them until the view comes to rest
+    const bool dragging = verticalScrollBar()->isSliderDown();
+    const bool flinging = qAbs(dy) >= viewport()->height() / 2;
+    if (dragging || flinging) {
+        if (!m_fastScrolling) {
+            m_fastScrolling = true;
+            updateRequestDeferral();
+        }
+        m_scrollSettleTimer->start();
+    }
+
+    if (m_fastScrolling) {
+        // The blit carried the old indicator along; repaint both spots
+        viewport()->update(m_indicatorRect.translated(dx, dy));
+        viewport()->update(positionIndicatorRect());
+        return;
+    }
+
     // Restart preload timer on scroll
     m_preloadTimer->start();
 }
 
+void ImageGridView::onScrollSettled()
+{
+    m_fastScrolling = false;
+    updateRequestDeferral();
+
+    viewport()->update(m_indicatorRect);
+    m_indicatorRect = QRect();
+
+    // Tiles we flew past still show placeholders; the preload pass queues
+    // loads for the rows we landed on and their completions repaint them
+    if (!m_zoomSettleTimer->isActive()) {
+        m_preloadTimer->start();
+    }
+}
+
+QRect ImageGridView::positionIndicatorRect() const
+{
+    const QSize size(140, 28);
+    const QScrollBar* bar = verticalScrollBar();
+    const int travel = qMax(0, viewport()->height() - size.height() - 16);
+    const double fraction = bar->maximum() > 0 ? double(bar->value()) / bar->maximum() : 0.0;
+    return QRect(QPoint(viewport()->width() - size.width() - 12, 8 + int(fraction * travel)), size);
+}
+
+void ImageGridView::paintPositionIndicator(QPainter* painter) const
+{
+    int firstRow = 0;
+    int lastRow = -1;
+    if (!m_model || !visibleRowRange(firstRow, lastRow)) {
+        return;
+    }
+
+    // Filename initial and month of the first visible item
+    const QModelIndex index = m_model->index(firstRow);
+    const QString name = index.data(FileNameRole).toString();
+    const QDateTime modified = index.data(ModifiedDateRole).toDateTime();
+    const QString label = QString("%1   %2")
+        .arg(name.isEmpty() ? QString() : name.left(1).toUpper(),
+             modified.isValid() ? QLocale().toString(modified.date(), "MMM yyyy") : QString());
+
+    const QRect rect = positionIndicatorRect();
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, true);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(QColor(0, 0, 0, 200));
+    painter->drawRoundedRect(rect, rect.height() / 2.0, rect.height() / 2.0);
+    QFont font = painter->font();
+    font.setBold(true);
+    painter->setFont(font);
+    painter->setPen(QColor(230, 230, 230));
+    painter->drawText(rect, Qt::AlignCenter, label);
+    painter->restore();
+}
+
 void ImageGridView::wheelEvent(QWheelEvent* event)
 {
     // Bypass Qt's QAbstractSlider wheel handling (which has its own step
@@ -324,7 +848,8 @@ void ImageGridView::wheelEvent(QWheelEvent* event)
 
 void ImageGridView::mousePressEvent(QMouseEvent* event)
 {
-    QListView::mousePressEvent(event);
+    m_pressedContentPos = event->pos() + QPoint(horizontalOffset(), verticalOffset());
+    QAbstractItemView::mousePressEvent(event);
 
     QModelIndex index = indexAt(event->pos());
     if (index.isValid()) {
@@ -333,6 +858,30 @@ void ImageGridView::mousePressEvent(QMouseEvent* event)
     }
 }
 
+void ImageGridView::mouseMoveEvent(QMouseEvent* event)
+{
+    QAbstractItemView::mouseMoveEvent(event);
+
+    if (state() == DragSelectingState &&
+        selectionMode() != SingleSelection && selectionMode() != NoSelection) {
+        const QPoint offset(horizontalOffset(), verticalOffset());
+        const QRect previous = m_rubberBand;
+        m_rubberBand = QRect(m_pressedContentPos, event->pos() + offset).normalized();
+        viewport()->update(previous.united(m_rubberBand).translated(-offset).adjusted(-2, -2, 2, 2));
+    }
+}
+
+void ImageGridView::mouseReleaseEvent(QMouseEvent* event)
+{
+    QAbstractItemView::mouseReleaseEvent(event);
+
+    if (m_rubberBand.isValid()) {
+        const QPoint offset(horizontalOffset(), verticalOffset());
+        viewport()->update(m_rubberBand.translated(-offset).adjusted(-2, -2, 2, 2));
+        m_rubberBand = QRect();
+    }
+}
+
 void ImageGridView::mouseDoubleClickEvent(QMouseEvent* event)
 {
     QModelIndex index = indexAt(event->pos());
@@ -341,7 +890,7 @@ void ImageGridView::mouseDoubleClickEvent(QMouseEvent* event)
         Q_EMIT imageActivated(path);
     }
     
-    QListView::mouseDoubleClickEvent(event);
+    QAbstractItemView::mouseDoubleClickEvent(event);
 }
 
 void ImageGridView::contextMenuEvent(QContextMenuEvent* event)
@@ -407,7 +956,7 @@ void ImageGridView::keyPressEvent(QKeyEvent* event)
         return;
     }
 
-    QListView::keyPressEvent(event);
+    QAbstractItemView::keyPressEvent(event);
 }
 
 // ============== Selection Handling ==============
@@ -423,40 +972,23 @@ void ImageGridView::onSelectionChanged(const QItemSelection& selected, const QIt
 
 void ImageGridView::preloadVisibleThumbnails()
 {
-    if (!m_model || m_model->rowCount() == 0) {
+    if (!m_model || m_model->rowCount() == 0 || m_zoomSettleTimer->isActive() || m_fastScrolling) {
         return;
     }
 
-    // Get visible rect
-    QRect visibleRect = viewport()->rect();
-    
-    // Find first and last visible indexes
-    QModelIndex firstVisible = indexAt(visibleRect.topLeft());
-    QModelIndex lastVisible = indexAt(visibleRect.bottomRight());
-
-    if (!firstVisible.isValid()) {
-        firstVisible = m_model->index(0);
-    }
-    if (!lastVisible.isValid()) {
-        lastVisible = m_model->index(m_model->rowCount() - 1);
+    // Visible range plus m_preloadMargin grid lines above and below —
+    // pure arithmetic on the scroll offset, no hit testing
+    int preloadStart = 0;
+    int preloadEnd = -1;
+    if (!visibleRowRange(preloadStart, preloadEnd, m_preloadMargin)) {
+        return;
     }
 
-    int firstRow = firstVisible.row();
-    int lastRow = lastVisible.row();
-
-    // Calculate columns for preload margin
-    int columns = calculateColumnsForWidth(viewport()->width());
-    int preloadItems = columns * m_preloadMargin;
-
-    // Expand range for preloading
-    int preloadStart = qMax(0, firstRow - preloadItems);
-    int preloadEnd = qMin(m_model->rowCount() - 1, lastRow + preloadItems);
-
     // Request thumbnails for visible + margin items
     preloadThumbnails(preloadStart, preloadEnd);
 }
 
-void ImageGridView::preloadThumbnails(int startRow, int endRow)
+void ImageGridView::preloadThumbnails(int startRow, int endRow, LoadPriority priority)
 {
     if (!m_model) return;
 
@@ -477,72 +1009,8 @@ void ImageGridView::preloadThumbnails(int startRow, int endRow)
     }
 
     if (!pathsToLoad.isEmpty()) {
-        // Load in batches with normal priority
-        ThumbnailLoadThread::instance()->loadBatch(pathsToLoad, m_thumbnailSize);
-    }
-}
-
-QModelIndexList ImageGridView::visibleIndexes() const
-{
-    QModelIndexList indexes;
-    if (!model() || model()->rowCount() == 0) {
-        return indexes;
-    }
-    
-    QRect visibleRect = viewport()->rect();
-    
-    // Use binary search to find first visible item for O(log n) instead of O(n)
-    int totalRows = model()->rowCount();
-    int low = 0, high = totalRows - 1;
-    int firstVisible = 0;
-    
-    // Binary search for first visible row
-    while (low <= high) {
-        int mid = (low + high) / 2;
-        QModelIndex midIndex = model()->index(mid, 0);
-        QRect midRect = visualRect(midIndex);
-        
-        if (midRect.bottom() < visibleRect.top()) {
-            low = mid + 1;
-        } else if (midRect.top() > visibleRect.bottom()) {
-            high = mid - 1;
-        } else {
-            // midRect intersects visibleRect, search for first
-            firstVisible = mid;
-            high = mid - 1;
-        }
-    }
-    
-    // If binary search didn't find intersection, use low as starting point
-    if (firstVisible == 0 && low > 0) {
-        firstVisible = qMin(low, totalRows - 1);
-    }
-    
-    // Collect all visible items from firstVisible onwards
-    for (int row = firstVisible; row < totalRows; ++row) {
-        QModelIndex index = model()->index(row, 0);
-        QRect itemRect = visualRect(index);
-        
-        // Stop when we're past the visible area
-        if (itemRect.top() > visibleRect.bottom()) {
-            break;
-        }
-        
-        if (visibleRect.intersects(itemRect)) {
-            indexes.append(index);
-        }
-    }
-
-    return indexes;
-}
-
-int ImageGridView::calculateColumnsForWidth(int width) const
-{
-    QSize itemSize = gridSize();
-    if (itemSize.width() <= 0) {
-        return 1;
+        ThumbnailLoadThread::instance()->loadBatch(pathsToLoad, m_thumbnailSize, priority);
     }
-    return qMax(1, width / itemSize.width());
 }
 
 } // namespace FullFrame
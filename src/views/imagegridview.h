@@ -1,27 +1,34 @@
 /**
  * ImageGridView - High-performance grid view for images
- * 
- * Based on DigiKam's DCategorizedView/ItemViewCategorized:
- * - QListView with IconMode for grid layout
- * - Lazy loading of thumbnails (only visible items)
- * - Preloading of nearby items for smooth scrolling
- * - Efficient scrolling with thousands of items
+ *
+ * Virtualized grid built directly on QAbstractItemView:
+ * - Every cell has the same size, so row/column/visible ranges are pure
+ *   arithmetic on the scroll offset — no per-item layout pass at all
+ * - Reset, resize and scroll cost O(visible cells), independent of item count
+ * - Only visible cells are painted (through ThumbnailDelegate)
+ * - Lazy loading of thumbnails (only visible items) plus preloading of
+ *   nearby rows for smooth scrolling
  */
 
 #pragma once
 
-#include <QListView>
+#include <QAbstractItemView>
 #include <QTimer>
 
+class QPainter;
+
+#include "thumbnailloadthread.h"
+
 namespace FullFrame {
 
 class ImageThumbnailModel;
 class ThumbnailDelegate;
+class FrameStatsOverlay;
 
 /**
  * Optimized grid view for displaying image thumbnails
  */
-class ImageGridView : public QListView
+class ImageGridView : public QAbstractItemView
 {
     Q_OBJECT
 
@@ -45,12 +52,25 @@ public:
     void setShowFilenames(bool show);
     bool showFilenames() const;
 
+    // Frame-time HUD (null while hidden)
+    void setFrameStatsVisible(bool visible);
+    FrameStatsOverlay* frameStats() const { return m_frameStats; }
+
     // Get selected paths
     QStringList selectedImagePaths() const;
 
     // Scroll to specific image
     void scrollToImage(const QString& filePath);
 
+    // Grid geometry (all O(1))
+    int columnCount() const { return m_columns; }
+    QSize cellSize() const { return m_cellSize; }
+
+    // QAbstractItemView interface
+    QRect visualRect(const QModelIndex& index) const override;
+    void scrollTo(const QModelIndex& index, ScrollHint hint = EnsureVisible) override;
+    QModelIndex indexAt(const QPoint& point) const override;
+
 Q_SIGNALS:
     void imageActivated(const QString& filePath);
     void imageSelected(const QString& filePath);
@@ -63,16 +83,31 @@ Q_SIGNALS:
 public Q_SLOTS:
     void zoomIn();
     void zoomOut();
-    void selectAll();
+    void selectAll() override;
     void clearSelection();
 
 protected:
+    // QAbstractItemView interface
+    QModelIndex moveCursor(CursorAction cursorAction, Qt::KeyboardModifiers modifiers) override;
+    int horizontalOffset() const override;
+    int verticalOffset() const override;
+    bool isIndexHidden(const QModelIndex& index) const override;
+    void setSelection(const QRect& rect, QItemSelectionModel::SelectionFlags command) override;
+    QRegion visualRegionForSelection(const QItemSelection& selection) const override;
+    void updateGeometries() override;
+    void dataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
+                     const QList<int>& roles = QList<int>()) override;
+    void rowsInserted(const QModelIndex& parent, int start, int end) override;
+    void rowsAboutToBeRemoved(const QModelIndex& parent, int start, int end) override;
+
     // Override for lazy loading optimization
     void paintEvent(QPaintEvent* event) override;
     void resizeEvent(QResizeEvent* event) override;
     void scrollContentsBy(int dx, int dy) override;
     void wheelEvent(QWheelEvent* event) override;
     void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
     void mouseDoubleClickEvent(QMouseEvent* event) override;
     void contextMenuEvent(QContextMenuEvent* event) override;
     void keyPressEvent(QKeyEvent* event) override;
@@ -81,12 +116,19 @@ private Q_SLOTS:
     void onSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected);
     void preloadVisibleThumbnails();
     void updateGridSize();
+    void onZoomSettled();
+    void onScrollSettled();
 
 private:
     void setupView();
-    void preloadThumbnails(int startRow, int endRow);
-    QModelIndexList visibleIndexes() const;
-    int calculateColumnsForWidth(int width) const;
+    void preloadThumbnails(int startRow, int endRow, LoadPriority priority = LoadPriority::Normal);
+    int itemCount() const;
+    QRect cellRect(int row) const;
+    bool visibleRowRange(int& firstRow, int& lastRow, int marginLines = 0) const;
+    void selectRange(const QRect& contentRect, QItemSelection& selection) const;
+    void updateRequestDeferral();
+    QRect positionIndicatorRect() const;
+    void paintPositionIndicator(QPainter* painter) const;
 
 private:
     ImageThumbnailModel* m_model = nullptr;
@@ -96,10 +138,32 @@ private:
     int m_spacing = 8;
     bool m_showFilenames = true;
 
+    // Arithmetic layout — recomputed in updateGeometries(), never per item
+    QSize m_cellSize = QSize(1, 1);
+    int m_columns = 1;
+    int m_gridLines = 0;
+    int m_layoutCount = 0;
+
+    // Rubber band selection (content coordinates of the press point)
+    QPoint m_pressedContentPos;
+    QRect m_rubberBand;
+
+    // Diagnostics
+    FrameStatsOverlay* m_frameStats = nullptr;
+
     // Preloading
     QTimer* m_preloadTimer;
     int m_preloadMargin = 3;  // Increased rows to preload above/below for smoother scrolling
 
+    // Zoom gesture: thumbnail requests wait until the size stops changing
+    QTimer* m_zoomSettleTimer;
+
+    // Scrollbar drag / fling: only in-memory thumbnails are shown and no
+    // loads are queued until the view has been still for a moment
+    QTimer* m_scrollSettleTimer;
+    bool m_fastScrolling = false;
+    QRect m_indicatorRect;   // Last painted position indicator (viewport coordinates)
+
     // Zoom limits
     static constexpr int MinThumbnailSize = 64;
     static constexpr int MaxThumbnailSize = 512;
@@ -7,6 +7,14 @@
 #include "tagmanager.h"
 #include "thumbnailcache.h"
 #include "thumbnailcreator.h"
+#include "perfcounters.h"
+#include "framestatsoverlay.h"
+#include "previewloader.h"
+#include "animationloader.h"
+#include "videoplayerpool.h"
+#include "tiledimageview.h"
+#include "memoryreport.h"
+#include "tagchipflowwidget.h"
 
 #include <QPainter>
 #include <QPainterPath>
@@ -16,7 +24,7 @@
 #include <QShowEvent>
 #include <QContextMenuEvent>
 #include <QMouseEvent>
-#include <QImageReader>
+#include <QPaintEvent>
 #include <QDesktopServices>
 #include <QUrl>
 #include <QTimer>
@@ -24,9 +32,7 @@
 #include <QDateTime>
 #include <QFileInfo>
 #include <QGridLayout>
-#include <QGraphicsDropShadowEffect>
 #include <QApplication>
-#include <QEventLoop>
 
 namespace FullFrame {
 
@@ -59,9 +65,15 @@ HorizontalThumbnailDelegate::HorizontalThumbnailDelegate(QObject* parent)
 void HorizontalThumbnailDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
                                          const QModelIndex& index) const
 {
+    PerfCounters::add(PerfCounters::TilesPainted);
+
+    const auto* model = qobject_cast<const ImageThumbnailModel*>(index.model());
+    if (!model) {
+        return;
+    }
+    const ThumbnailPaintRecord record = model->paintRecord(index.row(), StripThumbnailSize);
+
     painter->save();
-    painter->setRenderHint(QPainter::Antialiasing, true);
-    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
 
     QRect itemRect = option.rect;
     
@@ -70,28 +82,29 @@ void HorizontalThumbnailDelegate::paint(QPainter* painter, const QStyleOptionVie
     QColor bgColor = selected ? QColor(0, 120, 215, 80) : QColor(30, 30, 30);
     painter->fillRect(itemRect, bgColor);
 
-    // Get thumbnail
-    QVariant thumbVar = index.data(Qt::DecorationRole);
-    if (thumbVar.canConvert<QPixmap>()) {
-        QPixmap pixmap = thumbVar.value<QPixmap>();
-        if (!pixmap.isNull()) {
-            int margin = 4;
-            int availableHeight = itemRect.height() - margin * 2;
-            QSize scaledSize = pixmap.size().scaled(pixmap.width(), availableHeight, Qt::KeepAspectRatio);
-            
-            int x = itemRect.x() + (itemRect.width() - scaledSize.width()) / 2;
-            int y = itemRect.y() + margin;
-            
-            QRect targetRect(x, y, scaledSize.width(), scaledSize.height());
-            
-            QPainterPath path;
-            path.addRoundedRect(targetRect, 4, 4);
-            painter->setClipPath(path);
-            painter->drawPixmap(targetRect, pixmap);
-            painter->setClipping(false);
+    // Thumbnail. Strip-size pixmaps fit the cell as they are and are blitted
+    // 1:1; only a stand-in from another size class is scaled (fast filter)
+    if (record.pixmap && !record.pixmap->isNull() && !record.has(ThumbnailPaintRecord::Placeholder)) {
+        const QPixmap& pixmap = *record.pixmap;
+        const QRect area = itemRect.adjusted(ThumbnailMargin, ThumbnailMargin,
+                                             -ThumbnailMargin, -ThumbnailMargin);
+        QSize targetSize = pixmap.size();
+        if (targetSize.width() > area.width() || targetSize.height() > area.height()) {
+            targetSize.scale(area.size(), Qt::KeepAspectRatio);
+        }
+
+        const int x = area.x() + (area.width() - targetSize.width()) / 2;
+        const int y = area.y() + (area.height() - targetSize.height()) / 2;
+        if (targetSize == pixmap.size()) {
+            painter->drawPixmap(x, y, pixmap);
+        } else {
+            painter->drawPixmap(QRect(QPoint(x, y), targetSize), pixmap);
         }
     }
 
+    // Vector overlays below are antialiased; the thumbnail blit above is not
+    painter->setRenderHint(QPainter::Antialiasing, true);
+
     // Selection border
     if (selected) {
         painter->setPen(QPen(QColor(0, 120, 215), 3));
@@ -100,8 +113,8 @@ void HorizontalThumbnailDelegate::paint(QPainter* painter, const QStyleOptionVie
     }
 
     // Rating / favorite indicators (top-right of the thumbnail area)
-    bool isFavorited = index.data(IsFavoritedRole).toBool();
-    int ratingValue = index.data(RatingRole).toInt();
+    bool isFavorited = record.has(ThumbnailPaintRecord::Favorited);
+    int ratingValue = record.rating;
 
     // Draw rating dots first (rightmost)
     if (ratingValue > 0) {
@@ -172,9 +185,9 @@ void HorizontalThumbnailDelegate::paint(QPainter* painter, const QStyleOptionVie
     }
 
     // Sequence badge (bottom-left)
-    int seqCount = index.data(SequenceCountRole).toInt();
+    int seqCount = record.sequenceCount;
     if (seqCount > 1) {
-        bool expanded = index.data(IsSequenceExpandedRole).toBool();
+        bool expanded = record.has(ThumbnailPaintRecord::SequenceExpanded);
         QRect badge = sequenceBadgeRect(itemRect);
 
         painter->setPen(Qt::NoPen);
@@ -246,6 +259,50 @@ QSize HorizontalThumbnailDelegate::sizeHint(const QStyleOptionViewItem& option,
     return QSize(m_thumbnailHeight * 4 / 3, m_thumbnailHeight);
 }
 
+// ============== ThumbnailStripView ==============
+
+ThumbnailStripView::ThumbnailStripView(QWidget* parent)
+    : QListView(parent)
+{
+}
+
+void ThumbnailStripView::setFrameStatsVisible(bool visible)
+{
+    if (visible == (m_frameStats != nullptr)) {
+        return;
+    }
+    if (visible) {
+        m_frameStats = new FrameStatsOverlay(viewport(), "strip");
+    } else {
+        delete m_frameStats;
+        m_frameStats = nullptr;
+        viewport()->update();
+    }
+}
+
+void ThumbnailStripView::paintEvent(QPaintEvent* event)
+{
+    if (!m_frameStats) {
+        QListView::paintEvent(event);
+        return;
+    }
+
+    m_frameStats->beginFrame(event->rect());
+    QListView::paintEvent(event);
+    m_frameStats->endFrame();
+
+    QPainter painter(viewport());
+    m_frameStats->paint(&painter);
+}
+
+void ThumbnailStripView::scrollContentsBy(int dx, int dy)
+{
+    QListView::scrollContentsBy(dx, dy);
+    if (m_frameStats) {
+        m_frameStats->invalidate();
+    }
+}
+
 // ============== MediaPreviewWidget ==============
 
 MediaPreviewWidget::MediaPreviewWidget(QWidget* parent)
@@ -273,6 +330,12 @@ MediaPreviewWidget::MediaPreviewWidget(QWidget* parent)
     m_imageLabel->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     imageLayout->addWidget(m_imageLabel);
     
+    // Still images go to the zoomable tiled view; the label keeps GIFs and
+    // error text
+    m_tiledView = new TiledImageView(m_imageWidget);
+    m_tiledView->hide();
+    imageLayout->addWidget(m_tiledView);
+    
     m_stackedWidget->addWidget(m_imageWidget);
     
 #ifdef HAVE_QT_MULTIMEDIA
@@ -327,12 +390,11 @@ MediaPreviewWidget::MediaPreviewWidget(QWidget* parent)
     m_stackedWidget->addWidget(m_audioPlaceholder);
     
 #ifdef HAVE_QT_MULTIMEDIA
-    // Media player setup
-    m_mediaPlayer = new QMediaPlayer(this);
+    // Media player setup - players come from a pool so neighbouring clips
+    // can be opened ahead of time; m_mediaPlayer is the active one
     m_audioOutput = new QAudioOutput(this);
-    m_mediaPlayer->setAudioOutput(m_audioOutput);
-    m_mediaPlayer->setVideoOutput(m_videoWidget);
     m_audioOutput->setVolume(0.7f);
+    m_playerPool = new VideoPlayerPool(m_videoWidget, m_audioOutput, this);
     
     // Controls widget
     m_controlsWidget = new QWidget(this);
@@ -388,10 +450,25 @@ MediaPreviewWidget::MediaPreviewWidget(QWidget* parent)
     
     mainLayout->addWidget(m_controlsWidget);
     
-    connect(m_mediaPlayer, &QMediaPlayer::positionChanged, this, &MediaPreviewWidget::onPositionChanged);
-    connect(m_mediaPlayer, &QMediaPlayer::durationChanged, this, &MediaPreviewWidget::onDurationChanged);
-    connect(m_mediaPlayer, &QMediaPlayer::mediaStatusChanged, this, &MediaPreviewWidget::onMediaStatusChanged);
 #endif
+    
+    connect(PreviewLoader::instance(), &PreviewLoader::previewReady,
+            this, &MediaPreviewWidget::onPreviewReady);
+    connect(PreviewLoader::instance(), &PreviewLoader::previewFailed,
+            this, &MediaPreviewWidget::onPreviewFailed);
+    
+    m_animationPlayer = new AnimationPlayer(this);
+    connect(m_animationPlayer, &AnimationPlayer::frameChanged, this, &MediaPreviewWidget::onAnimationFrame);
+    connect(m_animationPlayer, &AnimationPlayer::failed, this, &MediaPreviewWidget::onAnimationFailed);
+    
+    m_animationResizeTimer = new QTimer(this);
+    m_animationResizeTimer->setSingleShot(true);
+    m_animationResizeTimer->setInterval(150);
+    connect(m_animationResizeTimer, &QTimer::timeout, this, [this]() {
+        if (m_isAnimation && m_mediaType == 1) {
+            startAnimation();
+        }
+    });
 }
 
 MediaPreviewWidget::~MediaPreviewWidget()
@@ -399,8 +476,19 @@ MediaPreviewWidget::~MediaPreviewWidget()
     stopPlayback();
 }
 
-void MediaPreviewWidget::setMedia(const QString& filePath)
+void MediaPreviewWidget::setMedia(const QString& filePath, const QStringList& prefetchPaths)
 {
+    // Neighbouring stills go to PreviewLoader, clips to the player pool
+    m_prefetchPaths.clear();
+    QStringList prefetchClips;
+    for (const QString& path : prefetchPaths) {
+        if (ThumbnailCreator::getMediaType(path) == MediaType::Video) {
+            prefetchClips.append(path);
+        } else {
+            m_prefetchPaths.append(path);
+        }
+    }
+    
     if (m_currentPath == filePath) {
         return;
     }
@@ -408,8 +496,8 @@ void MediaPreviewWidget::setMedia(const QString& filePath)
     stopPlayback();
     
     m_currentPath = filePath;
-    m_originalImage = QImage();
-    m_scaledPixmap = QPixmap();
+    m_requestedSize = QSize();
+    m_tiledView->clear();
     
     if (filePath.isEmpty()) {
 #ifdef HAVE_QT_MULTIMEDIA
@@ -460,10 +548,22 @@ void MediaPreviewWidget::setMedia(const QString& filePath)
             break;
     }
     
+#ifdef HAVE_QT_MULTIMEDIA
+    m_playerPool->warm(prefetchClips);
+#endif
+    
     Q_EMIT mediaLoaded(filePath, m_mediaType);
     update();
 }
 
+void MediaPreviewWidget::reportMemory(MemoryReport& report) const
+{
+    m_tiledView->reportMemory(report);
+    // Animated images show their current frame through the label; the
+    // decoded frames themselves belong to AnimationLoader
+    report.add("Preview animation frame", report.pixmapBytes(m_imageLabel->pixmap()));
+}
+
 void MediaPreviewWidget::clear()
 {
     setMedia(QString());
@@ -471,71 +571,121 @@ void MediaPreviewWidget::clear()
 
 void MediaPreviewWidget::stopPlayback()
 {
-    // Stop GIF animation
-    if (m_gifMovie) {
-        m_gifMovie->stop();
-        delete m_gifMovie;
-        m_gifMovie = nullptr;
-    }
+    // Stop animated image playback
+    m_animationPlayer->stop();
+    m_animationResizeTimer->stop();
+    m_isAnimation = false;
     
 #ifdef HAVE_QT_MULTIMEDIA
-    if (m_mediaPlayer->playbackState() != QMediaPlayer::StoppedState) {
-        m_mediaPlayer->stop();
-    }
+    // Parks the clip on its first frame, so coming back to it is instant
+    m_playerPool->deactivate();
+    bindPlayer(nullptr);
     m_playPauseButton->setText("▶");
 #endif
 }
 
 void MediaPreviewWidget::loadImage()
 {
-    // Stop any existing GIF animation
-    if (m_gifMovie) {
-        m_gifMovie->stop();
-        delete m_gifMovie;
-        m_gifMovie = nullptr;
+    // GIF/WebP/APNG - decoded and played by AnimationLoader off the GUI
+    // thread; auto-play and loop by default
+    if (AnimationLoader::isAnimationFile(m_currentPath)) {
+        m_isAnimation = true;
+        m_tiledView->clear();
+        m_tiledView->hide();
+        m_imageLabel->clear();
+        m_imageLabel->setStyleSheet("background-color: #191919;");
+        m_imageLabel->show();
+        startAnimation();
+        return;
     }
     
-    // Check if it's a GIF - use QMovie for animation
-    QString ext = QFileInfo(m_currentPath).suffix().toLower();
-    if (ext == "gif") {
-        m_gifMovie = new QMovie(m_currentPath, QByteArray(), this);
-        if (m_gifMovie->isValid()) {
-            // Get original GIF size and scale to fit while keeping aspect ratio
-            QSize gifSize = m_gifMovie->currentImage().size();
-            QSize labelSize = m_imageLabel->size();
-            if (!labelSize.isEmpty() && !gifSize.isEmpty()) {
-                QSize scaledSize = gifSize.scaled(labelSize, Qt::KeepAspectRatio);
-                m_gifMovie->setScaledSize(scaledSize);
+    // Regular static image - decoded off the GUI thread. The view is blank
+    // until it arrives, so the previous image isn't mistaken for this one
+    m_imageLabel->clear();
+    m_imageLabel->hide();
+    m_tiledView->setImage(m_currentPath);
+    m_tiledView->show();
+    requestPreview();
+}
+
+void MediaPreviewWidget::requestPreview()
+{
+    QSize targetSize = previewTargetSize();
+    if (targetSize.width() < 10 || targetSize.height() < 10) {
+        // Widget not yet sized properly, try again shortly
+        QTimer::singleShot(50, this, [this]() {
+            if (m_mediaType == 1 && !m_isAnimation && m_requestedSize.isEmpty()) {
+                requestPreview();
             }
-            m_imageLabel->setMovie(m_gifMovie);
-            m_gifMovie->start();  // Auto-play and loop by default
-            return;
-        } else {
-            delete m_gifMovie;
-            m_gifMovie = nullptr;
-        }
+        });
+        return;
     }
     
-    // Regular static image
-    QImageReader reader(m_currentPath);
-    reader.setAutoTransform(true);
-    m_originalImage = reader.read();
+    m_requestedSize = targetSize;
     
-    if (!m_originalImage.isNull()) {
-        updateScaledImage();
-    } else {
-        m_imageLabel->setText("Failed to load image");
-        m_imageLabel->setStyleSheet("background-color: #191919; color: #808080; font-size: 14px;");
+    // A cache hit (typically a prefetched neighbour) shows up immediately
+    // through previewReady
+    PreviewLoader::instance()->request(m_currentPath, targetSize, m_prefetchPaths);
+}
+
+void MediaPreviewWidget::onPreviewReady(const QString& filePath, const QImage& image)
+{
+    if (filePath != m_currentPath || m_mediaType != 1 || m_isAnimation) {
+        return;   // A prefetched neighbour, or the user has moved on
+    }
+    m_tiledView->setPreview(image);
+}
+
+void MediaPreviewWidget::onPreviewFailed(const QString& filePath)
+{
+    if (filePath != m_currentPath || m_mediaType != 1) {
+        return;
+    }
+    m_tiledView->hide();
+    m_imageLabel->show();
+    m_imageLabel->setText("Failed to load image");
+    m_imageLabel->setStyleSheet("background-color: #191919; color: #808080; font-size: 14px;");
+}
+
+void MediaPreviewWidget::startAnimation()
+{
+    QSize targetSize = previewTargetSize();
+    if (targetSize.width() < 10 || targetSize.height() < 10) {
+        // Widget not yet sized properly, try again once it is
+        m_animationResizeTimer->start();
+        return;
     }
+    m_animationSize = targetSize;
+    m_animationPlayer->start(m_currentPath, targetSize);
+}
+
+void MediaPreviewWidget::onAnimationFrame(const QImage& frame)
+{
+    QPixmap pixmap = QPixmap::fromImage(frame);
+    pixmap.setDevicePixelRatio(m_imageLabel->devicePixelRatioF());
+    m_imageLabel->setPixmap(pixmap);
+}
+
+void MediaPreviewWidget::onAnimationFailed()
+{
+    m_imageLabel->setText("Failed to load image");
+    m_imageLabel->setStyleSheet("background-color: #191919; color: #808080; font-size: 14px;");
+}
+
+QSize MediaPreviewWidget::previewTargetSize() const
+{
+    return m_imageWidget->size() * m_imageWidget->devicePixelRatioF();
 }
 
 void MediaPreviewWidget::loadVideo()
 {
 #ifdef HAVE_QT_MULTIMEDIA
-    m_mediaPlayer->setSource(QUrl::fromLocalFile(m_currentPath));
+    // A warm player already has the clip open and prerolled
+    bindPlayer(m_playerPool->activate(m_currentPath));
     m_playPauseButton->setText("⏸");
     m_seekSlider->setValue(0);
-    m_timeLabel->setText("0:00 / 0:00");
+    onDurationChanged(m_mediaPlayer->duration());
+    m_timeLabel->setText(QString("0:00 / %1").arg(formatTime(m_mediaPlayer->duration())));
     // Auto-play videos when loaded
     m_mediaPlayer->play();
 #endif
@@ -544,10 +694,11 @@ void MediaPreviewWidget::loadVideo()
 void MediaPreviewWidget::loadAudio()
 {
 #ifdef HAVE_QT_MULTIMEDIA
-    m_mediaPlayer->setSource(QUrl::fromLocalFile(m_currentPath));
+    bindPlayer(m_playerPool->activate(m_currentPath));
     m_playPauseButton->setText("⏸");
     m_seekSlider->setValue(0);
-    m_timeLabel->setText("0:00 / 0:00");
+    onDurationChanged(m_mediaPlayer->duration());
+    m_timeLabel->setText(QString("0:00 / %1").arg(formatTime(m_mediaPlayer->duration())));
     // Auto-play audio when loaded
     m_mediaPlayer->play();
 #endif
@@ -563,42 +714,46 @@ void MediaPreviewWidget::resizeEvent(QResizeEvent* event)
     QWidget::resizeEvent(event);
     
     if (m_mediaType == 1) {
-        if (m_gifMovie && m_gifMovie->isValid()) {
-            // Resize GIF to fit label while keeping aspect ratio
-            QSize gifSize = m_gifMovie->currentImage().size();
-            QSize labelSize = m_imageLabel->size();
-            if (!labelSize.isEmpty() && !gifSize.isEmpty()) {
-                QSize scaledSize = gifSize.scaled(labelSize, Qt::KeepAspectRatio);
-                m_gifMovie->setScaledSize(scaledSize);
+        if (m_isAnimation) {
+            // Frames are decoded at display size; re-decode once resizing
+            // settles rather than on every step of a splitter drag
+            if (previewTargetSize() != m_animationSize) {
+                m_animationResizeTimer->start();
+            }
+        } else if (!m_currentPath.isEmpty() && !m_requestedSize.isEmpty()) {
+            // Growing past what was decoded needs a larger decode; the
+            // current image is rescaled meanwhile
+            QSize targetSize = previewTargetSize();
+            if (targetSize.width() > m_requestedSize.width() ||
+                targetSize.height() > m_requestedSize.height()) {
+                requestPreview();
             }
-        } else if (!m_originalImage.isNull()) {
-            updateScaledImage();
         }
     }
 }
 
-void MediaPreviewWidget::updateScaledImage()
+#ifdef HAVE_QT_MULTIMEDIA
+void MediaPreviewWidget::bindPlayer(QMediaPlayer* player)
 {
-    if (m_originalImage.isNull()) {
+    if (m_mediaPlayer == player) {
         return;
     }
-    
-    QSize targetSize = m_imageLabel->size();
-    if (targetSize.isEmpty() || targetSize.width() < 10 || targetSize.height() < 10) {
-        // Widget not yet sized properly, schedule update
-        QTimer::singleShot(50, this, &MediaPreviewWidget::updateScaledImage);
-        return;
+    if (m_mediaPlayer) {
+        disconnect(m_mediaPlayer, nullptr, this, nullptr);
+    }
+    m_mediaPlayer = player;
+    if (m_mediaPlayer) {
+        connect(m_mediaPlayer, &QMediaPlayer::positionChanged, this, &MediaPreviewWidget::onPositionChanged);
+        connect(m_mediaPlayer, &QMediaPlayer::durationChanged, this, &MediaPreviewWidget::onDurationChanged);
+        connect(m_mediaPlayer, &QMediaPlayer::mediaStatusChanged, this, &MediaPreviewWidget::onMediaStatusChanged);
     }
-    
-    QSize scaledSize = m_originalImage.size().scaled(targetSize, Qt::KeepAspectRatio);
-    QImage scaled = m_originalImage.scaled(scaledSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    m_scaledPixmap = QPixmap::fromImage(scaled);
-    m_imageLabel->setPixmap(m_scaledPixmap);
 }
 
-#ifdef HAVE_QT_MULTIMEDIA
 void MediaPreviewWidget::onPlayPauseClicked()
 {
+    if (!m_mediaPlayer) {
+        return;
+    }
     if (m_mediaPlayer->playbackState() == QMediaPlayer::PlayingState) {
         m_mediaPlayer->pause();
         m_playPauseButton->setText("▶");
@@ -624,7 +779,9 @@ void MediaPreviewWidget::onDurationChanged(qint64 duration)
 
 void MediaPreviewWidget::onSeekSliderMoved(int position)
 {
-    m_mediaPlayer->setPosition(position);
+    if (m_mediaPlayer) {
+        m_mediaPlayer->setPosition(position);
+    }
 }
 
 void MediaPreviewWidget::onMediaStatusChanged(QMediaPlayer::MediaStatus status)
@@ -725,9 +882,10 @@ void TaggingSidebarWidget::setupUI()
     m_noTagsLabel->setStyleSheet("color: #606060; font-size: 11px; font-style: italic;");
     tagsContainerLayout->addWidget(m_noTagsLabel);
     
-    // Flow widget for compact tags (we'll add tags here dynamically)
-    m_tagsFlowWidget = new QWidget(m_tagsContainer);
-    m_tagsFlowWidget->setStyleSheet("background: transparent;");
+    // Chips are painted by one flow widget that lives as long as the sidebar
+    m_tagsFlowWidget = new TagChipFlowWidget(m_tagsContainer);
+    m_tagsFlowWidget->hide();
+    connect(m_tagsFlowWidget, &TagChipFlowWidget::tagClicked, this, &TaggingSidebarWidget::tagClicked);
     tagsContainerLayout->addWidget(m_tagsFlowWidget);
     tagsContainerLayout->addStretch();
     
@@ -796,9 +954,11 @@ void TaggingSidebarWidget::setupUI()
     // Setup autocomplete
     m_completerModel = new QStringListModel(this);
     m_tagCompleter = new QCompleter(m_completerModel, this);
+    // The model only ever holds the ranked matches from TagCompletionIndex,
+    // so the completer shows it as is instead of filtering it again
     m_tagCompleter->setCaseSensitivity(Qt::CaseInsensitive);
-    m_tagCompleter->setFilterMode(Qt::MatchContains);
-    m_tagCompleter->setCompletionMode(QCompleter::PopupCompletion);
+    m_tagCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    m_tagCompleter->setMaxVisibleItems(CompletionLimit);
     m_tagCompleter->popup()->setStyleSheet(R"(
         QListView {
             background-color: #2d2d2d;
@@ -821,6 +981,7 @@ void TaggingSidebarWidget::setupUI()
     )");
     m_tagInput->setCompleter(m_tagCompleter);
     
+    connect(m_tagInput, &QLineEdit::textEdited, this, &TaggingSidebarWidget::onTagTextEdited);
     connect(m_tagInput, &QLineEdit::returnPressed, this, &TaggingSidebarWidget::onTagEnterPressed);
     connect(m_tagInput, &AutoCompleteLineEdit::tabPressed, this, &TaggingSidebarWidget::onTabPressed);
     
@@ -847,13 +1008,6 @@ void TaggingSidebarWidget::setFilePath(const QString& filePath)
     m_filePath = filePath;
     updateFileInfo();
     updateTags();
-    
-    // Update completer with all tags
-    QStringList tagNames;
-    for (const Tag& tag : TagManager::instance()->allTags()) {
-        tagNames.append(tag.name);
-    }
-    m_completerModel->setStringList(tagNames);
 }
 
 void TaggingSidebarWidget::refresh()
@@ -886,155 +1040,16 @@ void TaggingSidebarWidget::updateFileInfo()
 
 void TaggingSidebarWidget::updateTags()
 {
-    // Safety check
-    if (!m_tagsFlowWidget || !m_tagsContainer) {
-        return;
-    }
-    
-    // Simplest and safest approach: delete and recreate the flow widget
-    // This avoids all the complex nested layout deletion issues
-    QLayout* containerLayout = m_tagsContainer->layout();
-    if (containerLayout) {
-        // Remove the old flow widget from container
-        containerLayout->removeWidget(m_tagsFlowWidget);
-    }
-    
-    // Delete the old flow widget (Qt will handle all child widgets automatically)
-    m_tagsFlowWidget->deleteLater();
-    m_tagsFlowWidget = nullptr;
-    
-    // Process events to ensure deletion happens
-    QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-    
-    // Create a new flow widget
-    m_tagsFlowWidget = new QWidget(m_tagsContainer);
-    m_tagsFlowWidget->setStyleSheet("background: transparent;");
-    m_tagsFlowWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Minimum);
-    
-    // Re-add to container layout
-    if (containerLayout) {
-        // Cast to QVBoxLayout to use insertWidget (which QVBoxLayout has)
-        QVBoxLayout* vboxLayout = qobject_cast<QVBoxLayout*>(containerLayout);
-        if (vboxLayout) {
-            // Insert before the stretch (which is at the end)
-            int stretchIndex = vboxLayout->count() - 1;
-            if (stretchIndex >= 0) {
-                vboxLayout->insertWidget(stretchIndex, m_tagsFlowWidget);
-            } else {
-                vboxLayout->addWidget(m_tagsFlowWidget);
-            }
-        } else {
-            // Fallback for other layout types
-            containerLayout->addWidget(m_tagsFlowWidget);
-        }
+    // Only the chip data changes here; the flow widget is reused
+    QList<Tag> tags;
+    if (!m_filePath.isEmpty()) {
+        tags = TagManager::instance()->tagsForImage(m_filePath);
     }
     
-    if (m_filePath.isEmpty()) {
-        m_noTagsLabel->show();
-        return;
-    }
-    
-    QList<Tag> tags = TagManager::instance()->tagsForImage(m_filePath);
-    
-    if (tags.isEmpty()) {
-        m_noTagsLabel->show();
-        m_tagsFlowWidget->hide();
-        return;
-    }
-    
-    m_noTagsLabel->hide();
-    m_tagsFlowWidget->show();
-    
-    // Use vertical layout with horizontal rows that wrap
-    QVBoxLayout* mainLayout = new QVBoxLayout(m_tagsFlowWidget);
-    mainLayout->setContentsMargins(0, 0, 0, 0);
-    mainLayout->setSpacing(3);
-    mainLayout->setAlignment(Qt::AlignLeft | Qt::AlignTop);
-    
     // Tags are already sorted by supertag first (from TagManager::tagsForImage)
-    // Get available width from the scroll area or use a reasonable default
-    int availableWidth = m_tagsScrollArea->width() - 40;  // Account for margins/padding and scrollbar
-    if (availableWidth < 100) availableWidth = 250;  // Default width if not yet sized
-    
-    QHBoxLayout* currentRow = nullptr;
-    int currentRowWidth = 0;
-    int badgeSpacing = 3;
-    
-    for (const Tag& tag : tags) {
-        bool isSupertag = tag.isSupertag;
-        int badgeHeight = isSupertag ? 20 : 16;
-        int badgePadding = isSupertag ? 8 : 6;
-        int fontSize = isSupertag ? 9 : 8;
-        
-        // Estimate badge width
-        QFontMetrics fm(QFont("", fontSize));
-        int textWidth = fm.horizontalAdvance(QString("%1 ×").arg(tag.name));
-        int badgeWidth = textWidth + badgePadding * 2;
-        
-        // Create new row if needed
-        if (!currentRow || (currentRowWidth + badgeWidth + badgeSpacing > availableWidth && currentRowWidth > 0)) {
-            currentRow = new QHBoxLayout();
-            currentRow->setContentsMargins(0, 0, 0, 0);
-            currentRow->setSpacing(badgeSpacing);
-            currentRow->setAlignment(Qt::AlignLeft);
-            mainLayout->addLayout(currentRow);
-            currentRowWidth = 0;
-        }
-        
-        QPushButton* tagBadge = new QPushButton(m_tagsFlowWidget);
-        tagBadge->setText(QString("%1 ×").arg(tag.name));
-        tagBadge->setCursor(Qt::PointingHandCursor);
-        tagBadge->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
-        
-        QColor bgColor = QColor(tag.color);
-        QColor textColor = (bgColor.lightness() > 128) ? QColor(20, 20, 20) : QColor(255, 255, 255);
-        
-        // Style with shadow for supertags
-        QString shadowStyle = isSupertag ? 
-            QString("QPushButton { box-shadow: 0 2px 4px rgba(0, 0, 0, 0.4); }") : "";
-        
-        tagBadge->setStyleSheet(QString(R"(
-            QPushButton {
-                background-color: %1;
-                border: none;
-                border-radius: 3px;
-                padding: %2px %3px;
-                min-height: %4px;
-                max-height: %4px;
-                color: %5;
-                font-size: %6pt;
-                font-weight: bold;
-            }
-            QPushButton:hover {
-                background-color: %7;
-            }
-        )").arg(bgColor.name())
-           .arg(isSupertag ? 2 : 1)
-           .arg(badgePadding)
-           .arg(badgeHeight)
-           .arg(textColor.name())
-           .arg(fontSize)
-           .arg(bgColor.darker(115).name()));
-        
-        // Add shadow effect for supertags
-        if (isSupertag) {
-            QGraphicsDropShadowEffect* shadow = new QGraphicsDropShadowEffect(tagBadge);
-            shadow->setBlurRadius(4);
-            shadow->setColor(QColor(0, 0, 0, 100));
-            shadow->setOffset(2, 2);
-            tagBadge->setGraphicsEffect(shadow);
-        }
-        
-        qint64 tagId = tag.id;
-        connect(tagBadge, &QPushButton::clicked, this, [this, tagId]() {
-            Q_EMIT tagClicked(tagId);
-        });
-        
-        currentRow->addWidget(tagBadge);
-        currentRowWidth += badgeWidth + badgeSpacing;
-    }
-    
-    mainLayout->addStretch();  // Push tags to the top
+    m_tagsFlowWidget->setTags(tags);
+    m_tagsFlowWidget->setVisible(!tags.isEmpty());
+    m_noTagsLabel->setVisible(tags.isEmpty());
 }
 
 QString TaggingSidebarWidget::formatFileSize(qint64 bytes) const
@@ -1067,10 +1082,9 @@ void TaggingSidebarWidget::onTagEnterPressed()
     }
     
     // Create tag if doesn't exist
-    Tag existingTag = TagManager::instance()->tagByName(tagName);
-    qint64 tagId;
+    qint64 tagId = TagManager::instance()->completionIndex().tagId(tagName);
     
-    if (!existingTag.isValid()) {
+    if (tagId < 0) {
         // Generate a nice color for new tag
         static const QStringList colors = {
             "#e74c3c", "#3498db", "#2ecc71", "#f39c12", "#9b59b6",
@@ -1078,8 +1092,6 @@ void TaggingSidebarWidget::onTagEnterPressed()
         };
         QString color = colors[QRandomGenerator::global()->bounded(colors.size())];
         tagId = TagManager::instance()->createTag(tagName, color);
-    } else {
-        tagId = existingTag.id;
     }
     
     if (tagId > 0) {
@@ -1091,12 +1103,32 @@ void TaggingSidebarWidget::onTagEnterPressed()
 
 void TaggingSidebarWidget::onTabPressed()
 {
-    if (m_tagCompleter->completionCount() > 0) {
+    if (m_tagInput->text().trimmed().isEmpty() || m_completerModel->rowCount() == 0) {
+        return;
+    }
+    
+    // Take the highlighted suggestion, otherwise the best ranked one
+    QAbstractItemView* popup = m_tagCompleter->popup();
+    QModelIndex index = popup->currentIndex();
+    if (!popup->isVisible() || !index.isValid()) {
+        index = m_completerModel->index(0);
+    }
+    popup->hide();
+    m_tagInput->setText(index.data().toString());
+}
+
+void TaggingSidebarWidget::onTagTextEdited(const QString& text)
+{
+    QStringList names;
+    for (const TagCompletion& completion : TagManager::instance()->completionIndex().complete(text, CompletionLimit)) {
+        names.append(completion.name);
+    }
+    m_completerModel->setStringList(names);
+    
+    if (names.isEmpty()) {
         m_tagCompleter->popup()->hide();
-        QString completion = m_tagCompleter->currentCompletion();
-        if (!completion.isEmpty()) {
-            m_tagInput->setText(completion);
-        }
+    } else {
+        m_tagCompleter->complete();
     }
 }
 
@@ -1118,7 +1150,7 @@ void TaggingModeWidget::setupUI()
     mainLayout->setSpacing(0);
 
     // === Top: Horizontal thumbnail strip ===
-    m_thumbnailStrip = new QListView(this);
+    m_thumbnailStrip = new ThumbnailStripView(this);
     m_thumbnailStrip->setFlow(QListView::LeftToRight);
     m_thumbnailStrip->setWrapping(false);
     m_thumbnailStrip->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
@@ -1215,6 +1247,14 @@ void TaggingModeWidget::setupUI()
             m_sidebar->refresh();
         }
     });
+    // Album moves rename files under the preview; keep tagging the same file
+    connect(TagManager::instance(), &TagManager::imagePathUpdated, this,
+            [this](const QString& oldPath, const QString& newPath) {
+        if (oldPath == m_currentImagePath) {
+            m_currentImagePath = newPath;
+            m_sidebar->setFilePath(newPath);
+        }
+    });
 
     setStyleSheet("background-color: #1e1e1e;");
 }
@@ -1335,6 +1375,21 @@ void TaggingModeWidget::selectImage(const QString& filePath)
     }
 }
 
+void TaggingModeWidget::setFrameStatsVisible(bool visible)
+{
+    m_thumbnailStrip->setFrameStatsVisible(visible);
+}
+
+FrameStatsOverlay* TaggingModeWidget::frameStats() const
+{
+    return m_thumbnailStrip->frameStats();
+}
+
+void TaggingModeWidget::reportMemory(MemoryReport& report) const
+{
+    m_previewWidget->reportMemory(report);
+}
+
 void TaggingModeWidget::refresh()
 {
     m_sidebar->refresh();
@@ -1507,8 +1562,44 @@ void TaggingModeWidget::updateTagCompleter()
 
 void TaggingModeWidget::updatePreview()
 {
-    m_previewWidget->setMedia(m_currentImagePath);
+    m_previewWidget->setMedia(m_currentImagePath,
+                              neighbourPaths(PrefetchNeighbours, MediaType::Image) +
+                              neighbourPaths(WarmVideoNeighbours, MediaType::Video));
     m_sidebar->setFilePath(m_currentImagePath);
 }
 
+QStringList TaggingModeWidget::neighbourPaths(int count, MediaType type) const
+{
+    QStringList paths;
+    const QModelIndex current = m_thumbnailStrip->currentIndex();
+    if (!m_model || !current.isValid() || count <= 0) {
+        return paths;
+    }
+    
+    // Nearest first, alternating forward/back. Animations aren't decoded
+    // by PreviewLoader, so they don't count as images here
+    const int row = current.row();
+    const int rows = m_model->rowCount();
+    int ahead = 0;
+    int behind = 0;
+    for (int step = 1; step <= count * 4 && (ahead < count || behind < count); ++step) {
+        for (int direction : {1, -1}) {
+            int& found = direction > 0 ? ahead : behind;
+            const int neighbour = row + direction * step;
+            if (found >= count || neighbour < 0 || neighbour >= rows) {
+                continue;
+            }
+            const ImageItem item = m_model->itemAt(neighbour);
+            const bool matches = type == MediaType::Image
+                ? item.isImage() && !AnimationLoader::isAnimationFile(item.filePath)
+                : item.mediaType == type;
+            if (matches) {
+                paths.append(item.filePath);
+                ++found;
+            }
+        }
+    }
+    return paths;
+}
+
 } // namespace FullFrame
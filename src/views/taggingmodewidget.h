@@ -24,7 +24,6 @@
 #include <QStackedWidget>
 #include <QScrollArea>
 #include <QFileInfo>
-#include <QMovie>
 
 #ifdef HAVE_QT_MULTIMEDIA
 #include <QMediaPlayer>
@@ -32,9 +31,18 @@
 #include <QAudioOutput>
 #endif
 
+class QTimer;
+
 namespace FullFrame {
 
 class ImageThumbnailModel;
+class FrameStatsOverlay;
+class TiledImageView;
+class TagChipFlowWidget;
+class AnimationPlayer;
+class VideoPlayerPool;
+class MemoryReport;
+enum class MediaType;
 struct Tag;
 
 /**
@@ -72,12 +80,38 @@ public:
                      const QStyleOptionViewItem& option,
                      const QModelIndex& index) override;
 
+    // The strip's own thumbnail size class: a StripThumbnailSize box fits
+    // the cell inside its margins, so strip pixmaps are never rescaled
+    static constexpr int ThumbnailMargin = 4;
+    static constexpr int StripThumbnailSize = 112;
+
 Q_SIGNALS:
     void sequenceToggleRequested(const QString& coverPath);
 
 private:
     QRect sequenceBadgeRect(const QRect& itemRect) const;
-    int m_thumbnailHeight = 120;
+    int m_thumbnailHeight = StripThumbnailSize + ThumbnailMargin * 2;
+};
+
+/**
+ * Horizontal thumbnail strip; a QListView that can carry the frame-time HUD
+ */
+class ThumbnailStripView : public QListView
+{
+    Q_OBJECT
+
+public:
+    explicit ThumbnailStripView(QWidget* parent = nullptr);
+
+    void setFrameStatsVisible(bool visible);
+    FrameStatsOverlay* frameStats() const { return m_frameStats; }
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    FrameStatsOverlay* m_frameStats = nullptr;
 };
 
 /**
@@ -92,12 +126,16 @@ public:
     explicit MediaPreviewWidget(QWidget* parent = nullptr);
     ~MediaPreviewWidget();
     
-    void setMedia(const QString& filePath);
+    // `prefetchPaths` are neighbouring images decoded ahead in the background
+    void setMedia(const QString& filePath, const QStringList& prefetchPaths = QStringList());
     void clear();
     void stopPlayback();
     
     QString currentPath() const { return m_currentPath; }
     int mediaType() const { return m_mediaType; }
+    
+    // The shown image or animation frame
+    void reportMemory(MemoryReport& report) const;
 
 Q_SIGNALS:
     void mediaLoaded(const QString& filePath, int mediaType);
@@ -109,8 +147,17 @@ private Q_SLOTS:
     void onDurationChanged(qint64 duration);
     void onSeekSliderMoved(int position);
     void onMediaStatusChanged(QMediaPlayer::MediaStatus status);
+    
+private:
+    void bindPlayer(QMediaPlayer* player);
 #endif
 
+private Q_SLOTS:
+    void onPreviewReady(const QString& filePath, const QImage& image);
+    void onPreviewFailed(const QString& filePath);
+    void onAnimationFrame(const QImage& frame);
+    void onAnimationFailed();
+
 protected:
     void paintEvent(QPaintEvent* event) override;
     void resizeEvent(QResizeEvent* event) override;
@@ -119,19 +166,28 @@ private:
     void loadImage();
     void loadVideo();
     void loadAudio();
-    void updateScaledImage();
+    void requestPreview();
+    void startAnimation();
+    QSize previewTargetSize() const;
     QString formatTime(qint64 ms) const;
 
 private:
     QString m_currentPath;
     int m_mediaType = 0;  // 0=unknown, 1=image, 2=video, 3=audio
     
-    // Image display
-    QImage m_originalImage;
-    QPixmap m_scaledPixmap;
+    // Image display; the preview is decoded in the background by
+    // PreviewLoader at roughly m_requestedSize
+    QStringList m_prefetchPaths;
+    QSize m_requestedSize;
     QWidget* m_imageWidget;
     QLabel* m_imageLabel;
-    QMovie* m_gifMovie = nullptr;
+    TiledImageView* m_tiledView;
+    
+    // Animated images (GIF/WebP/APNG), decoded at m_animationSize
+    AnimationPlayer* m_animationPlayer;
+    QTimer* m_animationResizeTimer;
+    QSize m_animationSize;
+    bool m_isAnimation = false;
     
     // Stacked widget for switching between image/video/audio views
     QStackedWidget* m_stackedWidget;
@@ -139,7 +195,8 @@ private:
 #ifdef HAVE_QT_MULTIMEDIA
     // Video/Audio playback
     QVideoWidget* m_videoWidget;
-    QMediaPlayer* m_mediaPlayer;
+    VideoPlayerPool* m_playerPool;
+    QMediaPlayer* m_mediaPlayer = nullptr;   // Active player from m_playerPool
     QAudioOutput* m_audioOutput;
     
     // Media controls
@@ -177,8 +234,12 @@ Q_SIGNALS:
 private Q_SLOTS:
     void onTagEnterPressed();
     void onTabPressed();
+    void onTagTextEdited(const QString& text);
 
 private:
+    // Suggestions shown while typing a tag name
+    static constexpr int CompletionLimit = 12;
+
     void updateFileInfo();
     void updateTags();
     void setupUI();
@@ -197,7 +258,7 @@ private:
     // Tags display
     QScrollArea* m_tagsScrollArea;
     QWidget* m_tagsContainer;
-    QWidget* m_tagsFlowWidget;
+    TagChipFlowWidget* m_tagsFlowWidget;
     QLabel* m_noTagsLabel;
     
     // Tag input
@@ -238,6 +299,12 @@ public:
     void selectFirst();
     void selectByRow(int row);
     void selectImage(const QString& filePath);
+    
+    // Frame-time HUD on the thumbnail strip
+    void setFrameStatsVisible(bool visible);
+    FrameStatsOverlay* frameStats() const;
+    
+    void reportMemory(MemoryReport& report) const;
 
 Q_SIGNALS:
     void imageSelected(const QString& filePath);
@@ -265,13 +332,18 @@ private Q_SLOTS:
 private:
     void setupUI();
     void updatePreview();
+    
+    // Paths of up to `count` items of `type` on each side of the current one
+    QStringList neighbourPaths(int count, MediaType type) const;
+    static constexpr int PrefetchNeighbours = 2;
+    static constexpr int WarmVideoNeighbours = 1;   // See VideoPlayerPool::PoolSize
 
 private:
     // Model
     ImageThumbnailModel* m_model = nullptr;
     
     // UI Components
-    QListView* m_thumbnailStrip;
+    ThumbnailStripView* m_thumbnailStrip;
     HorizontalThumbnailDelegate* m_delegate;
     MediaPreviewWidget* m_previewWidget;
     TaggingSidebarWidget* m_sidebar;
@@ -6,13 +6,14 @@
 
 #include "thumbnaildelegate.h"
 #include "imagethumbnailmodel.h"
+#include "badgecache.h"
 #include "tagmanager.h"
+#include "perfcounters.h"
+#include "eventtrace.h"
 
 #include <QPainter>
 #include <QApplication>
-#include <QPainterPath>
 #include <QMouseEvent>
-#include <cmath>
 
 namespace FullFrame {
 
@@ -35,9 +36,16 @@ ThumbnailDelegate::ThumbnailDelegate(QObject* parent)
     m_badgeFont.setPointSize(8);
     m_badgeFont.setBold(true);
     m_badgeFM = QFontMetrics(m_badgeFont);
+
+    // All overlay rendering (badges, stars, pills, elided names) is done once
+    // into this cache; paint() only blits
+    m_badgeCache = new BadgeCache(m_badgeFont, m_filenameFont);
 }
 
-ThumbnailDelegate::~ThumbnailDelegate() = default;
+ThumbnailDelegate::~ThumbnailDelegate()
+{
+    delete m_badgeCache;
+}
 
 void ThumbnailDelegate::setThumbnailSize(int size)
 {
@@ -73,6 +81,8 @@ void ThumbnailDelegate::setShowTagIndicator(bool show)
 void ThumbnailDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
                                const QModelIndex& index) const
 {
+    EventTrace::Span span("paintTile", "paint");
+    PerfCounters::add(PerfCounters::TilesPainted);
     painter->save();
     
     // Background
@@ -84,74 +94,66 @@ void ThumbnailDelegate::paint(QPainter* painter, const QStyleOptionViewItem& opt
     int thumbY = itemRect.y() + m_spacing;
     QRect thumbRect(thumbX, thumbY, m_thumbnailSize, m_thumbnailSize);
 
-    // Get thumbnail pixmap - use type() check to avoid expensive canConvert
-    QVariant thumbVar = index.data(Qt::DecorationRole);
-    if (thumbVar.userType() == QMetaType::QPixmap) {
-        QPixmap pixmap = thumbVar.value<QPixmap>();
-        if (!pixmap.isNull()) {
-            // No SmoothPixmapTransform — thumbnails are already created at
-            // the target size, so drawPixmap is a 1:1 blit (no scaling).
-            paintThumbnail(painter, thumbRect, pixmap);
-        } else {
-            painter->fillRect(thumbRect, QColor(50, 50, 50));
-        }
+    // One model call per tile: pixmap, flags, rating, sequence count, name
+    // and prebuilt badges all come back in a single packed record instead
+    // of eight QVariant-boxed data() lookups.
+    const auto* imageModel = qobject_cast<const ImageThumbnailModel*>(index.model());
+    if (!imageModel) {
+        painter->restore();
+        return;
+    }
+    const ThumbnailPaintRecord record = imageModel->paintRecord(index.row());
+
+    if (record.pixmap && !record.pixmap->isNull()) {
+        // No SmoothPixmapTransform. A thumbnail loaded for the current
+        // size blits 1:1; the tiny progressive preview and the pixmaps kept
+        // while zooming are stand-ins that get scaled, and fast scaling is
+        // fine until their exact-size replacement arrives.
+        paintThumbnail(painter, thumbRect, *record.pixmap);
+    } else {
+        painter->fillRect(thumbRect, QColor(50, 50, 50));
     }
 
+    // Overlays are pre-rendered sprites — no antialiasing state changes and
+    // no text layout in the per-tile path
+    const qreal dpr = painter->device()->devicePixelRatioF();
+
     // Selection effects
-    bool selected = option.state & QStyle::State_Selected;
-    if (selected) {
-        painter->setRenderHint(QPainter::Antialiasing, true);
-        paintSelection(painter, thumbRect, option);
-        painter->setRenderHint(QPainter::Antialiasing, false);
+    if (option.state & QStyle::State_Selected) {
+        paintSelection(painter, thumbRect, option, dpr);
     }
 
-    // Check if item is favorited (using favorites set, not tags)
-    bool isFavorited = index.data(IsFavoritedRole).toBool();
-    
-    // Tag badges — only query model if item has tags (fast HasTagsRole check first)
-    if (index.data(HasTagsRole).toBool()) {
-        QVariantList tagList = index.data(TagListRole).toList();
-        if (!tagList.isEmpty()) {
-            painter->setRenderHint(QPainter::Antialiasing, true);
-            paintTagBadges(painter, thumbRect, tagList);
-            painter->setRenderHint(QPainter::Antialiasing, false);
-        }
+    // Tag badges — the record only carries a badge list when the item has tags
+    if (record.badges && !record.badges->isEmpty()) {
+        paintTagBadges(painter, thumbRect, *record.badges, dpr);
     }
     
     // Draw rating dots (top-right corner)
-    int ratingValue = index.data(RatingRole).toInt();
+    int ratingValue = record.rating;
     if (ratingValue > 0) {
-        painter->setRenderHint(QPainter::Antialiasing, true);
-        paintRating(painter, thumbRect, ratingValue);
-        painter->setRenderHint(QPainter::Antialiasing, false);
+        paintRating(painter, thumbRect, ratingValue, dpr);
     }
     
     // Draw favorite star (to the left of rating dots, or top-right if no rating)
-    if (isFavorited) {
-        painter->setRenderHint(QPainter::Antialiasing, true);
-        paintFavoriteStar(painter, thumbRect, ratingValue);
-        painter->setRenderHint(QPainter::Antialiasing, false);
+    if (record.has(ThumbnailPaintRecord::Favorited)) {
+        paintFavoriteStar(painter, thumbRect, ratingValue, dpr);
     }
 
     // Sequence stack badge (top-left corner)
-    int seqCount = index.data(SequenceCountRole).toInt();
-    if (seqCount > 1) {
-        bool seqExpanded = index.data(IsSequenceExpandedRole).toBool();
-        painter->setRenderHint(QPainter::Antialiasing, true);
-        paintSequenceBadge(painter, thumbRect, seqCount, seqExpanded);
-        painter->setRenderHint(QPainter::Antialiasing, false);
+    if (record.sequenceCount > 1) {
+        paintSequenceBadge(painter, thumbRect, record.sequenceCount,
+                           record.has(ThumbnailPaintRecord::SequenceExpanded), dpr);
     }
 
     // Filename
-    if (m_showFilename) {
+    if (m_showFilename && record.fileName) {
         QRect filenameRect(
             itemRect.x() + m_spacing,
             itemRect.y() + m_spacing + m_thumbnailSize + 4,
             m_thumbnailSize,
             m_filenameHeight
         );
-        QString filename = index.data(FileNameRole).toString();
-        paintFilename(painter, filenameRect, filename);
+        paintFilename(painter, filenameRect, *record.fileName);
     }
 
     painter->restore();
@@ -176,17 +178,17 @@ void ThumbnailDelegate::paintThumbnail(QPainter* painter, const QRect& rect,
 }
 
 void ThumbnailDelegate::paintSelection(QPainter* painter, const QRect& rect,
-                                        const QStyleOptionViewItem& option) const
+                                        const QStyleOptionViewItem& option, qreal dpr) const
 {
     bool selected = option.state & QStyle::State_Selected;
     // Disabled hover effect to prevent flickering
     // bool hovered = option.state & QStyle::State_MouseOver;
 
     if (selected) {
-        // Selection border
-        painter->setPen(QPen(m_selectionColor, 3));
-        painter->setBrush(Qt::NoBrush);
-        painter->drawRoundedRect(rect.adjusted(-2, -2, 2, 2), 6, 6);
+        // Selection border (pre-rendered rounded frame)
+        if (const BadgeSprite* frame = m_badgeCache->selectionFrame(rect.size(), m_selectionColor, dpr)) {
+            painter->drawPixmap(rect.topLeft() + frame->offset, frame->pixmap);
+        }
         
         // Selection overlay
         painter->fillRect(rect, QColor(m_selectionColor.red(), 
@@ -199,12 +201,15 @@ void ThumbnailDelegate::paintSelection(QPainter* painter, const QRect& rect,
 void ThumbnailDelegate::paintFilename(QPainter* painter, const QRect& rect,
                                        const QString& filename) const
 {
+    // Elided text is cached as prepared QStaticText keyed by (name, width)
+    const QStaticText* text = m_badgeCache->elidedText(filename, rect.width());
+    if (!text) {
+        return;
+    }
     painter->setPen(m_textColor);
     painter->setFont(m_filenameFont);
-    
-    // Elide text using pre-cached font metrics
-    QString elidedText = m_filenameFM.elidedText(filename, Qt::ElideMiddle, rect.width());
-    painter->drawText(rect, Qt::AlignHCenter | Qt::AlignTop, elidedText);
+    const qreal x = rect.x() + (rect.width() - text->size().width()) / 2.0;
+    painter->drawStaticText(QPointF(x, rect.y()), *text);
 }
 
 void ThumbnailDelegate::paintTagIndicator(QPainter* painter, const QRect& rect,
@@ -217,68 +222,44 @@ void ThumbnailDelegate::paintTagIndicator(QPainter* painter, const QRect& rect,
 }
 
 void ThumbnailDelegate::paintTagBadges(QPainter* painter, const QRect& rect,
-                                        const QVariantList& tags) const
+                                        const TagBadgeList& tags, qreal dpr) const
 {
     if (tags.isEmpty()) {
         return;
     }
 
-    // Separate supertags from regular tags
-    QVariantList supertags;
-    QVariantList regularTags;
-    
-    for (const QVariant& tagVar : tags) {
-        QVariantMap tagInfo = tagVar.toMap();
-        bool isSupertag = tagInfo.value("isSupertag", false).toBool();
-        if (isSupertag) {
-            supertags.append(tagVar);
-        } else {
-            regularTags.append(tagVar);
-        }
-    }
-    
-    // Combine: supertags first, then regular tags
-    QVariantList sortedTags = supertags + regularTags;
-
-    painter->setFont(m_badgeFont);
-
-    int badgeHeight = 16;
-    int supertagHeight = 20;  // Larger for supertags
-    int badgePadding = 6;
-    int supertagPadding = 8;  // More padding for supertags
+    // The model already orders the list supertags first, then regular tags
     int badgeSpacing = 3;
-    int badgeRadius = 3;
     int margin = 4;
 
     // Start from bottom-left of the thumbnail, going right
     int x = rect.left() + margin;
-    int y = rect.bottom() - badgeHeight - margin;
+    int y = rect.bottom() - BadgeCache::BadgeHeight - margin;
     int maxX = rect.right() - margin;
     int minY = rect.top() + margin;  // Don't draw above the thumbnail
+    int rowWidth = maxX - (rect.left() + margin);
 
-    for (const QVariant& tagVar : sortedTags) {
-        QVariantMap tagInfo = tagVar.toMap();
-        QString name = tagInfo["name"].toString();
-        QString colorStr = tagInfo["color"].toString();
-        bool isSupertag = tagInfo.value("isSupertag", false).toBool();
-        
-        // Use larger size for supertags
-        int currentBadgeHeight = isSupertag ? supertagHeight : badgeHeight;
-        int currentPadding = isSupertag ? supertagPadding : badgePadding;
-        
-        // Calculate badge width
-        int textWidth = m_badgeFM.horizontalAdvance(name);
-        int badgeWidth = textWidth + currentPadding * 2;
+    for (const TagBadgeInfo& tag : tags) {
+        // Natural-width sprite first; its cached size drives the layout
+        const BadgeSprite* sprite = m_badgeCache->tagBadge(tag, 0, dpr);
+        if (!sprite) {
+            continue;
+        }
         
         // Clamp badge width to available row width so very long tag names still fit
-        if (badgeWidth > maxX - (rect.left() + margin)) {
-            badgeWidth = maxX - (rect.left() + margin);
+        if (sprite->size.width() > rowWidth) {
+            sprite = m_badgeCache->tagBadge(tag, rowWidth, dpr);
+            if (!sprite) {
+                continue;
+            }
         }
+        const int badgeWidth = sprite->size.width();
+        const int badgeHeight = sprite->size.height();
         
         // Wrap to the next row above if this badge doesn't fit
         if (x + badgeWidth > maxX) {
             x = rect.left() + margin;
-            y -= (currentBadgeHeight + badgeSpacing);
+            y -= (badgeHeight + badgeSpacing);
             
             // Stop if we've run out of vertical space
             if (y < minY) {
@@ -286,49 +267,24 @@ void ThumbnailDelegate::paintTagBadges(QPainter* painter, const QRect& rect,
             }
         }
         
-        QRect badgeRect(x, y, badgeWidth, currentBadgeHeight);
-        
-        // Determine badge color
-        QColor bgColor = colorStr.isEmpty() ? QColor(100, 100, 100) : QColor(colorStr);
-        
-        // Draw shadow for supertags
-        if (isSupertag) {
-            painter->setPen(Qt::NoPen);
-            painter->setBrush(QColor(0, 0, 0, 100));
-            QRect shadowRect = badgeRect.translated(2, 2);
-            painter->drawRoundedRect(shadowRect, badgeRadius, badgeRadius);
-        }
-        
-        // Draw badge background with slight transparency
-        painter->setPen(Qt::NoPen);
-        QColor fillColor = bgColor;
-        fillColor.setAlpha(220);
-        painter->setBrush(fillColor);
-        painter->drawRoundedRect(badgeRect, badgeRadius, badgeRadius);
-        
-        // Draw text - use white or black depending on background brightness
-        int brightness = (bgColor.red() * 299 + bgColor.green() * 587 + bgColor.blue() * 114) / 1000;
-        painter->setPen(brightness > 128 ? Qt::black : Qt::white);
-        // Elide text if badge was clamped
-        QString displayName = m_badgeFM.elidedText(name, Qt::ElideRight, badgeWidth - currentPadding * 2);
-        painter->drawText(badgeRect, Qt::AlignCenter, displayName);
+        painter->drawPixmap(QPoint(x, y) + sprite->offset, sprite->pixmap);
         
         x += badgeWidth + badgeSpacing;
     }
 }
 
-void ThumbnailDelegate::paintFavoriteStar(QPainter* painter, const QRect& rect, int ratingValue) const
+void ThumbnailDelegate::paintFavoriteStar(QPainter* painter, const QRect& rect, int ratingValue,
+                                          qreal dpr) const
 {
-    int starSize = 16;
+    const int starSize = BadgeCache::StarSize;
     int margin = 4;
 
     // Position: if there's a rating, place star to the left of the rating pill
     int x;
     if (ratingValue > 0) {
-        int dotSize = 6;
-        int dotSpacing = 3;
         int ratingMargin = 5;
-        int totalDotsWidth = ratingValue * dotSize + (ratingValue - 1) * dotSpacing;
+        int totalDotsWidth = ratingValue * BadgeCache::RatingDotSize +
+                             (ratingValue - 1) * BadgeCache::RatingDotSpacing;
         int pillLeft = rect.right() - ratingMargin - totalDotsWidth - 3;
         x = pillLeft - starSize - 2;
     } else {
@@ -336,121 +292,41 @@ void ThumbnailDelegate::paintFavoriteStar(QPainter* painter, const QRect& rect,
     }
     int y = rect.top() + margin;
     
-    QPainterPath starPath;
-    QPointF center(x + starSize / 2.0, y + starSize / 2.0);
-    double outerRadius = starSize / 2.0;
-    double innerRadius = outerRadius * 0.4;
-    
-    for (int i = 0; i < 10; ++i) {
-        double angle = (i * M_PI) / 5.0;
-        double radius = (i % 2 == 0) ? outerRadius : innerRadius;
-        double px = center.x() + radius * cos(angle - M_PI / 2.0);
-        double py = center.y() + radius * sin(angle - M_PI / 2.0);
-        
-        if (i == 0) starPath.moveTo(px, py);
-        else        starPath.lineTo(px, py);
+    if (const BadgeSprite* star = m_badgeCache->favoriteStar(dpr)) {
+        painter->drawPixmap(QPoint(x, y) + star->offset, star->pixmap);
     }
-    starPath.closeSubpath();
-    
-    painter->setPen(QPen(QColor(0, 0, 0, 100), 1));
-    painter->setBrush(QColor(255, 215, 0));
-    painter->drawPath(starPath);
 }
 
-void ThumbnailDelegate::paintRating(QPainter* painter, const QRect& rect, int rating) const
+void ThumbnailDelegate::paintRating(QPainter* painter, const QRect& rect, int rating, qreal dpr) const
 {
-    // Draw small filled circles in the top-right corner representing the rating (1-5)
-    // Each dot is colored based on the overall rating level
-    static const QColor ratingColors[] = {
-        QColor(0, 0, 0, 0),     // 0 - unused
-        QColor(244, 67, 54),     // 1 - red (reject/poor)
-        QColor(255, 152, 0),     // 2 - orange (below average)
-        QColor(255, 235, 59),    // 3 - yellow (average)
-        QColor(139, 195, 74),    // 4 - light green (good)
-        QColor(76, 175, 80)      // 5 - green (excellent)
-    };
+    // Small filled circles in the top-right corner representing the rating (1-5),
+    // on a dark pill for visibility
+    const BadgeSprite* pill = m_badgeCache->ratingPill(rating, dpr);
+    if (!pill) {
+        return;
+    }
     
-    int dotSize = 6;
-    int dotSpacing = 3;
     int margin = 5;
-    
-    // Calculate total width of dots
-    int totalWidth = rating * dotSize + (rating - 1) * dotSpacing;
-    
-    // Position in top-right corner
-    int startX = rect.right() - margin - totalWidth;
-    int y = rect.top() + margin;
-    
-    QColor dotColor = ratingColors[qBound(1, rating, 5)];
-    
-    // Draw shadow/background pill behind dots for visibility
-    QRect pillRect(startX - 3, y - 2, totalWidth + 6, dotSize + 4);
-    painter->setPen(Qt::NoPen);
-    painter->setBrush(QColor(0, 0, 0, 160));
-    painter->drawRoundedRect(pillRect, (dotSize + 4) / 2.0, (dotSize + 4) / 2.0);
-    
-    // Draw the dots
-    painter->setPen(Qt::NoPen);
-    painter->setBrush(dotColor);
-    for (int i = 0; i < rating; ++i) {
-        int dotX = startX + i * (dotSize + dotSpacing);
-        painter->drawEllipse(dotX, y, dotSize, dotSize);
-    }
+    int x = rect.right() - margin - (pill->size.width() - 6) - 3;
+    int y = rect.top() + margin - 2;
+    painter->drawPixmap(QPoint(x, y) + pill->offset, pill->pixmap);
 }
 
 QRect ThumbnailDelegate::sequenceBadgeRect(const QRect& thumbRect) const
 {
     int margin = 4;
     // The entire clickable badge area in the top-left corner
-    return QRect(thumbRect.left() + margin, thumbRect.top() + margin, 68, 22);
+    return QRect(thumbRect.left() + margin, thumbRect.top() + margin,
+                 BadgeCache::SequenceBadgeWidth, BadgeCache::SequenceBadgeHeight);
 }
 
 void ThumbnailDelegate::paintSequenceBadge(QPainter* painter, const QRect& rect,
-                                            int count, bool expanded) const
+                                            int count, bool expanded, qreal dpr) const
 {
     QRect badge = sequenceBadgeRect(rect);
-
-    // Background pill
-    painter->setPen(Qt::NoPen);
-    painter->setBrush(QColor(0, 0, 0, 180));
-    painter->drawRoundedRect(badge, badge.height() / 2.0, badge.height() / 2.0);
-
-    // Stack icon (two tiny offset rectangles)
-    int iconX = badge.left() + 6;
-    int iconY = badge.top() + 4;
-    int cw = 10, ch = 8;
-    painter->setPen(QPen(QColor(180, 180, 180), 1));
-    painter->setBrush(QColor(100, 100, 100, 180));
-    painter->drawRoundedRect(iconX + 2, iconY, cw, ch, 1, 1);
-    painter->setBrush(QColor(70, 70, 70, 220));
-    painter->drawRoundedRect(iconX, iconY + 2, cw, ch, 1, 1);
-
-    // Count text
-    painter->setFont(m_badgeFont);
-    QString text = QString::number(count);
-    painter->setPen(Qt::white);
-    QRect textArea(iconX + cw + 4, badge.top(), 20, badge.height());
-    painter->drawText(textArea, Qt::AlignVCenter | Qt::AlignLeft, text);
-
-    // Chevron arrow (▼ or ▲)
-    int chevX = textArea.right() + 2;
-    int chevY = badge.top() + badge.height() / 2;
-    QPainterPath chevron;
-    if (expanded) {
-        // Up arrow ▲
-        chevron.moveTo(chevX, chevY + 2);
-        chevron.lineTo(chevX + 4, chevY - 3);
-        chevron.lineTo(chevX + 8, chevY + 2);
-    } else {
-        // Down arrow ▼
-        chevron.moveTo(chevX, chevY - 2);
-        chevron.lineTo(chevX + 4, chevY + 3);
-        chevron.lineTo(chevX + 8, chevY - 2);
+    if (const BadgeSprite* sprite = m_badgeCache->sequenceBadge(count, expanded, dpr)) {
+        painter->drawPixmap(badge.topLeft() + sprite->offset, sprite->pixmap);
     }
-    chevron.closeSubpath();
-    painter->setPen(Qt::NoPen);
-    painter->setBrush(Qt::white);
-    painter->drawPath(chevron);
 }
 
 void ThumbnailDelegate::paintHoverEffect(QPainter* painter, const QRect& rect) const
@@ -17,8 +17,12 @@
 #include <QFont>
 #include <QFontMetrics>
 
+#include "imagethumbnailmodel.h"
+
 namespace FullFrame {
 
+class BadgeCache;
+
 class ThumbnailDelegate : public QStyledItemDelegate
 {
     Q_OBJECT
@@ -57,17 +61,17 @@ private:
     void paintThumbnail(QPainter* painter, const QRect& rect,
                         const QPixmap& pixmap) const;
     void paintSelection(QPainter* painter, const QRect& rect,
-                        const QStyleOptionViewItem& option) const;
+                        const QStyleOptionViewItem& option, qreal dpr) const;
     void paintFilename(QPainter* painter, const QRect& rect,
                        const QString& filename) const;
     void paintTagIndicator(QPainter* painter, const QRect& rect,
                            bool hasTags) const;
     void paintTagBadges(QPainter* painter, const QRect& rect,
-                        const QVariantList& tags) const;
-    void paintFavoriteStar(QPainter* painter, const QRect& rect, int ratingValue = 0) const;
-    void paintRating(QPainter* painter, const QRect& rect, int rating) const;
+                        const TagBadgeList& tags, qreal dpr) const;
+    void paintFavoriteStar(QPainter* painter, const QRect& rect, int ratingValue, qreal dpr) const;
+    void paintRating(QPainter* painter, const QRect& rect, int rating, qreal dpr) const;
     void paintSequenceBadge(QPainter* painter, const QRect& rect,
-                            int count, bool expanded) const;
+                            int count, bool expanded, qreal dpr) const;
     void paintHoverEffect(QPainter* painter, const QRect& rect) const;
     QRect sequenceBadgeRect(const QRect& thumbRect) const;
 
@@ -90,6 +94,9 @@ private:
     QFont m_badgeFont;
     QFontMetrics m_filenameFM;
     QFontMetrics m_badgeFM;
+    
+    // Pre-rendered overlay sprites and elided filenames
+    BadgeCache* m_badgeCache = nullptr;
 };
 
 } // namespace FullFrame
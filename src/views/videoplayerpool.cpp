@@ -0,0 +1,196 @@
+/**
+ * VideoPlayerPool implementation
+ */
+
+#include "videoplayerpool.h"
+
+#ifdef HAVE_QT_MULTIMEDIA
+
+#include <QAudioOutput>
+#include <QMediaPlayer>
+#include <QUrl>
+#include <QVideoSink>
+#include <QVideoWidget>
+#include <cstring>
+
+namespace FullFrame {
+
+namespace {
+constexpr int FirstFrameBudgetKiB = 64 * 1024;
+constexpr int FirstFrameMaxWidth = 1920;
+
+// Frames from a hardware decoder may pin its surface pool; keep a CPU copy
+QVideoFrame cpuCopy(const QVideoFrame& source)
+{
+    QImage image = source.toImage();
+    if (image.isNull()) {
+        return QVideoFrame();
+    }
+    if (image.width() > FirstFrameMaxWidth) {
+        image = image.scaledToWidth(FirstFrameMaxWidth, Qt::SmoothTransformation);
+    }
+    image.convertTo(QImage::Format_ARGB32);
+
+    QVideoFrame frame(QVideoFrameFormat(image.size(),
+                                        QVideoFrameFormat::pixelFormatFromImageFormat(image.format())));
+    if (!frame.map(QVideoFrame::WriteOnly)) {
+        return QVideoFrame();
+    }
+    const int rowBytes = qMin(int(image.bytesPerLine()), frame.bytesPerLine(0));
+    for (int y = 0; y < image.height(); ++y) {
+        std::memcpy(frame.bits(0) + y * frame.bytesPerLine(0), image.constScanLine(y), rowBytes);
+    }
+    frame.unmap();
+    return frame;
+}
+}
+
+VideoPlayerPool::VideoPlayerPool(QVideoWidget* videoOutput, QAudioOutput* audioOutput, QObject* parent)
+    : QObject(parent)
+    , m_videoOutput(videoOutput)
+    , m_audioOutput(audioOutput)
+    , m_firstFrames(FirstFrameBudgetKiB)
+{
+    for (Slot& slot : m_slots) {
+        slot.player = new QMediaPlayer(this);
+        slot.sink = new QVideoSink(this);
+        slot.player->setVideoOutput(slot.sink);
+
+        Slot* slotPtr = &slot;
+        connect(slot.sink, &QVideoSink::videoFrameChanged, this, [this, slotPtr](const QVideoFrame& frame) {
+            if (slotPtr != m_active) {
+                rememberFirstFrame(slotPtr->filePath, frame);
+            }
+        });
+    }
+
+    // Clips opened directly on the active player
+    connect(m_videoOutput->videoSink(), &QVideoSink::videoFrameChanged, this, [this](const QVideoFrame& frame) {
+        if (m_active && m_active->player->position() < 500) {
+            rememberFirstFrame(m_active->filePath, frame);
+        }
+    });
+}
+
+VideoPlayerPool::~VideoPlayerPool()
+{
+    for (Slot& slot : m_slots) {
+        slot.player->stop();
+    }
+}
+
+QMediaPlayer* VideoPlayerPool::activePlayer() const
+{
+    return m_active ? m_active->player : nullptr;
+}
+
+QMediaPlayer* VideoPlayerPool::activate(const QString& filePath)
+{
+    Slot* slot = slotFor(filePath);
+
+    if (m_active && m_active != slot) {
+        park(m_active);
+    }
+    m_active = nullptr;
+
+    if (!slot) {
+        slot = idleSlot(QStringList());
+        open(slot, filePath);
+    }
+
+    slot->lastUsed = ++m_useCounter;
+    slot->player->setVideoOutput(m_videoOutput);
+    slot->player->setAudioOutput(m_audioOutput);
+    m_active = slot;
+
+    // Paint something the moment the clip is selected; playback replaces it
+    if (QVideoFrame* first = m_firstFrames.object(filePath)) {
+        m_videoOutput->videoSink()->setVideoFrame(*first);
+    }
+
+    return slot->player;
+}
+
+void VideoPlayerPool::deactivate()
+{
+    if (m_active) {
+        park(m_active);
+        m_active = nullptr;
+    }
+}
+
+void VideoPlayerPool::warm(const QStringList& filePaths)
+{
+    for (const QString& filePath : filePaths) {
+        if (slotFor(filePath)) {
+            continue;
+        }
+        Slot* slot = idleSlot(filePaths);
+        if (!slot) {
+            break;
+        }
+        open(slot, filePath);
+        slot->lastUsed = ++m_useCounter;
+
+        // Pausing a freshly opened source prerolls it: the demuxer and
+        // decoder are set up and the first frame lands in the slot's sink
+        slot->player->pause();
+    }
+}
+
+VideoPlayerPool::Slot* VideoPlayerPool::slotFor(const QString& filePath)
+{
+    for (Slot& slot : m_slots) {
+        if (slot.filePath == filePath) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+VideoPlayerPool::Slot* VideoPlayerPool::idleSlot(const QStringList& keep)
+{
+    Slot* best = nullptr;
+    for (Slot& slot : m_slots) {
+        if (&slot == m_active || (!slot.filePath.isEmpty() && keep.contains(slot.filePath))) {
+            continue;
+        }
+        if (!best || slot.lastUsed < best->lastUsed) {
+            best = &slot;
+        }
+    }
+    return best;
+}
+
+void VideoPlayerPool::open(Slot* slot, const QString& filePath)
+{
+    slot->player->stop();
+    slot->filePath = filePath;
+    slot->player->setSource(QUrl::fromLocalFile(filePath));
+}
+
+void VideoPlayerPool::park(Slot* slot)
+{
+    // Muted, off screen, back at the first frame: ready to be activated again
+    slot->player->pause();
+    slot->player->setPosition(0);
+    slot->player->setAudioOutput(nullptr);
+    slot->player->setVideoOutput(slot->sink);
+}
+
+void VideoPlayerPool::rememberFirstFrame(const QString& filePath, const QVideoFrame& frame)
+{
+    if (filePath.isEmpty() || !frame.isValid() || m_firstFrames.contains(filePath)) {
+        return;
+    }
+    QVideoFrame copy = cpuCopy(frame);
+    if (!copy.isValid()) {
+        return;
+    }
+    const int cost = qMax(1, copy.width() * copy.height() * 4 / 1024);
+    m_firstFrames.insert(filePath, new QVideoFrame(copy), cost);
+}
+
+} // namespace FullFrame
+
+#endif // HAVE_QT_MULTIMEDIA
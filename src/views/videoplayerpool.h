@@ -0,0 +1,85 @@
+/**
+ * VideoPlayerPool - Pre-opened media players for instant clip switching
+ *
+ * Opening a clip (demuxer, decoder, first-frame preroll) is what makes the
+ * first frame of a video show up late. The pool keeps a few QMediaPlayers:
+ * - One is active, bound to the preview's QVideoWidget and audio output
+ * - The others hold neighbouring clips, opened and paused on their first
+ *   frame into a private QVideoSink, muted
+ * - Navigating to a warm clip rebinds the outputs to its player instead of
+ *   opening a new source; the clip left behind is parked at its start, so
+ *   stepping back is just as fast
+ * - The first frame of each clip seen stays in memory and is pushed to the
+ *   video widget the moment a clip is activated
+ */
+
+#pragma once
+
+#ifdef HAVE_QT_MULTIMEDIA
+
+#include <QObject>
+#include <QCache>
+#include <QStringList>
+#include <QVideoFrame>
+
+class QAudioOutput;
+class QMediaPlayer;
+class QVideoSink;
+class QVideoWidget;
+
+namespace FullFrame {
+
+class VideoPlayerPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    // The active clip plus one warm neighbour on each side
+    static constexpr int PoolSize = 3;
+
+    VideoPlayerPool(QVideoWidget* videoOutput, QAudioOutput* audioOutput, QObject* parent = nullptr);
+    ~VideoPlayerPool() override;
+
+    // Bind filePath's player to the outputs (opening it if no warm player
+    // has it) and return it. The previously active player is parked.
+    QMediaPlayer* activate(const QString& filePath);
+
+    // Park the active player and leave the outputs unbound
+    void deactivate();
+
+    // Open these clips on idle players, paused on their first frame.
+    // Players holding other clips are reused least recently used first.
+    void warm(const QStringList& filePaths);
+
+    QMediaPlayer* activePlayer() const;
+
+private:
+    struct Slot
+    {
+        QMediaPlayer* player = nullptr;
+        QVideoSink* sink = nullptr;   // Output while not active
+        QString filePath;
+        qint64 lastUsed = 0;
+    };
+
+    Slot* slotFor(const QString& filePath);
+    Slot* idleSlot(const QStringList& keep);
+    void open(Slot* slot, const QString& filePath);
+    void park(Slot* slot);
+    void rememberFirstFrame(const QString& filePath, const QVideoFrame& frame);
+
+private:
+    QVideoWidget* m_videoOutput;
+    QAudioOutput* m_audioOutput;
+
+    Slot m_slots[PoolSize];
+    Slot* m_active = nullptr;
+    qint64 m_useCounter = 0;
+
+    // First frame of recently opened clips
+    QCache<QString, QVideoFrame> m_firstFrames;
+};
+
+} // namespace FullFrame
+
+#endif // HAVE_QT_MULTIMEDIA
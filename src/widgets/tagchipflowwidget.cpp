@@ -0,0 +1,270 @@
+/**
+ * TagChipFlowWidget implementation
+ */
+
+#include "tagchipflowwidget.h"
+#include "tagmanager.h"
+
+#include <QFontMetrics>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+
+namespace FullFrame {
+
+namespace {
+constexpr int ChipHeight = 18;
+constexpr int SupertagChipHeight = 24;
+constexpr int ChipPadding = 6;
+constexpr int SupertagChipPadding = 8;
+constexpr int ChipSpacing = 3;
+constexpr int ChipRadius = 3;
+constexpr int ShadowOffset = 2;
+}
+
+TagChipFlowWidget::TagChipFlowWidget(QWidget* parent)
+    : QWidget(parent)
+{
+    setMouseTracking(true);
+
+    QSizePolicy policy(QSizePolicy::Expanding, QSizePolicy::Minimum);
+    policy.setHeightForWidth(true);
+    setSizePolicy(policy);
+
+    m_tagFont.setPointSize(8);
+    m_tagFont.setBold(true);
+    m_supertagFont.setPointSize(9);
+    m_supertagFont.setBold(true);
+}
+
+void TagChipFlowWidget::setTags(const QList<Tag>& tags)
+{
+    // Navigating between images with the same tags is common; keep the layout
+    bool same = tags.size() == m_chips.size();
+    for (int i = 0; same && i < tags.size(); ++i) {
+        const Chip& chip = m_chips[i];
+        same = chip.tagId == tags[i].id && chip.isSupertag == tags[i].isSupertag
+            && chip.background == QColor(tags[i].color)
+            && chip.name == tags[i].name;
+    }
+    if (same) {
+        return;
+    }
+
+    m_chips.resize(tags.size());
+    for (int i = 0; i < tags.size(); ++i) {
+        const Tag& tag = tags[i];
+        Chip& chip = m_chips[i];
+        chip.tagId = tag.id;
+        chip.name = tag.name;
+        chip.label = tag.name + QStringLiteral(" ×");
+        chip.background = QColor(tag.color);
+        chip.foreground = (chip.background.lightness() > 128) ? QColor(20, 20, 20) : QColor(255, 255, 255);
+        chip.isSupertag = tag.isSupertag;
+        chip.width = textWidth(chip.label, chip.isSupertag)
+                   + 2 * (chip.isSupertag ? SupertagChipPadding : ChipPadding);
+    }
+
+    m_hovered = -1;
+    unsetCursor();
+    relayout();
+}
+
+void TagChipFlowWidget::clear()
+{
+    setTags(QList<Tag>());
+}
+
+int TagChipFlowWidget::textWidth(const QString& label, bool isSupertag)
+{
+    QHash<QString, int>& widths = isSupertag ? m_supertagTextWidths : m_tagTextWidths;
+    auto it = widths.constFind(label);
+    if (it != widths.constEnd()) {
+        return it.value();
+    }
+    const int width = QFontMetrics(isSupertag ? m_supertagFont : m_tagFont).horizontalAdvance(label);
+    widths.insert(label, width);
+    return width;
+}
+
+int TagChipFlowWidget::layoutChips(int width, QVector<QRect>* rects) const
+{
+    if (m_chips.isEmpty()) {
+        return 0;
+    }
+
+    // Chips are bottom-aligned within a row so mixed heights share a baseline
+    int x = 0;
+    int y = 0;
+    int rowHeight = 0;
+    int rowStart = 0;
+
+    auto finishRow = [&](int end) {
+        if (rects) {
+            for (int i = rowStart; i < end; ++i) {
+                QRect& rect = (*rects)[i];
+                rect.moveTop(y + rowHeight - rect.height());
+            }
+        }
+        y += rowHeight + ChipSpacing;
+    };
+
+    for (int i = 0; i < m_chips.size(); ++i) {
+        const Chip& chip = m_chips[i];
+        const int chipHeight = chip.isSupertag ? SupertagChipHeight : ChipHeight;
+        const int chipWidth = qMin(chip.width, qMax(1, width - ShadowOffset));
+
+        if (x > 0 && x + chipWidth + ShadowOffset > width) {
+            finishRow(i);
+            x = 0;
+            rowHeight = 0;
+            rowStart = i;
+        }
+        if (rects) {
+            (*rects)[i] = QRect(x, 0, chipWidth, chipHeight);
+        }
+        x += chipWidth + ChipSpacing;
+        rowHeight = qMax(rowHeight, chipHeight);
+    }
+    finishRow(m_chips.size());
+
+    return y - ChipSpacing + ShadowOffset;
+}
+
+void TagChipFlowWidget::relayout()
+{
+    QVector<QRect> rects(m_chips.size());
+    layoutChips(width(), &rects);
+    for (int i = 0; i < m_chips.size(); ++i) {
+        m_chips[i].rect = rects[i];
+    }
+    m_layoutWidth = width();
+
+    updateGeometry();
+    update();
+}
+
+int TagChipFlowWidget::heightForWidth(int width) const
+{
+    return layoutChips(width, nullptr);
+}
+
+QSize TagChipFlowWidget::sizeHint() const
+{
+    const int w = width() > 0 ? width() : 250;
+    return QSize(w, heightForWidth(w));
+}
+
+QSize TagChipFlowWidget::minimumSizeHint() const
+{
+    return QSize(0, heightForWidth(width() > 0 ? width() : 250));
+}
+
+void TagChipFlowWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    if (width() != m_layoutWidth) {
+        relayout();
+    }
+}
+
+void TagChipFlowWidget::paintEvent(QPaintEvent* event)
+{
+    if (m_chips.isEmpty()) {
+        return;
+    }
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+
+    for (int i = 0; i < m_chips.size(); ++i) {
+        const Chip& chip = m_chips[i];
+        if (!chip.rect.adjusted(0, 0, ShadowOffset, ShadowOffset).intersects(event->rect())) {
+            continue;
+        }
+
+        if (chip.isSupertag) {
+            // Soft offset shadow, two passes stand in for a blur
+            painter.setBrush(QColor(0, 0, 0, 50));
+            painter.drawRoundedRect(chip.rect.translated(ShadowOffset, ShadowOffset), ChipRadius + 1, ChipRadius + 1);
+            painter.setBrush(QColor(0, 0, 0, 60));
+            painter.drawRoundedRect(QRectF(chip.rect).translated(1, 1), ChipRadius, ChipRadius);
+        }
+
+        painter.setBrush(i == m_hovered ? chip.background.darker(115) : chip.background);
+        painter.drawRoundedRect(chip.rect, ChipRadius, ChipRadius);
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    for (const Chip& chip : m_chips) {
+        if (!chip.rect.intersects(event->rect())) {
+            continue;
+        }
+        const int padding = chip.isSupertag ? SupertagChipPadding : ChipPadding;
+        const QRect textRect = chip.rect.adjusted(padding, 0, -padding, 0);
+
+        painter.setFont(chip.isSupertag ? m_supertagFont : m_tagFont);
+        painter.setPen(chip.foreground);
+        if (textRect.width() < chip.width - 2 * padding) {
+            const QFontMetrics fm(painter.font());
+            painter.drawText(textRect, Qt::AlignCenter, fm.elidedText(chip.label, Qt::ElideMiddle, textRect.width()));
+        } else {
+            painter.drawText(textRect, Qt::AlignCenter, chip.label);
+        }
+    }
+}
+
+int TagChipFlowWidget::chipAt(const QPoint& pos) const
+{
+    for (int i = 0; i < m_chips.size(); ++i) {
+        if (m_chips[i].rect.contains(pos)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void TagChipFlowWidget::setHovered(int index)
+{
+    if (index == m_hovered) {
+        return;
+    }
+    if (m_hovered >= 0 && m_hovered < m_chips.size()) {
+        update(m_chips[m_hovered].rect);
+    }
+    m_hovered = index;
+    if (m_hovered >= 0) {
+        update(m_chips[m_hovered].rect);
+        setCursor(Qt::PointingHandCursor);
+    } else {
+        unsetCursor();
+    }
+}
+
+void TagChipFlowWidget::mouseMoveEvent(QMouseEvent* event)
+{
+    setHovered(chipAt(event->position().toPoint()));
+    QWidget::mouseMoveEvent(event);
+}
+
+void TagChipFlowWidget::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() == Qt::LeftButton) {
+        const int index = chipAt(event->position().toPoint());
+        if (index >= 0) {
+            Q_EMIT tagClicked(m_chips[index].tagId);
+            event->accept();
+            return;
+        }
+    }
+    QWidget::mousePressEvent(event);
+}
+
+void TagChipFlowWidget::leaveEvent(QEvent* event)
+{
+    setHovered(-1);
+    QWidget::leaveEvent(event);
+}
+
+} // namespace FullFrame
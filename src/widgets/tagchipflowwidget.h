@@ -0,0 +1,83 @@
+/**
+ * TagChipFlowWidget - Painted, wrapping row of tag chips
+ *
+ * Draws the tags of the current image as coloured chips that wrap to the
+ * widget width, all in one paintEvent. Switching images only replaces the
+ * chip data; no child widgets are created or destroyed, and the text width
+ * of every label is measured once and remembered.
+ */
+
+#pragma once
+
+#include <QWidget>
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QList>
+#include <QRect>
+#include <QVector>
+
+namespace FullFrame {
+
+struct Tag;
+
+class TagChipFlowWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TagChipFlowWidget(QWidget* parent = nullptr);
+
+    // Replace the chips; unchanged tag lists are a no-op
+    void setTags(const QList<Tag>& tags);
+    void clear();
+
+    bool isEmpty() const { return m_chips.isEmpty(); }
+
+    bool hasHeightForWidth() const override { return true; }
+    int heightForWidth(int width) const override;
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+Q_SIGNALS:
+    void tagClicked(qint64 tagId);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void leaveEvent(QEvent* event) override;
+
+private:
+    struct Chip
+    {
+        qint64 tagId = -1;
+        QString name;
+        QString label;      // "name ×"
+        QColor background;
+        QColor foreground;
+        bool isSupertag = false;
+        int width = 0;
+        QRect rect;         // Laid out for the current width
+    };
+
+    int textWidth(const QString& label, bool isSupertag);
+    // Height of the chips wrapped to width; fills rects when given
+    int layoutChips(int width, QVector<QRect>* rects) const;
+    void relayout();
+    int chipAt(const QPoint& pos) const;
+    void setHovered(int index);
+
+private:
+    QVector<Chip> m_chips;
+    int m_layoutWidth = -1;
+    int m_hovered = -1;
+
+    QFont m_tagFont;
+    QFont m_supertagFont;
+    QHash<QString, int> m_tagTextWidths;
+    QHash<QString, int> m_supertagTextWidths;
+};
+
+} // namespace FullFrame
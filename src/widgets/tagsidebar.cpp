@@ -4,6 +4,8 @@
 
 #include "tagsidebar.h"
 #include "tagmanager.h"
+#include "tagsidebarmodel.h"
+#include "hotkeylatency.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -13,121 +15,117 @@
 #include <QPainter>
 #include <QPainterPath>
 #include <QMouseEvent>
-#include <QContextMenuEvent>
+#include <QStyle>
 #include <QMenu>
 #include <QInputDialog>
 #include <QApplication>
-#include <QScrollBar>
 #include <QTimer>
 #include <QFileDialog>
-#include <algorithm>
 
 namespace FullFrame {
 
-// ============== TagCard Implementation ==============
+// ============== TagCardDelegate Implementation ==============
 
-TagCard::TagCard(const Tag& tag, QWidget* parent)
-    : QWidget(parent)
-    , m_tagId(tag.id)
-    , m_name(tag.name)
-    , m_hotkey(tag.hotkey)
-    , m_color(tag.color.isEmpty() ? QColor(100, 100, 100) : QColor(tag.color))
-    , m_isAlbumTag(tag.isAlbumTag())
-{
-    setFixedHeight(32);  // Compact height
-    setCursor(Qt::PointingHandCursor);
-    setMouseTracking(true);
-}
-
-void TagCard::setSelected(bool selected)
-{
-    if (m_selected != selected) {
-        m_selected = selected;
-        update();
-    }
-}
-
-void TagCard::setHotkey(const QString& hotkey)
-{
-    m_hotkey = hotkey;
-    update();
-}
-
-void TagCard::setAwaitingHotkey(bool awaiting)
+TagCardDelegate::TagCardDelegate(bool showCounts, QObject* parent)
+    : QStyledItemDelegate(parent)
+    , m_showCounts(showCounts)
 {
-    m_awaitingHotkey = awaiting;
-    update();
 }
 
-void TagCard::setAlbumTag(bool isAlbum)
+QRect TagCardDelegate::cardRect(const QRect& rowRect, bool indented)
 {
-    m_isAlbumTag = isAlbum;
-    update();
+    const int indent = indented ? 16 : 0;
+    return rowRect.adjusted(2 + indent, 2, -2, -2);
 }
 
-void TagCard::setGroupParent(bool isGroup)
+QRect TagCardDelegate::expandRect(const QRect& card)
 {
-    m_isGroupParent = isGroup;
-    update();
+    const int triSize = 8;
+    const int triX = card.left() + 4;
+    const int triY = card.top() + (card.height() - triSize) / 2;
+    return QRect(triX - 2, triY - 2, triSize + 4, triSize + 4);
 }
 
-void TagCard::setExpanded(bool expanded)
+QRect TagCardDelegate::hotkeyRect(const QRect& card)
 {
-    m_expanded = expanded;
-    update();
+    const int badgeW = 20;
+    const int badgeH = 18;
+    const int badgeMargin = 6;
+    return QRect(card.right() - badgeW - badgeMargin,
+                 card.top() + (card.height() - badgeH) / 2,
+                 badgeW, badgeH);
 }
 
-void TagCard::setIndented(bool indented)
+QRect TagCardDelegate::deleteRect(const QRect& card)
 {
-    m_indented = indented;
-    update();
+    const QRect hotkey = hotkeyRect(card);
+    return QRect(hotkey.left() - 18, hotkey.top(), 16, hotkey.height());
 }
 
-void TagCard::setCount(int count)
+QSize TagCardDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
 {
-    m_count = count;
-    update();
+    Q_UNUSED(index)
+    return QSize(option.rect.width(), RowHeight);
 }
 
-void TagCard::paintEvent(QPaintEvent* event)
+void TagCardDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
+                            const QModelIndex& index) const
 {
-    Q_UNUSED(event)
-    
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
-    
-    int indent = m_indented ? 16 : 0;
-    QRect r = rect().adjusted(2 + indent, 2, -2, -2);
+    const QString name = index.data(Qt::DisplayRole).toString();
+    const QString hotkey = index.data(TagSidebarModel::HotkeyRole).toString();
+    const QColor color = index.data(TagSidebarModel::TagColorRole).value<QColor>();
+    const bool selected = index.data(TagSidebarModel::IsFilterSelectedRole).toBool();
+    const bool awaitingHotkey = index.data(TagSidebarModel::AwaitingHotkeyRole).toBool();
+    const bool isAlbumTag = index.data(TagSidebarModel::IsAlbumTagRole).toBool();
+    const bool isGroupParent = index.data(TagSidebarModel::IsGroupParentRole).toBool();
+    const bool expanded = index.data(TagSidebarModel::IsExpandedRole).toBool();
+    const bool indented = index.data(TagSidebarModel::IsIndentedRole).toBool();
+    const auto selectionState = Qt::CheckState(index.data(TagSidebarModel::SelectionStateRole).toInt());
+    const bool hovered = option.state & QStyle::State_MouseOver;
+    const int count = m_showCounts ? index.data(TagSidebarModel::CountRole).toInt() : -1;
+    
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    
+    const QRect r = cardRect(option.rect, indented);
     
     // Background
-    QColor bgColor = m_selected ? QColor(0, 120, 215, 50) : 
-                     m_hovered ? QColor(255, 255, 255, 12) : 
+    QColor bgColor = selected ? QColor(0, 120, 215, 50) : 
+                     hovered ? QColor(255, 255, 255, 12) : 
                      QColor(40, 40, 40);
     
     QPainterPath path;
     path.addRoundedRect(r, 4, 4);
-    painter.fillPath(path, bgColor);
+    painter->fillPath(path, bgColor);
     
     // Selection/hover border
-    if (m_selected) {
-        painter.setPen(QPen(QColor(0, 120, 215), 1.5));
-        painter.drawRoundedRect(r, 4, 4);
-    } else if (m_hovered) {
-        painter.setPen(QPen(QColor(70, 70, 70), 1));
-        painter.drawRoundedRect(r, 4, 4);
+    if (selected) {
+        painter->setPen(QPen(QColor(0, 120, 215), 1.5));
+        painter->drawRoundedRect(r, 4, 4);
+    } else if (hovered) {
+        painter->setPen(QPen(QColor(70, 70, 70), 1));
+        painter->drawRoundedRect(r, 4, 4);
+    }
+    
+    // Applied to all (full bar) or some (short bar) of the selected images
+    if (selectionState != Qt::Unchecked) {
+        const int barHeight = selectionState == Qt::Checked ? r.height() - 8 : (r.height() - 8) / 2;
+        QRect bar(r.left() + 1, r.top() + (r.height() - barHeight) / 2, 3, barHeight);
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(selectionState == Qt::Checked ? QColor(76, 175, 80) : QColor(76, 175, 80, 140));
+        painter->drawRoundedRect(bar, 1.5, 1.5);
     }
     
     int contentLeft = r.left();
     
     // Expand/collapse triangle for group parents
-    if (m_isGroupParent) {
+    if (isGroupParent) {
         int triSize = 8;
         int triX = r.left() + 4;
         int triY = r.top() + (r.height() - triSize) / 2;
-        m_expandRect = QRect(triX - 2, triY - 2, triSize + 4, triSize + 4);
         
         QPainterPath triPath;
-        if (m_expanded) {
+        if (expanded) {
             // Down-pointing triangle
             triPath.moveTo(triX, triY);
             triPath.lineTo(triX + triSize, triY);
@@ -140,174 +138,130 @@ void TagCard::paintEvent(QPaintEvent* event)
         }
         triPath.closeSubpath();
         
-        painter.setPen(Qt::NoPen);
-        painter.setBrush(QColor(160, 160, 160));
-        painter.drawPath(triPath);
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(QColor(160, 160, 160));
+        painter->drawPath(triPath);
         
         contentLeft = r.left() + triSize + 6;
-    } else {
-        m_expandRect = QRect();
     }
     
     // Color dot or folder icon
     int dotSize = 8;
     int dotY = r.top() + (r.height() - dotSize) / 2;
-    painter.setPen(Qt::NoPen);
-    painter.setBrush(m_color);
-    if (m_isAlbumTag) {
-        QFont iconFont = painter.font();
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(color);
+    if (isAlbumTag) {
+        QFont iconFont = option.font;
         iconFont.setPixelSize(12);
-        painter.setFont(iconFont);
-        painter.setPen(m_color);
-        painter.drawText(QRect(contentLeft + 3, r.top(), 16, r.height()), Qt::AlignCenter, QString::fromUtf8("\xF0\x9F\x93\x81"));
+        painter->setFont(iconFont);
+        painter->setPen(color);
+        painter->drawText(QRect(contentLeft + 3, r.top(), 16, r.height()), Qt::AlignCenter, QString::fromUtf8("\xF0\x9F\x93\x81"));
     } else {
-        painter.drawEllipse(contentLeft + 6, dotY, dotSize, dotSize);
+        painter->drawEllipse(contentLeft + 6, dotY, dotSize, dotSize);
     }
     
     int dotAreaWidth = 20;
     
     // Hotkey badge (right side)
-    int badgeW = 20;
-    int badgeH = 18;
-    int badgeMargin = 6;
-    m_hotkeyRect = QRect(r.right() - badgeW - badgeMargin, 
-                         r.top() + (r.height() - badgeH) / 2,
-                         badgeW, badgeH);
-    
-    if (m_awaitingHotkey) {
-        painter.setPen(QPen(QColor(255, 193, 7), 1.5));
-        painter.setBrush(QColor(255, 193, 7, 30));
-        painter.drawRoundedRect(m_hotkeyRect, 3, 3);
+    const QRect badgeRect = hotkeyRect(r);
+    QFont badgeFont = option.font;
+    badgeFont.setPixelSize(10);
+    badgeFont.setBold(true);
+    
+    if (awaitingHotkey) {
+        painter->setPen(QPen(QColor(255, 193, 7), 1.5));
+        painter->setBrush(QColor(255, 193, 7, 30));
+        painter->drawRoundedRect(badgeRect, 3, 3);
         
-        painter.setPen(QColor(255, 193, 7));
-        QFont font = painter.font();
-        font.setPixelSize(10);
-        font.setBold(true);
-        painter.setFont(font);
-        painter.drawText(m_hotkeyRect, Qt::AlignCenter, "?");
-    } else if (!m_hotkey.isEmpty()) {
-        painter.setPen(Qt::NoPen);
-        painter.setBrush(QColor(76, 175, 80));
-        painter.drawRoundedRect(m_hotkeyRect, 3, 3);
+        painter->setPen(QColor(255, 193, 7));
+        painter->setFont(badgeFont);
+        painter->drawText(badgeRect, Qt::AlignCenter, "?");
+    } else if (!hotkey.isEmpty()) {
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(QColor(76, 175, 80));
+        painter->drawRoundedRect(badgeRect, 3, 3);
         
-        painter.setPen(Qt::white);
-        QFont font = painter.font();
-        font.setPixelSize(10);
-        font.setBold(true);
-        painter.setFont(font);
-        painter.drawText(m_hotkeyRect, Qt::AlignCenter, m_hotkey.toUpper());
+        painter->setPen(Qt::white);
+        painter->setFont(badgeFont);
+        painter->drawText(badgeRect, Qt::AlignCenter, hotkey.toUpper());
     } else {
-        painter.setPen(QPen(QColor(80, 80, 80), 1, Qt::DotLine));
-        painter.setBrush(Qt::NoBrush);
-        painter.drawRoundedRect(m_hotkeyRect, 3, 3);
+        painter->setPen(QPen(QColor(80, 80, 80), 1, Qt::DotLine));
+        painter->setBrush(Qt::NoBrush);
+        painter->drawRoundedRect(badgeRect, 3, 3);
     }
     
     // Delete button (only on hover)
-    if (m_hovered) {
-        m_deleteRect = QRect(m_hotkeyRect.left() - 18, m_hotkeyRect.top(), 16, badgeH);
-        painter.setPen(QColor(160, 70, 70));
-        QFont font = painter.font();
+    if (hovered) {
+        painter->setPen(QColor(160, 70, 70));
+        QFont font = option.font;
         font.setPixelSize(12);
-        painter.setFont(font);
-        painter.drawText(m_deleteRect, Qt::AlignCenter, "×");
-    } else {
-        m_deleteRect = QRect();
+        painter->setFont(font);
+        painter->drawText(deleteRect(r), Qt::AlignCenter, "×");
     }
     
     // Tag name (with optional count)
     int textLeft = contentLeft + dotAreaWidth;
-    int textRight = m_hovered ? m_deleteRect.left() - 4 : m_hotkeyRect.left() - 4;
+    int textRight = hovered ? deleteRect(r).left() - 4 : badgeRect.left() - 4;
     QRect textRect(textLeft, r.top(), textRight - textLeft, r.height());
     
-    QFont font = painter.font();
+    QFont font = option.font;
     font.setPixelSize(11);
     font.setBold(false);
-    painter.setFont(font);
+    painter->setFont(font);
     QFontMetrics fm(font);
     
-    if (m_count >= 0) {
-        QString countStr = QString(" (%1)").arg(m_count);
+    if (count >= 0) {
+        QString countStr = QString(" (%1)").arg(count);
         int countWidth = fm.horizontalAdvance(countStr);
         int nameAvail = textRect.width() - countWidth;
-        QString elidedName = fm.elidedText(m_name, Qt::ElideRight, qMax(nameAvail, 20));
+        QString elidedName = fm.elidedText(name, Qt::ElideRight, qMax(nameAvail, 20));
         
-        painter.setPen(m_indented ? QColor(170, 170, 170) : QColor(200, 200, 200));
-        painter.drawText(textRect, Qt::AlignVCenter | Qt::AlignLeft, elidedName);
+        painter->setPen(indented ? QColor(170, 170, 170) : QColor(200, 200, 200));
+        painter->drawText(textRect, Qt::AlignVCenter | Qt::AlignLeft, elidedName);
         
         int nameDrawn = fm.horizontalAdvance(elidedName);
         QRect countRect(textLeft + nameDrawn, r.top(), countWidth, r.height());
-        painter.setPen(QColor(120, 120, 120));
-        painter.drawText(countRect, Qt::AlignVCenter | Qt::AlignLeft, countStr);
+        painter->setPen(QColor(120, 120, 120));
+        painter->drawText(countRect, Qt::AlignVCenter | Qt::AlignLeft, countStr);
     } else {
-        QString elidedText = fm.elidedText(m_name, Qt::ElideRight, textRect.width());
-        painter.setPen(m_indented ? QColor(170, 170, 170) : QColor(200, 200, 200));
-        painter.drawText(textRect, Qt::AlignVCenter | Qt::AlignLeft, elidedText);
-    }
-}
-
-void TagCard::mousePressEvent(QMouseEvent* event)
-{
-    if (event->button() == Qt::LeftButton) {
-        if (m_isGroupParent && m_expandRect.isValid() && m_expandRect.contains(event->pos())) {
-            Q_EMIT expandToggled(m_tagId);
-        } else if (m_hotkeyRect.contains(event->pos())) {
-            Q_EMIT hotkeyClicked(m_tagId);
-        } else if (m_deleteRect.isValid() && m_deleteRect.contains(event->pos())) {
-            Q_EMIT deleteRequested(m_tagId);
-        } else {
-            Q_EMIT clicked(m_tagId);
-        }
+        QString elidedText = fm.elidedText(name, Qt::ElideRight, textRect.width());
+        painter->setPen(indented ? QColor(170, 170, 170) : QColor(200, 200, 200));
+        painter->drawText(textRect, Qt::AlignVCenter | Qt::AlignLeft, elidedText);
     }
+    
+    painter->restore();
 }
 
-void TagCard::contextMenuEvent(QContextMenuEvent* event)
+bool TagCardDelegate::editorEvent(QEvent* event, QAbstractItemModel* model,
+                                  const QStyleOptionViewItem& option, const QModelIndex& index)
 {
-    QMenu menu(this);
+    Q_UNUSED(model)
     
-    QAction* renameAction = menu.addAction("Rename");
-    
-    QAction* supertagAction = menu.addAction("Toggle Supertag on Selection");
-    
-    menu.addSeparator();
-    
-    QAction* linkAction = nullptr;
-    QAction* unlinkAction = nullptr;
-    if (m_isAlbumTag) {
-        unlinkAction = menu.addAction("Unlink from Folder");
-    } else {
-        linkAction = menu.addAction("Link to Folder...");
+    if (event->type() == QEvent::MouseButtonDblClick) {
+        return true;  // Don't let the view treat it as activation
+    }
+    if (event->type() != QEvent::MouseButtonPress) {
+        return false;
+    }
+    QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+    if (mouseEvent->button() != Qt::LeftButton) {
+        return false;
     }
     
-    menu.addSeparator();
-    
-    QAction* deleteAction = menu.addAction("Delete");
+    const qint64 tagId = index.data(TagSidebarModel::TagIdRole).toLongLong();
+    const QRect card = cardRect(option.rect, index.data(TagSidebarModel::IsIndentedRole).toBool());
+    const QPoint pos = mouseEvent->position().toPoint();
     
-    QAction* chosen = menu.exec(event->globalPos());
-    if (chosen == renameAction) {
-        Q_EMIT renameRequested(m_tagId);
-    } else if (chosen == supertagAction) {
-        Q_EMIT supertagToggleRequested(m_tagId);
-    } else if (chosen == deleteAction) {
-        Q_EMIT deleteRequested(m_tagId);
-    } else if (linkAction && chosen == linkAction) {
-        Q_EMIT linkToFolderRequested(m_tagId);
-    } else if (unlinkAction && chosen == unlinkAction) {
-        Q_EMIT unlinkFromFolderRequested(m_tagId);
+    if (index.data(TagSidebarModel::IsGroupParentRole).toBool() && expandRect(card).contains(pos)) {
+        Q_EMIT expandToggled(tagId);
+    } else if (hotkeyRect(card).contains(pos)) {
+        Q_EMIT hotkeyClicked(tagId);
+    } else if (deleteRect(card).contains(pos)) {
+        Q_EMIT deleteRequested(tagId);
+    } else {
+        Q_EMIT clicked(tagId);
     }
-}
-
-void TagCard::enterEvent(QEnterEvent* event)
-{
-    Q_UNUSED(event)
-    m_hovered = true;
-    update();
-}
-
-void TagCard::leaveEvent(QEvent* event)
-{
-    Q_UNUSED(event)
-    m_hovered = false;
-    update();
+    return true;
 }
 
 // ============== TagSidebar Implementation ==============
@@ -385,9 +339,7 @@ void TagSidebar::setupUI()
         // Clear tag filter when showing untagged
         if (checked) {
             m_selectedTags.clear();
-            for (TagCard* card : m_tagCards) {
-                card->setSelected(false);
-            }
+            m_model->clearFilterSelection();
         }
         Q_EMIT showUntaggedChanged(checked);
     });
@@ -445,29 +397,9 @@ void TagSidebar::setupUI()
     connect(m_searchEdit, &QLineEdit::textChanged, this, &TagSidebar::filterTagCards);
     layout->addWidget(m_searchEdit);
 
-    QString scrollAreaStyle = R"(
-        QScrollArea {
-            background-color: transparent;
-            border: none;
-        }
-        QScrollBar:vertical {
-            background: #2d2d2d;
-            width: 8px;
-            margin: 0;
-            border-radius: 4px;
-        }
-        QScrollBar::handle:vertical {
-            background: #505050;
-            border-radius: 4px;
-            min-height: 20px;
-        }
-        QScrollBar::handle:vertical:hover {
-            background: #606060;
-        }
-        QScrollBar::add-line:vertical, QScrollBar::sub-line:vertical {
-            height: 0;
-        }
-    )";
+    m_model = new TagSidebarModel(this);
+    m_recentProxy = new TagSidebarProxyModel(m_model, TagSidebarProxyModel::RecentFirst, this);
+    m_popularProxy = new TagSidebarProxyModel(m_model, TagSidebarProxyModel::PopularFirst, this);
 
     QString sectionLabelStyle = "font-size: 9px; font-weight: bold; color: #606060; "
                                 "letter-spacing: 1px; padding: 2px 0;";
@@ -477,21 +409,8 @@ void TagSidebar::setupUI()
     recentLabel->setStyleSheet(sectionLabelStyle);
     layout->addWidget(recentLabel);
 
-    m_recentScrollArea = new QScrollArea(this);
-    m_recentScrollArea->setWidgetResizable(true);
-    m_recentScrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    m_recentScrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-    m_recentScrollArea->setStyleSheet(scrollAreaStyle);
-
-    m_recentContainer = new QWidget();
-    m_recentContainer->setStyleSheet("background-color: transparent;");
-    m_recentLayout = new QVBoxLayout(m_recentContainer);
-    m_recentLayout->setContentsMargins(0, 0, 0, 0);
-    m_recentLayout->setSpacing(2);
-    m_recentLayout->addStretch();
-
-    m_recentScrollArea->setWidget(m_recentContainer);
-    layout->addWidget(m_recentScrollArea, 1);
+    m_recentView = createSectionView(m_recentProxy, new TagCardDelegate(false, this));
+    layout->addWidget(m_recentView, 1);
 
     // === Divider ===
     QFrame* sectionDivider = new QFrame(this);
@@ -504,21 +423,8 @@ void TagSidebar::setupUI()
     popularLabel->setStyleSheet(sectionLabelStyle);
     layout->addWidget(popularLabel);
 
-    m_popularScrollArea = new QScrollArea(this);
-    m_popularScrollArea->setWidgetResizable(true);
-    m_popularScrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    m_popularScrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-    m_popularScrollArea->setStyleSheet(scrollAreaStyle);
-
-    m_popularContainer = new QWidget();
-    m_popularContainer->setStyleSheet("background-color: transparent;");
-    m_popularLayout = new QVBoxLayout(m_popularContainer);
-    m_popularLayout->setContentsMargins(0, 0, 0, 0);
-    m_popularLayout->setSpacing(2);
-    m_popularLayout->addStretch();
-
-    m_popularScrollArea->setWidget(m_popularContainer);
-    layout->addWidget(m_popularScrollArea, 1);
+    m_popularView = createSectionView(m_popularProxy, new TagCardDelegate(true, this));
+    layout->addWidget(m_popularView, 1);
 
     // Status label for hotkey assignment
     m_statusLabel = new QLabel("", this);
@@ -613,211 +519,112 @@ void TagSidebar::refresh()
 
 void TagSidebar::loadTags()
 {
-    updateTagCards();
-}
-
-TagCard* TagSidebar::createAndConnectCard(const Tag& tag, QWidget* parent)
-{
-    TagCard* card = new TagCard(tag, parent);
-    connect(card, &TagCard::clicked, this, &TagSidebar::onTagCardClicked);
-    connect(card, &TagCard::hotkeyClicked, this, &TagSidebar::onHotkeyClicked);
-    connect(card, &TagCard::deleteRequested, this, &TagSidebar::onDeleteRequested);
-    connect(card, &TagCard::renameRequested, this, &TagSidebar::onRenameRequested);
-    connect(card, &TagCard::linkToFolderRequested, this, &TagSidebar::onLinkToFolderRequested);
-    connect(card, &TagCard::unlinkFromFolderRequested, this, &TagSidebar::onUnlinkFromFolderRequested);
-    connect(card, &TagCard::expandToggled, this, &TagSidebar::onExpandToggled);
-    connect(card, &TagCard::supertagToggleRequested, this, &TagSidebar::onSupertagToggleRequested);
-    
-    card->setSelected(m_selectedTags.contains(tag.id));
-    if (m_awaitingHotkeyTagId == tag.id) {
-        card->setAwaitingHotkey(true);
-    }
-    return card;
+    // Only rows that changed are touched; both sections re-sort from the model
+    m_model->reload(m_currentDirPaths);
 }
 
-void TagSidebar::populateSection(QVBoxLayout* layout, const QList<Tag>& rootTags,
-                                 const QHash<qint64, QList<Tag>>& childMap,
-                                 const QHash<qint64, int>& counts)
+QListView* TagSidebar::createSectionView(TagSidebarProxyModel* proxy, TagCardDelegate* delegate)
 {
-    QWidget* container = qobject_cast<QWidget*>(layout->parentWidget());
-    bool showCounts = !counts.isEmpty();
-    
-    for (const Tag& tag : rootTags) {
-        bool hasChildren = childMap.contains(tag.id);
-        
-        TagCard* card = createAndConnectCard(tag, container);
-        if (hasChildren) {
-            card->setGroupParent(true);
-            card->setExpanded(m_expandedGroups.contains(tag.id));
+    QListView* view = new QListView(this);
+    view->setModel(proxy);
+    view->setItemDelegate(delegate);
+    view->setUniformItemSizes(true);
+    view->setSpacing(1);
+    view->setSelectionMode(QAbstractItemView::NoSelection);
+    view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    view->setFocusPolicy(Qt::NoFocus);
+    view->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    view->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    view->setMouseTracking(true);
+    view->viewport()->setAttribute(Qt::WA_Hover);
+    view->viewport()->setCursor(Qt::PointingHandCursor);
+    view->setContextMenuPolicy(Qt::CustomContextMenu);
+    view->setStyleSheet(R"(
+        QListView {
+            background-color: transparent;
+            border: none;
         }
-        if (showCounts)
-            card->setCount(counts.value(tag.id, 0));
-        layout->addWidget(card);
-        m_tagCards.append(card);
-        
-        if (hasChildren && m_expandedGroups.contains(tag.id)) {
-            for (const Tag& child : childMap.value(tag.id)) {
-                TagCard* childCard = createAndConnectCard(child, container);
-                childCard->setIndented(true);
-                if (showCounts)
-                    childCard->setCount(counts.value(child.id, 0));
-                layout->addWidget(childCard);
-                m_tagCards.append(childCard);
-            }
+        QScrollBar:vertical {
+            background: #2d2d2d;
+            width: 8px;
+            margin: 0;
+            border-radius: 4px;
         }
-    }
+        QScrollBar::handle:vertical {
+            background: #505050;
+            border-radius: 4px;
+            min-height: 20px;
+        }
+        QScrollBar::handle:vertical:hover {
+            background: #606060;
+        }
+        QScrollBar::add-line:vertical, QScrollBar::sub-line:vertical {
+            height: 0;
+        }
+    )");
+
+    connect(delegate, &TagCardDelegate::clicked, this, &TagSidebar::onTagCardClicked);
+    connect(delegate, &TagCardDelegate::hotkeyClicked, this, &TagSidebar::onHotkeyClicked);
+    connect(delegate, &TagCardDelegate::deleteRequested, this, &TagSidebar::onDeleteRequested);
+    connect(delegate, &TagCardDelegate::expandToggled, this, &TagSidebar::onExpandToggled);
+    connect(view, &QListView::customContextMenuRequested, this, [this, view](const QPoint& pos) {
+        showTagContextMenu(view, pos);
+    });
+    return view;
 }
 
-void TagSidebar::updateTagCards()
+void TagSidebar::showTagContextMenu(QListView* view, const QPoint& pos)
 {
-    // Clear all existing cards from both sections
-    for (TagCard* card : m_tagCards) {
-        card->deleteLater();
-    }
-    m_tagCards.clear();
-    
-    // Clear recent layout
-    while (m_recentLayout->count() > 0) {
-        QLayoutItem* item = m_recentLayout->takeAt(0);
-        delete item;
-    }
-    // Clear popular layout
-    while (m_popularLayout->count() > 0) {
-        QLayoutItem* item = m_popularLayout->takeAt(0);
-        delete item;
-    }
-    
-    if (!TagManager::instance()->isInitialized()) {
-        m_recentLayout->addStretch();
-        m_popularLayout->addStretch();
+    const QModelIndex index = view->indexAt(pos);
+    if (!index.isValid()) {
         return;
     }
-
-    QList<Tag> allTags = TagManager::instance()->allTags();
-    QHash<qint64, int> counts = TagManager::instance()->tagImageCounts(m_currentDirPaths);
-    QHash<qint64, QDateTime> lastUsed = TagManager::instance()->tagLastUsedTimes();
+    const qint64 tagId = index.data(TagSidebarModel::TagIdRole).toLongLong();
+    const bool isAlbumTag = index.data(TagSidebarModel::IsAlbumTagRole).toBool();
     
-    // Separate root tags from children
-    QList<Tag> rootTags;
-    QHash<qint64, QList<Tag>> childMap;
+    QMenu menu(this);
     
-    for (const Tag& tag : allTags) {
-        if (tag.parentId >= 0) {
-            childMap[tag.parentId].append(tag);
-        } else {
-            rootTags.append(tag);
-        }
-    }
+    QAction* renameAction = menu.addAction("Rename");
     
-    const QSet<qint64>& selected = m_selectedTags;
-
-    // --- Recent section: sort by most recently used, then by name ---
-    QList<Tag> recentRoots = rootTags;
-    auto recentSort = [&selected, &lastUsed](const Tag& a, const Tag& b) {
-        bool aSelected = selected.contains(a.id);
-        bool bSelected = selected.contains(b.id);
-        if (aSelected != bSelected) return aSelected;
-        QDateTime ta = lastUsed.value(a.id);
-        QDateTime tb = lastUsed.value(b.id);
-        if (ta.isValid() != tb.isValid()) return ta.isValid();
-        if (ta.isValid() && ta != tb) return ta > tb;
-        return a.name.toLower() < b.name.toLower();
-    };
-    std::sort(recentRoots.begin(), recentRoots.end(), recentSort);
+    QAction* supertagAction = menu.addAction("Toggle Supertag on Selection");
     
-    QHash<qint64, QList<Tag>> recentChildMap = childMap;
-    for (auto it = recentChildMap.begin(); it != recentChildMap.end(); ++it) {
-        std::sort(it.value().begin(), it.value().end(), recentSort);
+    menu.addSeparator();
+    
+    QAction* linkAction = nullptr;
+    QAction* unlinkAction = nullptr;
+    if (isAlbumTag) {
+        unlinkAction = menu.addAction("Unlink from Folder");
+    } else {
+        linkAction = menu.addAction("Link to Folder...");
     }
     
-    populateSection(m_recentLayout, recentRoots, recentChildMap);
-    m_recentLayout->addStretch();
-
-    // --- Popular section: sort by image count desc, then by name ---
-    QList<Tag> popularRoots = rootTags;
-    auto popularSort = [&selected, &counts](const Tag& a, const Tag& b) {
-        bool aSelected = selected.contains(a.id);
-        bool bSelected = selected.contains(b.id);
-        if (aSelected != bSelected) return aSelected;
-        int ca = counts.value(a.id, 0);
-        int cb = counts.value(b.id, 0);
-        if (ca != cb) return ca > cb;
-        return a.name.toLower() < b.name.toLower();
-    };
-    std::sort(popularRoots.begin(), popularRoots.end(), popularSort);
+    menu.addSeparator();
     
-    QHash<qint64, QList<Tag>> popularChildMap = childMap;
-    for (auto it = popularChildMap.begin(); it != popularChildMap.end(); ++it) {
-        std::sort(it.value().begin(), it.value().end(), popularSort);
-    }
+    QAction* deleteAction = menu.addAction("Delete");
     
-    populateSection(m_popularLayout, popularRoots, popularChildMap, counts);
-    m_popularLayout->addStretch();
-
-    // Re-apply search filter
-    filterTagCards(m_searchEdit->text());
+    QAction* chosen = menu.exec(view->viewport()->mapToGlobal(pos));
+    if (chosen == renameAction) {
+        onRenameRequested(tagId);
+    } else if (chosen == supertagAction) {
+        onSupertagToggleRequested(tagId);
+    } else if (chosen == deleteAction) {
+        onDeleteRequested(tagId);
+    } else if (linkAction && chosen == linkAction) {
+        onLinkToFolderRequested(tagId);
+    } else if (unlinkAction && chosen == unlinkAction) {
+        onUnlinkFromFolderRequested(tagId);
+    }
 }
 
 void TagSidebar::filterTagCards(const QString& text)
 {
-    QString filter = text.trimmed().toLower();
-    if (filter.isEmpty()) {
-        for (TagCard* card : m_tagCards) {
-            card->setVisible(true);
-        }
-        return;
-    }
-    
-    // Build set of IDs that directly match
-    QSet<qint64> matchIds;
-    for (TagCard* card : m_tagCards) {
-        if (card->tagName().toLower().contains(filter)) {
-            matchIds.insert(card->tagId());
-        }
-    }
-    
-    // Build set of parent IDs whose children match (show parent when child matches)
-    // and child IDs whose parent matches (show children when parent matches)
-    QSet<qint64> visibleIds = matchIds;
-    for (TagCard* card : m_tagCards) {
-        qint64 id = card->tagId();
-        if (matchIds.contains(id)) {
-            // If this is a group parent, show its children too
-            if (card->isGroupParent()) {
-                for (TagCard* other : m_tagCards) {
-                    if (other->isIndented()) {
-                        // Find child cards that come after this parent
-                        // They share the same parent in the tag manager
-                        Tag otherTag = TagManager::instance()->tag(other->tagId());
-                        if (otherTag.parentId == id) {
-                            visibleIds.insert(other->tagId());
-                        }
-                    }
-                }
-            }
-            // If this is a child, show its parent too
-            if (card->isIndented()) {
-                Tag t = TagManager::instance()->tag(id);
-                if (t.parentId >= 0) {
-                    visibleIds.insert(t.parentId);
-                }
-            }
-        }
-    }
-    
-    for (TagCard* card : m_tagCards) {
-        card->setVisible(visibleIds.contains(card->tagId()));
-    }
+    m_model->setFilterText(text);
 }
 
 void TagSidebar::onExpandToggled(qint64 tagId)
 {
-    if (m_expandedGroups.contains(tagId)) {
-        m_expandedGroups.remove(tagId);
-    } else {
-        m_expandedGroups.insert(tagId);
-    }
-    updateTagCards();
+    m_model->toggleExpanded(tagId);
 }
 
 void TagSidebar::onSupertagToggleRequested(qint64 tagId)
@@ -870,6 +677,7 @@ QSet<qint64> TagSidebar::selectedTagIds() const
 void TagSidebar::setSelectedImagePaths(const QStringList& paths)
 {
     m_selectedImagePaths = paths;
+    m_model->setSelection(paths);
     
     if (paths.isEmpty()) {
         m_selectionLabel->setText("No selection");
@@ -883,7 +691,7 @@ void TagSidebar::setSelectedImagePaths(const QStringList& paths)
 void TagSidebar::setCurrentDirectoryPaths(const QStringList& paths)
 {
     m_currentDirPaths = paths;
-    updateTagCards();
+    loadTags();
 }
 
 void TagSidebar::setTaggingModeActive(bool active)
@@ -917,7 +725,11 @@ bool TagSidebar::handleHotkey(const QString& key)
     }
     
     // Otherwise, try to toggle the tag with this hotkey
-    Tag tag = TagManager::instance()->tagByHotkey(key);
+    Tag tag;
+    {
+        HotkeyLatency::Scope lookup(HotkeyLatency::DbLookup);
+        tag = TagManager::instance()->tagByHotkey(key);
+    }
     if (tag.isValid()) {
         toggleTagOnSelection(tag.id);
         return true;
@@ -1001,21 +813,24 @@ void TagSidebar::onTagCardClicked(qint64 tagId)
     }
     
     // Toggle selection
-    if (m_selectedTags.contains(tagId)) {
-        m_selectedTags.remove(tagId);
-    } else {
+    const bool selected = !m_selectedTags.contains(tagId);
+    if (selected) {
         m_selectedTags.insert(tagId);
+    } else {
+        m_selectedTags.remove(tagId);
     }
     
-    // Re-sort so selected tags appear at top
-    updateTagCards();
+    // The sections move selected tags to the top themselves
+    m_model->setFilterSelected(tagId, selected);
     
     // Build expanded filter set: include children of any selected group parents
     QSet<qint64> expandedFilter = m_selectedTags;
     for (qint64 id : m_selectedTags) {
-        QList<Tag> children = TagManager::instance()->childTags(id);
-        for (const Tag& child : children) {
-            expandedFilter.insert(child.id);
+        const int row = m_model->rowForId(id);
+        if (row >= 0) {
+            for (qint64 childId : m_model->item(row).childIds) {
+                expandedFilter.insert(childId);
+            }
         }
     }
     
@@ -1029,12 +844,7 @@ void TagSidebar::onHotkeyClicked(qint64 tagId)
     
     // Set this tag as awaiting hotkey
     m_awaitingHotkeyTagId = tagId;
-    
-    for (TagCard* card : m_tagCards) {
-        if (card->tagId() == tagId) {
-            card->setAwaitingHotkey(true);
-        }
-    }
+    m_model->setAwaitingHotkey(tagId);
     
     m_statusLabel->setText("Press key (0-9, A-Z) or ESC");
     m_statusLabel->show();
@@ -1105,11 +915,7 @@ void TagSidebar::onUnlinkFromFolderRequested(qint64 tagId)
 void TagSidebar::clearAwaitingHotkey()
 {
     if (m_awaitingHotkeyTagId >= 0) {
-        for (TagCard* card : m_tagCards) {
-            if (card->tagId() == m_awaitingHotkeyTagId) {
-                card->setAwaitingHotkey(false);
-            }
-        }
+        m_model->setAwaitingHotkey(-1);
         m_awaitingHotkeyTagId = -1;
     }
     m_statusLabel->hide();
@@ -1185,23 +991,27 @@ void TagSidebar::toggleTagOnSelection(qint64 tagId)
         return;
     }
     
-    Tag tag = TagManager::instance()->tag(tagId);
-    if (!tag.isValid()) {
-        return;
-    }
+    HotkeyLatency::setImageCount(m_selectedImagePaths.size());
     
-    // Check if ALL selected images have this tag
-    bool allHaveTag = true;
-    for (const QString& path : m_selectedImagePaths) {
-        if (!TagManager::instance()->hasTag(path, tagId)) {
-            allHaveTag = false;
-            break;
+    Tag tag;
+    bool allHaveTag = false;
+    {
+        HotkeyLatency::Scope lookup(HotkeyLatency::DbLookup);
+        tag = TagManager::instance()->tag(tagId);
+        if (!tag.isValid()) {
+            return;
         }
+        
+        // Check if ALL selected images have this tag
+        allHaveTag = m_model->selectionHasTag(tagId);
     }
     
     if (allHaveTag) {
         // Remove tag from all selected images
-        TagManager::instance()->untagImages(m_selectedImagePaths, tagId);
+        {
+            HotkeyLatency::Scope write(HotkeyLatency::DbWrite);
+            TagManager::instance()->untagImages(m_selectedImagePaths, tagId);
+        }
         
         // Show feedback
         m_statusLabel->setStyleSheet(R"(
@@ -1217,7 +1027,10 @@ void TagSidebar::toggleTagOnSelection(qint64 tagId)
         Q_EMIT tagRemoved(tagId);
     } else {
         // Apply tag to all selected images
-        TagManager::instance()->tagImages(m_selectedImagePaths, tagId);
+        {
+            HotkeyLatency::Scope write(HotkeyLatency::DbWrite);
+            TagManager::instance()->tagImages(m_selectedImagePaths, tagId);
+        }
         
         // Show feedback
         m_statusLabel->setStyleSheet(R"(
@@ -2,93 +2,65 @@
  * TagSidebar - Modern sidebar for tag management with hotkey support
  * 
  * Features:
- * - Visual tag cards with hotkey badges
+ * - Visual tag cards with hotkey badges, in two virtualized lists (Recent
+ *   and Popular) that sort one shared TagSidebarModel
  * - Click-to-assign hotkeys (1-9, A-Z)
  * - Quick tag application via keyboard
  * - Filter images by tag
+ * - Cards mark tags applied to all or some of the selected images
  */
 
 #pragma once
 
 #include <QWidget>
 #include <QVBoxLayout>
-#include <QScrollArea>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QLabel>
 #include <QSet>
 #include <QKeyEvent>
+#include <QListView>
+#include <QStyledItemDelegate>
 
 namespace FullFrame {
 
-struct Tag;
+class TagSidebarModel;
+class TagSidebarProxyModel;
 
 /**
- * Individual tag card widget with hotkey support
+ * Paints one tag row of the sidebar (colour dot, name, count, hotkey
+ * badge, expand arrow) and turns clicks on its parts into signals
  */
-class TagCard : public QWidget
+class TagCardDelegate : public QStyledItemDelegate
 {
     Q_OBJECT
 
 public:
-    explicit TagCard(const Tag& tag, QWidget* parent = nullptr);
-    
-    qint64 tagId() const { return m_tagId; }
-    QString tagName() const { return m_name; }
-    QString hotkey() const { return m_hotkey; }
-    bool isAlbumTag() const { return m_isAlbumTag; }
-    
-    void setSelected(bool selected);
-    bool isSelected() const { return m_selected; }
-    
-    void setHotkey(const QString& hotkey);
-    void setAwaitingHotkey(bool awaiting);
-    void setAlbumTag(bool isAlbum);
-    
-    void setGroupParent(bool isGroup);
-    bool isGroupParent() const { return m_isGroupParent; }
-    void setExpanded(bool expanded);
-    bool isExpanded() const { return m_expanded; }
-    void setIndented(bool indented);
-    bool isIndented() const { return m_indented; }
-    
-    void setCount(int count);
-    int count() const { return m_count; }
+    static constexpr int RowHeight = 32;
+
+    explicit TagCardDelegate(bool showCounts, QObject* parent = nullptr);
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option,
+               const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    bool editorEvent(QEvent* event, QAbstractItemModel* model,
+                     const QStyleOptionViewItem& option, const QModelIndex& index) override;
 
 Q_SIGNALS:
     void clicked(qint64 tagId);
     void hotkeyClicked(qint64 tagId);
     void deleteRequested(qint64 tagId);
-    void renameRequested(qint64 tagId);
-    void linkToFolderRequested(qint64 tagId);
-    void unlinkFromFolderRequested(qint64 tagId);
     void expandToggled(qint64 tagId);
-    void supertagToggleRequested(qint64 tagId);
 
-protected:
-    void paintEvent(QPaintEvent* event) override;
-    void mousePressEvent(QMouseEvent* event) override;
-    void contextMenuEvent(QContextMenuEvent* event) override;
-    void enterEvent(QEnterEvent* event) override;
-    void leaveEvent(QEvent* event) override;
+private:
+    // Parts of a row, in the coordinates of option.rect
+    static QRect cardRect(const QRect& rowRect, bool indented);
+    static QRect expandRect(const QRect& card);
+    static QRect hotkeyRect(const QRect& card);
+    static QRect deleteRect(const QRect& card);
 
 private:
-    qint64 m_tagId;
-    QString m_name;
-    QString m_hotkey;
-    QColor m_color;
-    bool m_selected = false;
-    bool m_hovered = false;
-    bool m_awaitingHotkey = false;
-    bool m_isAlbumTag = false;
-    bool m_isGroupParent = false;
-    bool m_expanded = false;
-    bool m_indented = false;
-    int m_count = -1;
-    
-    QRect m_hotkeyRect;
-    QRect m_deleteRect;
-    QRect m_expandRect;
+    bool m_showCounts;
 };
 
 /**
@@ -149,28 +121,22 @@ private Q_SLOTS:
 private:
     void setupUI();
     void loadTags();
-    void updateTagCards();
-    void populateSection(QVBoxLayout* layout, const QList<Tag>& rootTags,
-                         const QHash<qint64, QList<Tag>>& childMap,
-                         const QHash<qint64, int>& counts = QHash<qint64, int>());
+    QListView* createSectionView(TagSidebarProxyModel* proxy, TagCardDelegate* delegate);
+    void showTagContextMenu(QListView* view, const QPoint& pos);
     void filterTagCards(const QString& text);
     void clearAwaitingHotkey();
     QColor generateTagColor() const;
     void applyTagToSelection(qint64 tagId);
     void removeTagFromSelection(qint64 tagId);
     void toggleTagOnSelection(qint64 tagId);
-    TagCard* createAndConnectCard(const Tag& tag, QWidget* parent);
 
 private:
-    // Recent section
-    QScrollArea* m_recentScrollArea;
-    QWidget* m_recentContainer;
-    QVBoxLayout* m_recentLayout;
-    
-    // Popular section
-    QScrollArea* m_popularScrollArea;
-    QWidget* m_popularContainer;
-    QVBoxLayout* m_popularLayout;
+    // Both sections are views over the same model
+    TagSidebarModel* m_model;
+    TagSidebarProxyModel* m_recentProxy;
+    TagSidebarProxyModel* m_popularProxy;
+    QListView* m_recentView;
+    QListView* m_popularView;
     
     QLineEdit* m_searchEdit;
     QLineEdit* m_newTagEdit;
@@ -182,9 +148,7 @@ private:
     QLabel* m_statusLabel;
     QLabel* m_selectionLabel;
     
-    QList<TagCard*> m_tagCards;
     QSet<qint64> m_selectedTags;
-    QSet<qint64> m_expandedGroups;
     QStringList m_selectedImagePaths;
     QStringList m_currentDirPaths;
     
@@ -0,0 +1,428 @@
+/**
+ * TiledImageView implementation
+ */
+
+#include "tiledimageview.h"
+#include "imagetileloader.h"
+#include "memoryreport.h"
+
+#include <QLineF>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace FullFrame {
+
+namespace {
+const QColor BackgroundColor(0x19, 0x19, 0x19);
+constexpr qreal MaxDeviceZoom = 4.0;   // 400% of the source pixels
+}
+
+TiledImageView::TiledImageView(QWidget* parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+
+    connect(ImageTileLoader::instance(), &ImageTileLoader::tileReady,
+            this, &TiledImageView::onTileReady);
+}
+
+void TiledImageView::setImage(const QString& filePath)
+{
+    m_filePath = filePath;
+    m_preview = QImage();
+    m_fittedPixmap = QPixmap();
+    m_sourceSize = QSize();
+    m_scale = 0.0;
+    m_visibleTiles.clear();
+    m_dragging = false;
+    ImageTileLoader::instance()->cancel();
+    ImageTileLoader::instance()->releaseLevels(filePath);
+    unsetCursor();
+    update();
+}
+
+void TiledImageView::setPreview(const QImage& image)
+{
+    m_preview = image;
+    m_fittedPixmap = QPixmap();
+    if (isZoomed()) {
+        updateTiles();
+    }
+    update();
+}
+
+void TiledImageView::clear()
+{
+    setImage(QString());
+}
+
+void TiledImageView::reportMemory(MemoryReport& report) const
+{
+    // m_preview usually shares its data with PreviewLoader's cache entry,
+    // which reports first and so is where that data is counted
+    report.add("Preview view image", report.imageBytes(m_preview) + report.pixmapBytes(m_fittedPixmap));
+}
+
+void TiledImageView::zoomToFit()
+{
+    m_scale = 0.0;
+    m_visibleTiles.clear();
+    ImageTileLoader::instance()->cancel();
+    unsetCursor();
+    update();
+}
+
+// ============== Geometry ==============
+
+bool TiledImageView::ensureSourceSize()
+{
+    if (m_sourceSize.isValid()) {
+        return true;
+    }
+    if (m_filePath.isEmpty() || m_preview.isNull()) {
+        return false;
+    }
+
+    // Header read only; happens once per image, on the first zoom gesture
+    ImageTileLoader::ImageInfo info = ImageTileLoader::instance()->imageInfo(m_filePath);
+    m_sourceSize = info.isValid() ? info.size : m_preview.size();
+    m_center = QPointF(m_sourceSize.width() / 2.0, m_sourceSize.height() / 2.0);
+    return true;
+}
+
+qreal TiledImageView::fitScale() const
+{
+    if (m_sourceSize.isEmpty() || width() <= 0 || height() <= 0) {
+        return 1.0;
+    }
+    return qMin(qreal(width()) / m_sourceSize.width(), qreal(height()) / m_sourceSize.height());
+}
+
+qreal TiledImageView::currentScale() const
+{
+    return isZoomed() ? m_scale : fitScale();
+}
+
+qreal TiledImageView::maxScale() const
+{
+    return qMax(fitScale() * 2.0, MaxDeviceZoom / devicePixelRatioF());
+}
+
+void TiledImageView::zoomAt(const QPointF& widgetPos, qreal scale)
+{
+    if (!ensureSourceSize()) {
+        return;
+    }
+
+    const QPointF widgetCenter(width() / 2.0, height() / 2.0);
+    const qreal oldScale = currentScale();
+    const QPointF anchor = (isZoomed() ? m_center
+                                       : QPointF(m_sourceSize.width() / 2.0, m_sourceSize.height() / 2.0))
+                           + (widgetPos - widgetCenter) / oldScale;
+
+    const qreal fit = fitScale();
+    scale = qMin(scale, maxScale());
+    if (scale <= fit * 1.001) {
+        zoomToFit();
+        return;
+    }
+
+    // Keep the source point under the cursor where it is
+    m_scale = scale;
+    m_center = anchor - (widgetPos - widgetCenter) / scale;
+    clampCenter();
+    setCursor(m_dragging ? Qt::ClosedHandCursor : Qt::OpenHandCursor);
+    updateTiles();
+    update();
+}
+
+void TiledImageView::clampCenter()
+{
+    const qreal scale = currentScale();
+    const qreal halfWidth = width() / 2.0 / scale;
+    const qreal halfHeight = height() / 2.0 / scale;
+
+    if (m_sourceSize.width() <= 2.0 * halfWidth) {
+        m_center.setX(m_sourceSize.width() / 2.0);
+    } else {
+        m_center.setX(qBound(halfWidth, m_center.x(), m_sourceSize.width() - halfWidth));
+    }
+    if (m_sourceSize.height() <= 2.0 * halfHeight) {
+        m_center.setY(m_sourceSize.height() / 2.0);
+    } else {
+        m_center.setY(qBound(halfHeight, m_center.y(), m_sourceSize.height() - halfHeight));
+    }
+}
+
+QRectF TiledImageView::imageRect() const
+{
+    const qreal scale = currentScale();
+    const QPointF widgetCenter(width() / 2.0, height() / 2.0);
+    return QRectF(widgetCenter - m_center * scale, QSizeF(m_sourceSize) * scale);
+}
+
+QRect TiledImageView::tileTargetRect(const QPoint& tile) const
+{
+    // Round tile edges, not tile sizes, so neighbours share an edge exactly
+    const QRectF image = imageRect();
+    const QSize levelSize = ImageTileLoader::levelSize(m_sourceSize, m_level);
+    const QRect levelRect = ImageTileLoader::tileRect(m_sourceSize, m_level, tile);
+    const qreal fx = image.width() / levelSize.width();
+    const qreal fy = image.height() / levelSize.height();
+
+    const int left = qRound(image.left() + levelRect.left() * fx);
+    const int top = qRound(image.top() + levelRect.top() * fy);
+    const int right = qRound(image.left() + (levelRect.left() + levelRect.width()) * fx);
+    const int bottom = qRound(image.top() + (levelRect.top() + levelRect.height()) * fy);
+    return QRect(left, top, right - left, bottom - top);
+}
+
+// ============== Tiles ==============
+
+bool TiledImageView::needsTiles() const
+{
+    if (!isZoomed() || m_preview.isNull() || m_sourceSize.isEmpty()) {
+        return false;
+    }
+    // Past the preview's own resolution only tiles add detail
+    const qreal deviceWidth = m_sourceSize.width() * m_scale * devicePixelRatioF();
+    return m_preview.width() < deviceWidth * 0.95 && m_preview.width() < m_sourceSize.width();
+}
+
+void TiledImageView::updateTiles()
+{
+    if (!needsTiles()) {
+        if (!m_visibleTiles.isEmpty()) {
+            m_visibleTiles.clear();
+            ImageTileLoader::instance()->cancel();
+        }
+        return;
+    }
+
+    m_level = ImageTileLoader::levelForScale(m_scale * devicePixelRatioF());
+    const QSize levelSize = ImageTileLoader::levelSize(m_sourceSize, m_level);
+
+    // Visible part of the image, in level pixels
+    const QRectF image = imageRect();
+    const QRectF visible = image & QRectF(rect());
+    if (visible.isEmpty()) {
+        m_visibleTiles.clear();
+        ImageTileLoader::instance()->cancel();
+        return;
+    }
+    const qreal toLevelX = levelSize.width() / image.width();
+    const qreal toLevelY = levelSize.height() / image.height();
+    const int T = ImageTileLoader::TileSize;
+    const int firstCol = qMax(0, int((visible.left() - image.left()) * toLevelX) / T);
+    const int lastCol = qMin((levelSize.width() - 1) / T, int((visible.right() - image.left()) * toLevelX) / T);
+    const int firstRow = qMax(0, int((visible.top() - image.top()) * toLevelY) / T);
+    const int lastRow = qMin((levelSize.height() - 1) / T, int((visible.bottom() - image.top()) * toLevelY) / T);
+
+    m_visibleTiles.clear();
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int col = firstCol; col <= lastCol; ++col) {
+            m_visibleTiles.append(QPoint(col, row));
+        }
+    }
+
+    // Centre of the view first
+    const QPointF centerTile((firstCol + lastCol) / 2.0, (firstRow + lastRow) / 2.0);
+    std::sort(m_visibleTiles.begin(), m_visibleTiles.end(), [&centerTile](const QPoint& a, const QPoint& b) {
+        return QLineF(a, centerTile).length() < QLineF(b, centerTile).length();
+    });
+
+    ImageTileLoader::instance()->request(m_filePath, m_level, m_visibleTiles);
+}
+
+void TiledImageView::onTileReady(const QString& filePath, int level, const QPoint& tile)
+{
+    if (filePath == m_filePath && level == m_level && m_visibleTiles.contains(tile)) {
+        update(tileTargetRect(tile));
+    }
+}
+
+// ============== Painting ==============
+
+void TiledImageView::paintEvent(QPaintEvent* event)
+{
+    QPainter painter(this);
+    painter.fillRect(event->rect(), BackgroundColor);
+
+    if (m_preview.isNull()) {
+        return;
+    }
+
+    if (isZoomed()) {
+        paintZoomed(painter, event->rect());
+    } else {
+        paintFitted(painter);
+    }
+}
+
+void TiledImageView::paintFitted(QPainter& painter)
+{
+    const qreal dpr = devicePixelRatioF();
+    const QSize target = m_preview.size().scaled(size() * dpr, Qt::KeepAspectRatio);
+    if (target.isEmpty()) {
+        return;
+    }
+
+    // The preview was decoded for this size, so this normally only scales
+    // after a resize or when a larger cached preview was reused
+    if (m_fittedPixmap.isNull() || m_fittedPixmap.size() != target) {
+        if (target == m_preview.size()) {
+            m_fittedPixmap = QPixmap::fromImage(m_preview);
+        } else {
+            m_fittedPixmap = QPixmap::fromImage(
+                m_preview.scaled(target, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+        }
+        m_fittedPixmap.setDevicePixelRatio(dpr);
+    }
+
+    const QSizeF logical = QSizeF(target) / dpr;
+    painter.drawPixmap(QPointF((width() - logical.width()) / 2.0, (height() - logical.height()) / 2.0),
+                       m_fittedPixmap);
+}
+
+void TiledImageView::paintZoomed(QPainter& painter, const QRect& dirtyRect)
+{
+    const QRectF image = imageRect();
+    const qreal previewX = m_preview.width() / image.width();
+    const qreal previewY = m_preview.height() / image.height();
+
+    // Upscaled preview for an area of the view (the stand-in for missing tiles)
+    auto drawPreview = [&](const QRectF& target) {
+        const QRectF area = target & image;
+        if (area.isEmpty()) {
+            return;
+        }
+        const QRectF source((area.left() - image.left()) * previewX, (area.top() - image.top()) * previewY,
+                            area.width() * previewX, area.height() * previewY);
+        painter.drawImage(area, m_preview, source);
+    };
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    if (m_visibleTiles.isEmpty()) {
+        drawPreview(QRectF(dirtyRect));
+    } else {
+        for (const QPoint& tile : m_visibleTiles) {
+            const QRect target = tileTargetRect(tile);
+            if (!target.intersects(dirtyRect)) {
+                continue;
+            }
+            QPixmap pixmap;
+            if (ImageTileLoader::instance()->find(m_filePath, m_level, tile, pixmap)) {
+                painter.drawPixmap(target, pixmap);
+            } else {
+                drawPreview(target);
+            }
+        }
+    }
+
+    // Zoom readout; 100% is one source pixel per device pixel
+    const QString zoomText = QString("%1%").arg(qRound(m_scale * devicePixelRatioF() * 100));
+    QFont font = painter.font();
+    font.setPointSize(9);
+    painter.setFont(font);
+    const QRect textRect = painter.fontMetrics().boundingRect(zoomText).adjusted(-8, -3, 8, 3);
+    const QRect pill = textRect.translated(width() - textRect.width() - 12 - textRect.left(),
+                                           height() - textRect.height() - 12 - textRect.top());
+    if (pill.intersects(dirtyRect)) {
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QColor(0, 0, 0, 160));
+        painter.drawRoundedRect(pill, pill.height() / 2.0, pill.height() / 2.0);
+        painter.setPen(QColor(220, 220, 220));
+        painter.drawText(pill, Qt::AlignCenter, zoomText);
+    }
+}
+
+// ============== Events ==============
+
+void TiledImageView::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    m_fittedPixmap = QPixmap();
+
+    if (isZoomed()) {
+        if (m_scale <= fitScale()) {
+            zoomToFit();
+        } else {
+            clampCenter();
+            updateTiles();
+        }
+    }
+}
+
+void TiledImageView::wheelEvent(QWheelEvent* event)
+{
+    const int delta = event->angleDelta().y();
+    if (delta == 0 || m_preview.isNull() || !ensureSourceSize()) {
+        event->ignore();
+        return;
+    }
+    // One notch (120) zooms by 2^(1/4)
+    zoomAt(event->position(), currentScale() * std::pow(2.0, delta / 480.0));
+    event->accept();
+}
+
+void TiledImageView::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() == Qt::LeftButton && isZoomed()) {
+        m_dragging = true;
+        m_lastDragPos = event->position();
+        setCursor(Qt::ClosedHandCursor);
+        event->accept();
+        return;
+    }
+    QWidget::mousePressEvent(event);
+}
+
+void TiledImageView::mouseMoveEvent(QMouseEvent* event)
+{
+    if (!m_dragging) {
+        QWidget::mouseMoveEvent(event);
+        return;
+    }
+    const QPointF delta = event->position() - m_lastDragPos;
+    m_lastDragPos = event->position();
+    m_center -= delta / m_scale;
+    clampCenter();
+    updateTiles();
+    update();
+}
+
+void TiledImageView::mouseReleaseEvent(QMouseEvent* event)
+{
+    if (m_dragging && event->button() == Qt::LeftButton) {
+        m_dragging = false;
+        if (isZoomed()) {
+            setCursor(Qt::OpenHandCursor);
+        }
+        return;
+    }
+    QWidget::mouseReleaseEvent(event);
+}
+
+void TiledImageView::mouseDoubleClickEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton || m_preview.isNull()) {
+        QWidget::mouseDoubleClickEvent(event);
+        return;
+    }
+    if (isZoomed()) {
+        zoomToFit();
+    } else if (ensureSourceSize()) {
+        // 1:1 device pixels, or 2x fit for images already shown larger
+        zoomAt(event->position(), qMax(1.0 / devicePixelRatioF(), fitScale() * 2.0));
+    }
+}
+
+} // namespace FullFrame
@@ -0,0 +1,88 @@
+/**
+ * TiledImageView - Zoomable, pannable still-image view
+ *
+ * Shows the fit-to-window preview from PreviewLoader and, once the user
+ * zooms past it, overlays ImageTileLoader tiles of the pyramid level that
+ * matches the zoom. Only tiles in view are requested; until they arrive
+ * the upscaled preview stands in for them.
+ *
+ * Wheel zooms around the cursor, double-click toggles fit / 1:1, and a
+ * left-button drag pans while zoomed.
+ */
+
+#pragma once
+
+#include <QWidget>
+#include <QImage>
+#include <QPixmap>
+#include <QPointF>
+#include <QVector>
+
+namespace FullFrame {
+
+class MemoryReport;
+
+class TiledImageView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TiledImageView(QWidget* parent = nullptr);
+
+    // Switch to filePath at fit zoom; the preview follows via setPreview()
+    void setImage(const QString& filePath);
+    void setPreview(const QImage& image);
+    void clear();
+
+    QString filePath() const { return m_filePath; }
+    bool isZoomed() const { return m_scale > 0.0; }
+
+    void zoomToFit();
+
+    // The preview and its fitted pixmap; tiles are counted by ImageTileLoader
+    void reportMemory(MemoryReport& report) const;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+
+private Q_SLOTS:
+    void onTileReady(const QString& filePath, int level, const QPoint& tile);
+
+private:
+    bool ensureSourceSize();
+    qreal fitScale() const;
+    qreal currentScale() const;
+    qreal maxScale() const;
+    void zoomAt(const QPointF& widgetPos, qreal scale);
+    void clampCenter();
+    QRectF imageRect() const;                       // Whole image, widget coords
+    QRect tileTargetRect(const QPoint& tile) const; // Pixel-snapped, no seams
+    bool needsTiles() const;
+    void updateTiles();
+    void paintFitted(QPainter& painter);
+    void paintZoomed(QPainter& painter, const QRect& dirtyRect);
+
+private:
+    QString m_filePath;
+    QImage m_preview;
+    QPixmap m_fittedPixmap;   // m_preview scaled to the widget, for fit mode
+
+    QSize m_sourceSize;       // Read from the file header on first zoom
+    qreal m_scale = 0.0;      // Logical px per source px; 0 = fit to window
+    QPointF m_center;         // Source point shown at the widget centre
+
+    // Pyramid level and tiles of the current view
+    int m_level = 0;
+    QVector<QPoint> m_visibleTiles;
+
+    bool m_dragging = false;
+    QPointF m_lastDragPos;
+};
+
+} // namespace FullFrame